@@ -0,0 +1,320 @@
+// Banc d'essai de réactivité de l'interface, en rendu hors écran : les
+// onglets Commandes, Livreurs et Statistiques sont construits puis
+// rechargés sur des bases SQLite générées de tailles croissantes.
+//
+// Chaque action est lancée depuis la boucle d'événements ; une pulsation de
+// quelques millisecondes y mesure les blocages (écart entre deux pulsations
+// au-delà du seuil). Mesures par action : délai jusqu'au premier rendu d'une
+// ligne, durée totale jusqu'à la boucle de nouveau libre, blocages et pic de
+// mémoire résidente du processus. Résultat en JSON.
+//
+//   BancInterface [--tailles 1000,10000,100000] [--livreurs 200] [--iterations 3]
+//                 [--graine 42] [--seuil-blocage 50] [--sortie resultats.json]
+
+#include "db/DatabaseManager.h"
+#include "db/GenerateurDonnees.h"
+#include "services/IndexFiltres.h"
+#include "utils/MemoireProcessus.h"
+#include "CommandeWidget.h"
+#include "LivreurWidget.h"
+#include "StatistiquesWidget.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTableWidget>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// Une exécution d'action, vue depuis la boucle d'événements
+struct Mesure
+{
+    double premiereLigneMs = -1.0;   // -1 : aucune ligne rendue
+    double appelMs = 0.0;            // durée de l'appel synchrone
+    double totalMs = 0.0;            // jusqu'à la boucle de nouveau libre
+    QList<double> blocagesMs;
+};
+
+// Cible observée : widget dont on attend le premier rendu, et condition
+// (ex. au moins une ligne dans le tableau) pour que ce rendu compte
+struct Cible
+{
+    QWidget* widget = nullptr;
+    std::function<bool()> pret;
+};
+
+class ObservateurRendu : public QObject
+{
+public:
+    ObservateurRendu(const QElapsedTimer& chrono, Mesure& mesure)
+        : chrono(chrono), mesure(mesure) {}
+
+    Cible cible;
+
+protected:
+    bool eventFilter(QObject* objet, QEvent* evenement) override
+    {
+        if (evenement->type() == QEvent::Paint && mesure.premiereLigneMs < 0 &&
+            (!cible.pret || cible.pret())) {
+            mesure.premiereLigneMs = chrono.nsecsElapsed() / 1e6;
+        }
+        return QObject::eventFilter(objet, evenement);
+    }
+
+private:
+    const QElapsedTimer& chrono;
+    Mesure& mesure;
+};
+
+Mesure executer(double seuilBlocageMs, const std::function<Cible()>& action)
+{
+    Mesure mesure;
+    QElapsedTimer chrono;
+    ObservateurRendu observateur(chrono, mesure);
+
+    // Pulsation : un écart anormal entre deux passages est un blocage
+    QElapsedTimer pulsation;
+    QTimer minuterie;
+    minuterie.setTimerType(Qt::PreciseTimer);
+    minuterie.setInterval(5);
+    QObject::connect(&minuterie, &QTimer::timeout, [&] {
+        const double ecart = pulsation.nsecsElapsed() / 1e6;
+        if (ecart > seuilBlocageMs) {
+            mesure.blocagesMs << ecart;
+        }
+        pulsation.restart();
+    });
+
+    QEventLoop boucle;
+    QTimer::singleShot(0, &boucle, [&] {
+        chrono.start();
+        observateur.cible = action();
+        mesure.appelMs = chrono.nsecsElapsed() / 1e6;
+        if (observateur.cible.widget) {
+            observateur.cible.widget->installEventFilter(&observateur);
+            observateur.cible.widget->update();
+        }
+
+        // Les événements postés (mise en page, rendu) passent avant ce minuteur
+        QTimer::singleShot(0, &boucle, [&] {
+            mesure.totalMs = chrono.nsecsElapsed() / 1e6;
+            boucle.quit();
+        });
+    });
+
+    pulsation.start();
+    minuterie.start();
+    boucle.exec();
+    minuterie.stop();
+
+    // Dernier écart : blocage éventuel de la fin de l'action
+    const double ecart = pulsation.nsecsElapsed() / 1e6;
+    if (ecart > seuilBlocageMs) {
+        mesure.blocagesMs << ecart;
+    }
+    if (observateur.cible.widget) {
+        observateur.cible.widget->removeEventFilter(&observateur);
+    }
+    return mesure;
+}
+
+double mediane(std::vector<double> valeurs)
+{
+    if (valeurs.empty()) {
+        return -1.0;
+    }
+    std::sort(valeurs.begin(), valeurs.end());
+    return valeurs[valeurs.size() / 2];
+}
+
+QJsonObject resumer(const QString& nom, int taille, const QList<Mesure>& mesures)
+{
+    std::vector<double> premieres, appels, totaux;
+    double blocageMax = 0.0, blocageTotal = 0.0;
+    int blocages = 0;
+    for (const Mesure& mesure : mesures) {
+        if (mesure.premiereLigneMs >= 0) {
+            premieres.push_back(mesure.premiereLigneMs);
+        }
+        appels.push_back(mesure.appelMs);
+        totaux.push_back(mesure.totalMs);
+        for (double blocage : mesure.blocagesMs) {
+            blocageMax = std::max(blocageMax, blocage);
+            blocageTotal += blocage;
+            ++blocages;
+        }
+    }
+
+    QJsonObject resultat;
+    resultat["nom"] = nom;
+    resultat["commandes"] = taille;
+    resultat["iterations"] = mesures.size();
+    resultat["premiere_ligne_ms"] = premieres.empty() ? QJsonValue() : QJsonValue(mediane(premieres));
+    resultat["appel_ms"] = mediane(appels);
+    resultat["total_ms"] = mediane(totaux);
+    resultat["total_max_ms"] = *std::max_element(totaux.begin(), totaux.end());
+    resultat["blocages"] = blocages;
+    resultat["blocage_max_ms"] = blocageMax;
+    resultat["blocage_total_ms"] = blocageTotal;
+    resultat["pic_memoire_ko"] = MemoireProcessus::picKo();
+
+    qInfo().noquote() << QString("%1 %2 commandes : %3 ms (médiane), blocage max %4 ms")
+                             .arg(nom, -32).arg(taille, 8)
+                             .arg(mediane(totaux), 0, 'f', 1).arg(blocageMax, 0, 'f', 1);
+    return resultat;
+}
+
+// Tableau d'un onglet : premier rendu retenu dès qu'une ligne existe
+Cible cibleTableau(QWidget* onglet)
+{
+    QTableWidget* tableau = onglet->findChild<QTableWidget*>();
+    if (!tableau) {
+        return Cible{onglet, {}};
+    }
+    return Cible{tableau->viewport(), [tableau] { return tableau->rowCount() > 0; }};
+}
+
+template <typename Onglet>
+Onglet* creerOnglet()
+{
+    Onglet* onglet = new Onglet();
+    onglet->resize(1280, 800);
+    onglet->show();
+    return onglet;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("tailles", "Nombres de commandes, séparés par des virgules",
+                                        "liste", "1000,10000,100000"));
+    parser.addOption(QCommandLineOption("livreurs", "Nombre de livreurs", "n", "200"));
+    parser.addOption(QCommandLineOption("iterations", "Répétitions par mesure", "n", "3"));
+    parser.addOption(QCommandLineOption("graine", "Graine du générateur de données", "n", "42"));
+    parser.addOption(QCommandLineOption("seuil-blocage", "Seuil de blocage de la boucle (ms)", "ms", "50"));
+    parser.addOption(QCommandLineOption("sortie", "Fichier JSON des résultats (stdout par défaut)", "chemin"));
+    parser.process(app);
+
+    QList<int> tailles;
+    for (const QString& taille : parser.value("tailles").split(',', Qt::SkipEmptyParts)) {
+        tailles << taille.trimmed().toInt();
+    }
+    const int nombreLivreurs = std::max(1, parser.value("livreurs").toInt());
+    const int iterations = std::max(1, parser.value("iterations").toInt());
+    const double seuilBlocage = parser.value("seuil-blocage").toDouble();
+
+    QTemporaryDir repertoire;
+    DatabaseManager* db = DatabaseManager::getInstance();
+    IndexFiltres* index = IndexFiltres::getInstance();
+    QJsonArray resultats;
+
+    for (int taille : tailles) {
+        // Base neuve par taille : les mesures ne dépendent pas de l'ordre
+        if (!db->connectToSqlite(repertoire.filePath(QString("interface-%1.sqlite").arg(taille)))) {
+            return 1;
+        }
+        index->invalider();
+
+        ParametresGeneration parametres;
+        parametres.livreurs = nombreLivreurs;
+        parametres.commandes = taille;
+        parametres.graine = parser.value("graine").toUInt();
+        if (!GenerateurDonnees(parametres).generer().succes) {
+            qCritical() << "Échec du remplissage de la base" << taille;
+            return 1;
+        }
+
+        // Construction à froid (index à recharger), comme au démarrage
+        auto construire = [&](const QString& nom, auto creer) {
+            QList<Mesure> mesures;
+            for (int i = 0; i < iterations; ++i) {
+                index->invalider();
+                QWidget* onglet = nullptr;
+                mesures << executer(seuilBlocage, [&] {
+                    onglet = creer();
+                    return cibleTableau(onglet);
+                });
+                delete onglet;
+            }
+            resultats << resumer(nom, taille, mesures);
+        };
+
+        // Rechargement d'un onglet déjà ouvert (bouton Actualiser)
+        auto recharger = [&](const QString& nom, QWidget* onglet, const std::function<void()>& action) {
+            QList<Mesure> mesures;
+            for (int i = 0; i < iterations; ++i) {
+                mesures << executer(seuilBlocage, [&] {
+                    action();
+                    return cibleTableau(onglet);
+                });
+            }
+            resultats << resumer(nom, taille, mesures);
+        };
+
+        construire("CommandeWidget::construction", [] { return creerOnglet<CommandeWidget>(); });
+        construire("LivreurWidget::construction", [] { return creerOnglet<LivreurWidget>(); });
+        construire("StatistiquesWidget::construction", [] { return creerOnglet<StatistiquesWidget>(); });
+
+        CommandeWidget* commandes = creerOnglet<CommandeWidget>();
+        recharger("CommandeWidget::chargerCommandes", commandes, [commandes] { commandes->actualiserListe(); });
+        delete commandes;
+
+        LivreurWidget* livreurs = creerOnglet<LivreurWidget>();
+        recharger("LivreurWidget::chargerLivreurs", livreurs, [livreurs] { livreurs->actualiserListe(); });
+        delete livreurs;
+
+        StatistiquesWidget* statistiques = creerOnglet<StatistiquesWidget>();
+        recharger("StatistiquesWidget::actualiserStatistiques", statistiques,
+                  [statistiques] { statistiques->actualiserStatistiques(); });
+        delete statistiques;
+    }
+
+    QJsonObject contexte;
+    contexte["tailles"] = QJsonArray::fromVariantList(QVariantList(tailles.begin(), tailles.end()));
+    contexte["livreurs"] = nombreLivreurs;
+    contexte["iterations"] = iterations;
+    contexte["seuil_blocage_ms"] = seuilBlocage;
+    contexte["plateforme"] = QApplication::platformName();
+    contexte["pilote"] = "QSQLITE";
+    contexte["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    contexte["qt"] = QString(qVersion());
+
+    QJsonObject document;
+    document["contexte"] = contexte;
+    document["resultats"] = resultats;
+    const QByteArray json = QJsonDocument(document).toJson();
+
+    if (parser.isSet("sortie")) {
+        QFile fichier(parser.value("sortie"));
+        if (!fichier.open(QIODevice::WriteOnly)) {
+            qCritical() << "Impossible d'écrire" << fichier.fileName();
+            return 1;
+        }
+        fichier.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    db->disconnectFromDatabase();
+    return 0;
+}
@@ -0,0 +1,347 @@
+// Banc d'essai de la couche services sur une base SQLite locale remplie à
+// la volée. Chaque mesure est répétée et résumée (min, médiane, moyenne,
+// max) ; le résultat est écrit en JSON pour le suivi des régressions.
+//
+//   BancServices [--commandes 10000] [--livreurs 100] [--iterations 5]
+//                [--graine 42] [--asymetrie 1.0]
+//                [--base chemin.sqlite] [--sortie resultats.json] [--sans-rapport]
+
+#include "db/DatabaseManager.h"
+#include "db/GenerateurDonnees.h"
+#include "services/CommandeService.h"
+#include "services/LivreurService.h"
+#include "services/IndexFiltres.h"
+#include "services/StatistiquesLivraison.h"
+#include "services/RepartitionService.h"
+#include "services/JournalEvenements.h"
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QSet>
+#include <QSqlQuery>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace {
+
+QJsonObject mesurer(const QString& nom, int iterations, const std::function<void()>& operation)
+{
+    std::vector<double> durees;
+    QElapsedTimer chrono;
+    for (int i = 0; i < iterations; ++i) {
+        chrono.start();
+        operation();
+        durees.push_back(chrono.nsecsElapsed() / 1e6);
+    }
+    std::sort(durees.begin(), durees.end());
+
+    double somme = 0.0;
+    for (double duree : durees) {
+        somme += duree;
+    }
+
+    QJsonObject resultat;
+    resultat["nom"] = nom;
+    resultat["iterations"] = iterations;
+    resultat["min_ms"] = durees.front();
+    resultat["mediane_ms"] = durees[durees.size() / 2];
+    resultat["moyenne_ms"] = somme / durees.size();
+    resultat["max_ms"] = durees.back();
+
+    qInfo().noquote() << QString("%1 %2 ms (médiane)").arg(nom, -40).arg(durees[durees.size() / 2], 0, 'f', 2);
+    return resultat;
+}
+
+// Réponse de référence, lue en SQL sans passer par l'index ; instr() garde
+// la sensibilité à la casse du LIKE Oracle (LIKE SQLite ne l'a pas)
+QSet<int> commandesSql(const QString& statut, const QString& ville, const QDate& debut, const QDate& fin)
+{
+    QString query = "SELECT id_commande FROM COMMANDES WHERE 1=1";
+    QVariantList values;
+    if (!statut.isEmpty()) {
+        query += " AND statut = ?";
+        values << statut;
+    }
+    if (!ville.isEmpty()) {
+        query += " AND instr(ville_livraison, ?) > 0";
+        values << ville;
+    }
+    if (debut.isValid()) {
+        query += " AND date_commande >= ?";
+        values << debut;
+    }
+    if (fin.isValid()) {
+        query += " AND date_commande <= ?";
+        values << fin;
+    }
+
+    QSet<int> ids;
+    QSqlQuery result = DatabaseManager::getInstance()->executePreparedQuery(query, values);
+    while (result.next()) {
+        ids.insert(result.value(0).toInt());
+    }
+    return ids;
+}
+
+// Délais exacts (en jours) des commandes livrées, même calcul et même
+// exclusion des délais négatifs que StatistiquesLivraison, triés ; ville
+// vide : toutes
+std::vector<double> delaisSql(const QString& ville)
+{
+    QString query = "SELECT date_commande, delivered_at FROM COMMANDES "
+                    "WHERE statut = 'Livree' AND delivered_at IS NOT NULL";
+    QVariantList values;
+    if (!ville.isEmpty()) {
+        query += " AND ville_livraison = ?";
+        values << ville;
+    }
+
+    std::vector<double> delais;
+    QSqlQuery result = DatabaseManager::getInstance()->executePreparedQuery(query, values);
+    while (result.next()) {
+        const QDate date = result.value(0).toDate();
+        const QDateTime livraison = result.value(1).toDateTime();
+        const double delai = date.isValid() && livraison.isValid()
+                                 ? date.startOfDay().secsTo(livraison) / 86400.0 : -1.0;
+        if (delai >= 0.0) {
+            delais.push_back(delai);
+        }
+    }
+    std::sort(delais.begin(), delais.end());
+    return delais;
+}
+
+// Centile estimé acceptable si son rang parmi les délais exacts est à moins
+// d'un point du rang demandé (erreur d'un t-digest sur ces volumes)
+bool rangCompatible(const std::vector<double>& delais, double estimation, double quantile)
+{
+    const double n = delais.size();
+    const double dessous = std::lower_bound(delais.begin(), delais.end(), estimation) - delais.begin();
+    const double jusqua = std::upper_bound(delais.begin(), delais.end(), estimation) - delais.begin();
+    return dessous / n <= quantile + 0.01 && jusqua / n >= quantile - 0.01;
+}
+
+QString ecartDelais(const QString& portee, const MesuresDelai& mesures, const std::vector<double>& delais)
+{
+    if (mesures.nombre != int(delais.size())) {
+        return QString("%1: %2 livraisons, %3 en SQL").arg(portee).arg(mesures.nombre).arg(delais.size());
+    }
+    if (delais.empty()) {
+        return QString();
+    }
+    double somme = 0.0;
+    for (double delai : delais) {
+        somme += delai;
+    }
+    if (std::abs(mesures.moyenne - somme / delais.size()) > 1e-6) {
+        return QString("%1: moyenne %2, %3 en SQL").arg(portee).arg(mesures.moyenne).arg(somme / delais.size());
+    }
+    const QList<QPair<double, double>> centiles = {{0.50, mesures.p50}, {0.90, mesures.p90}, {0.99, mesures.p99}};
+    for (const auto& [quantile, estimation] : centiles) {
+        if (!rangCompatible(delais, estimation, quantile)) {
+            return QString("%1: centile %2 estimé à %3 jours").arg(portee).arg(quantile).arg(estimation);
+        }
+    }
+    return QString();
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    // Rapport PDF sans serveur d'affichage
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("commandes", "Nombre de commandes", "n", "10000"));
+    parser.addOption(QCommandLineOption("livreurs", "Nombre de livreurs", "n", "100"));
+    parser.addOption(QCommandLineOption("iterations", "Répétitions par mesure", "n", "5"));
+    parser.addOption(QCommandLineOption("graine", "Graine du générateur de données", "n", "42"));
+    parser.addOption(QCommandLineOption("asymetrie", "Exposant de Zipf des villes (0 : uniforme)", "s", "1.0"));
+    parser.addOption(QCommandLineOption("base", "Fichier SQLite (temporaire par défaut)", "chemin"));
+    parser.addOption(QCommandLineOption("sortie", "Fichier JSON des résultats (stdout par défaut)", "chemin"));
+    parser.addOption(QCommandLineOption("sans-rapport", "Ne pas mesurer la génération du rapport PDF"));
+    parser.process(app);
+
+    const int nombreCommandes = parser.value("commandes").toInt();
+    const int nombreLivreurs = std::max(1, parser.value("livreurs").toInt());
+    const int iterations = std::max(1, parser.value("iterations").toInt());
+
+    QTemporaryDir repertoire;
+    const QString cheminBase = parser.isSet("base") ? parser.value("base")
+                                                    : repertoire.filePath("banc.sqlite");
+
+    DatabaseManager* db = DatabaseManager::getInstance();
+    if (!db->connectToSqlite(cheminBase)) {
+        return 1;
+    }
+
+    ParametresGeneration parametres;
+    parametres.livreurs = nombreLivreurs;
+    parametres.commandes = nombreCommandes;
+    parametres.graine = parser.value("graine").toUInt();
+    parametres.asymetrieVilles = parser.value("asymetrie").toDouble();
+
+    const RapportGeneration remplissage = GenerateurDonnees(parametres).generer();
+    if (!remplissage.succes) {
+        qCritical() << "Échec du remplissage de la base";
+        return 1;
+    }
+
+    CommandeService commandeService;
+    LivreurService livreurService;
+    IndexFiltres* index = IndexFiltres::getInstance();
+    QJsonArray resultats;
+
+    resultats << mesurer("obtenirToutesCommandes", iterations, [&] {
+        commandeService.obtenirToutesCommandes();
+    });
+
+    resultats << mesurer("chargementIndex", iterations, [&] {
+        index->invalider();
+        index->assurerChargement();
+    });
+
+    resultats << mesurer("rechercherCommandes", iterations, [&] {
+        commandeService.rechercherCommandes("En attente", "Sfax");
+        commandeService.rechercherCommandes("", "", parametres.fin.addDays(-30), parametres.fin);
+    });
+
+    resultats << mesurer("obtenirMeilleurLivreur", iterations, [&] {
+        for (const QString& ville : parametres.villes) {
+            livreurService.obtenirMeilleurLivreur(ville);
+        }
+    });
+
+    resultats << mesurer("obtenirLivreursSurcharges", iterations, [&] {
+        livreurService.obtenirLivreursSurcharges();
+    });
+
+    resultats << mesurer("statistiquesAgregees", iterations, [&] {
+        commandeService.obtenirStatistiquesParStatut();
+        commandeService.obtenirStatistiquesParVille();
+        commandeService.obtenirStatistiquesParDate();
+        livreurService.obtenirStatistiquesParZone();
+        livreurService.obtenirStatistiquesChargesDeTravail();
+    });
+
+    resultats << mesurer("statistiquesDelais", iterations, [&] {
+        StatistiquesLivraison::getInstance()->reconstruire();
+    });
+
+    if (!parser.isSet("sans-rapport")) {
+        const QString cheminRapport = repertoire.filePath("rapport.pdf");
+        resultats << mesurer("genererRapportCommandes", iterations, [&] {
+            commandeService.genererRapportCommandes(cheminRapport);
+        });
+    }
+
+    // Vérification des réponses servies par l'index et les t-digests contre
+    // la base, sur les données générées
+    if (!index->assurerChargement()) {
+        qCritical() << "Index indisponible pour la vérification";
+        return 1;
+    }
+    struct Filtre
+    {
+        QString statut;
+        QString ville;
+        QDate debut;
+        QDate fin;
+    };
+    const QList<Filtre> filtres = {
+        {"En attente", "Sfax", QDate(), QDate()},
+        {"Livree", QString(), parametres.debut, parametres.fin.addDays(-7)},
+        {QString(), QString(), parametres.fin.addDays(-30), parametres.fin},
+        {QString(), "sfax", QDate(), QDate()},
+        {"En cours", "Tunis", parametres.debut.addDays(10), QDate()}
+    };
+    for (const Filtre& filtre : filtres) {
+        QSet<int> idsIndex;
+        for (const Commande& commande : index->filtrerCommandes(filtre.statut, filtre.ville, filtre.debut, filtre.fin)) {
+            idsIndex.insert(commande.getIdCommande());
+        }
+        const QSet<int> idsReference = commandesSql(filtre.statut, filtre.ville, filtre.debut, filtre.fin);
+        if (idsIndex != idsReference) {
+            qCritical() << "Filtre incohérent" << filtre.statut << filtre.ville << filtre.debut << filtre.fin
+                        << ":" << idsIndex.size() << "commandes par l'index," << idsReference.size() << "en SQL";
+            return 1;
+        }
+    }
+
+    StatistiquesLivraison* statistiques = StatistiquesLivraison::getInstance();
+    QString ecart = ecartDelais("global", statistiques->global(), delaisSql(QString()));
+    for (const QString& ville : parametres.villes) {
+        if (ecart.isEmpty()) {
+            ecart = ecartDelais(ville, statistiques->parVille(ville), delaisSql(ville));
+        }
+    }
+    if (!ecart.isEmpty()) {
+        qCritical().noquote() << "Délais de livraison incohérents," << ecart;
+        return 1;
+    }
+
+    // Vérification, après les mesures (la base est modifiée) : la répartition
+    // en lot journalise exactement une AFFECTATION par commande affectée
+    JournalEvenements journal;
+    const qint64 positionAvant = journal.dernierePosition();
+    const RapportRepartition repartition = RepartitionService().repartirCommandesEnAttente();
+    int evenementsAffectation = 0;
+    journal.rejouer(positionAvant, [&evenementsAffectation](const EvenementCommande& evenement) {
+        if (evenement.type == "AFFECTATION") {
+            ++evenementsAffectation;
+        }
+    });
+    if (!repartition.succes || evenementsAffectation != repartition.affectations) {
+        qCritical() << "Répartition incohérente:" << repartition.affectations << "affectations,"
+                    << evenementsAffectation << "événements AFFECTATION" << repartition.erreur;
+        return 1;
+    }
+
+    QJsonObject contexte;
+    contexte["commandes"] = nombreCommandes;
+    contexte["livreurs"] = nombreLivreurs;
+    contexte["iterations"] = iterations;
+    contexte["graine"] = qint64(parametres.graine);
+    contexte["asymetrie"] = parametres.asymetrieVilles;
+    contexte["pilote"] = "QSQLITE";
+    contexte["remplissage_ms"] = remplissage.dureeMs;
+    contexte["filtres_verifies"] = filtres.size();
+    contexte["livraisons_verifiees"] = statistiques->global().nombre;
+    contexte["affectations_verifiees"] = repartition.affectations;
+    contexte["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    contexte["qt"] = QString(qVersion());
+
+    QJsonObject document;
+    document["contexte"] = contexte;
+    document["resultats"] = resultats;
+    const QByteArray json = QJsonDocument(document).toJson();
+
+    if (parser.isSet("sortie")) {
+        QFile fichier(parser.value("sortie"));
+        if (!fichier.open(QIODevice::WriteOnly)) {
+            qCritical() << "Impossible d'écrire" << fichier.fileName();
+            return 1;
+        }
+        fichier.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    db->disconnectFromDatabase();
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include "ModeConsole.h"
+#include "db/DatabaseManager.h"
+#include "db/GenerateurDonnees.h"
+#include "db/InstrumentationRequetes.h"
+#include "services/CommandeService.h"
+#include "services/LivreurService.h"
+#include "services/IndexFiltres.h"
+#include "services/RepartitionService.h"
+#include "services/StatistiquesLivraison.h"
+#include "utils/Trace.h"
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QElapsedTimer>
+#include <memory>
+#include <cstring>
+
+bool ModeConsole::estDemande(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--console") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModeConsole::besoinRendu(const QString& commande)
+{
+    return commande.startsWith("rapport-");
+}
+
+void ModeConsole::configurerApplication()
+{
+    QString appDir = QCoreApplication::applicationDirPath();
+    QCoreApplication::addLibraryPath(appDir);
+    QCoreApplication::addLibraryPath(appDir + "/platforms");
+    QCoreApplication::addLibraryPath(appDir + "/sqldrivers");
+
+    QCoreApplication::setApplicationName("Système de Gestion Logistique");
+    QCoreApplication::setApplicationVersion("1.0.0");
+    QCoreApplication::setOrganizationName("Aymen Jallouli");
+}
+
+int ModeConsole::executer(int argc, char* argv[])
+{
+    // Commande cherchée avant de créer l'application : elle en fixe le type
+    QString commande;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--console") == 0) {
+            commande = QString::fromLocal8Bit(argv[i + 1]);
+            break;
+        }
+    }
+
+    // Rendu PDF sans serveur d'affichage : plateforme hors écran
+    std::unique_ptr<QCoreApplication> app;
+    if (besoinRendu(commande)) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        app.reset(new QGuiApplication(argc, argv));
+    } else {
+        app.reset(new QCoreApplication(argc, argv));
+    }
+    configurerApplication();
+
+    QStringList arguments = app->arguments();
+    arguments.removeFirst();
+    arguments.removeAll("--console");
+
+    ModeConsole console(arguments);
+    return console.lancer();
+}
+
+ModeConsole::ModeConsole(const QStringList& arguments)
+    : commande(arguments.value(0))
+    , parametres(arguments.mid(1))
+    , sortie(stdout)
+    , erreurs(stderr)
+{
+}
+
+int ModeConsole::lancer()
+{
+    if (commande.isEmpty()) {
+        return usage();
+    }
+
+    static const QStringList avecFichier = {
+        "rapport-commandes", "rapport-livreurs", "export-commandes", "export-livreurs"
+    };
+    static const QStringList sansFichier = {"statistiques", "repartition", "maintenance"};
+    if (!avecFichier.contains(commande) && !sansFichier.contains(commande) && commande != "generer") {
+        return usage();
+    }
+    if (avecFichier.contains(commande) && parametres.isEmpty()) {
+        erreurs << "Fichier de sortie manquant pour " << commande << Qt::endl;
+        return usage();
+    }
+    if (commande == "generer" && parametres.size() < 2) {
+        erreurs << "Nombres de livreurs et de commandes manquants" << Qt::endl;
+        return usage();
+    }
+
+    // Trace d'exécution de la commande, connexion comprise
+    const QString cheminTrace = qEnvironmentVariable("LOGISTICS_TRACE");
+    if (!cheminTrace.isEmpty()) {
+        Trace::demarrer();
+    }
+
+    // Erreurs de base de données journalisées (stderr), jamais affichées
+    DatabaseManager* db = DatabaseManager::getInstance();
+    if (!db->connectToDatabase()) {
+        erreurs << "Connexion à la base de données impossible" << Qt::endl;
+        if (!cheminTrace.isEmpty()) {
+            Trace::arreter(cheminTrace);
+        }
+        return 1;
+    }
+
+    QElapsedTimer chrono;
+    chrono.start();
+
+    int code = 0;
+    if (commande == "rapport-commandes") {
+        code = genererRapportCommandes(parametres.first());
+    } else if (commande == "rapport-livreurs") {
+        code = genererRapportLivreurs(parametres.first());
+    } else if (commande == "export-commandes") {
+        code = exporterCommandes(parametres.first());
+    } else if (commande == "export-livreurs") {
+        code = exporterLivreurs(parametres.first());
+    } else if (commande == "statistiques") {
+        code = afficherStatistiques();
+    } else if (commande == "generer") {
+        code = generer();
+    } else if (commande == "maintenance") {
+        code = maintenance();
+    } else {
+        code = repartir();
+    }
+
+    erreurs << commande << (code == 0 ? " terminé" : " en échec")
+            << " en " << chrono.elapsed() << " ms" << Qt::endl;
+    InstrumentationRequetes::getInstance()->ecrireRapport();
+    if (!cheminTrace.isEmpty()) {
+        Trace::arreter(cheminTrace);
+    }
+    db->disconnectFromDatabase();
+    return code;
+}
+
+int ModeConsole::genererRapportCommandes(const QString& fichier)
+{
+    CommandeService commandeService;
+    if (!commandeService.genererRapportCommandes(fichier)) {
+        erreurs << "Erreur lors de la génération du rapport: " << fichier << Qt::endl;
+        return 1;
+    }
+    sortie << fichier << Qt::endl;
+    return 0;
+}
+
+int ModeConsole::genererRapportLivreurs(const QString& fichier)
+{
+    LivreurService livreurService;
+    if (!livreurService.genererRapportLivreurs(fichier)) {
+        erreurs << "Erreur lors de la génération du rapport: " << fichier << Qt::endl;
+        return 1;
+    }
+    sortie << fichier << Qt::endl;
+    return 0;
+}
+
+int ModeConsole::exporterCommandes(const QString& fichier)
+{
+    CommandeService commandeService;
+    if (!commandeService.genererListeCommandes(fichier)) {
+        erreurs << "Erreur lors de l'export: " << fichier << Qt::endl;
+        return 1;
+    }
+    sortie << fichier << Qt::endl;
+    return 0;
+}
+
+int ModeConsole::exporterLivreurs(const QString& fichier)
+{
+    LivreurService livreurService;
+    if (!livreurService.genererListeLivreurs(fichier)) {
+        erreurs << "Erreur lors de l'export: " << fichier << Qt::endl;
+        return 1;
+    }
+    sortie << fichier << Qt::endl;
+    return 0;
+}
+
+int ModeConsole::afficherStatistiques()
+{
+    // Sortie « section;clé;valeur » facile à reprendre dans un tableur ou un script
+    CommandeService commandeService;
+    LivreurService livreurService;
+
+    const QMap<QString, int> parStatut = commandeService.obtenirStatistiquesParStatut();
+    for (auto it = parStatut.constBegin(); it != parStatut.constEnd(); ++it) {
+        sortie << "statut;" << it.key() << ";" << it.value() << "\n";
+    }
+
+    const QMap<QString, int> parVille = commandeService.obtenirStatistiquesParVille();
+    for (auto it = parVille.constBegin(); it != parVille.constEnd(); ++it) {
+        sortie << "ville;" << it.key() << ";" << it.value() << "\n";
+    }
+
+    const QMap<QDate, int> parDate = commandeService.obtenirStatistiquesParDate();
+    for (auto it = parDate.constBegin(); it != parDate.constEnd(); ++it) {
+        sortie << "date;" << it.key().toString("yyyy-MM-dd") << ";" << it.value() << "\n";
+    }
+
+    const QMap<QString, int> parZone = livreurService.obtenirStatistiquesParZone();
+    for (auto it = parZone.constBegin(); it != parZone.constEnd(); ++it) {
+        sortie << "zone;" << it.key() << ";" << it.value() << "\n";
+    }
+
+    // Délais de livraison : résumés construits au chargement de l'index
+    if (IndexFiltres::getInstance()->assurerChargement()) {
+        StatistiquesLivraison* statistiques = StatistiquesLivraison::getInstance();
+        auto ecrireDelai = [this](const QString& cle, const MesuresDelai& mesures) {
+            sortie << "delai;" << cle << ";" << mesures.nombre
+                   << ";" << QString::number(mesures.moyenne, 'f', 2)
+                   << ";" << QString::number(mesures.p50, 'f', 2)
+                   << ";" << QString::number(mesures.p90, 'f', 2)
+                   << ";" << QString::number(mesures.p99, 'f', 2) << "\n";
+        };
+
+        ecrireDelai("global", statistiques->global());
+        const QMap<QString, MesuresDelai> villes = statistiques->toutesVilles();
+        for (auto it = villes.constBegin(); it != villes.constEnd(); ++it) {
+            ecrireDelai(it.key(), it.value());
+        }
+    }
+
+    sortie.flush();
+    return 0;
+}
+
+int ModeConsole::repartir()
+{
+    RepartitionService repartitionService;
+    RapportRepartition rapport = repartitionService.repartirCommandesEnAttente();
+
+    if (!rapport.succes) {
+        erreurs << "Erreur lors de la répartition: " << rapport.erreur << Qt::endl;
+        return 1;
+    }
+
+    sortie << "commandes_en_attente;" << rapport.commandesEnAttente << "\n"
+           << "livreurs_disponibles;" << rapport.livreursDisponibles << "\n"
+           << "affectations;" << rapport.affectations << "\n"
+           << "duree_ms;" << rapport.dureeTotaleMs << "\n"
+           << "calcul_ms;" << rapport.dureeCalculMs << Qt::endl;
+    return 0;
+}
+
+int ModeConsole::maintenance()
+{
+    if (!DatabaseManager::getInstance()->purgerSuppressions()) {
+        erreurs << "Erreur lors de la purge du journal des suppressions" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int ModeConsole::generer()
+{
+    ParametresGeneration parametresGeneration;
+    bool livreursValides = false, commandesValides = false, graineValide = true;
+    parametresGeneration.livreurs = parametres[0].toInt(&livreursValides);
+    parametresGeneration.commandes = parametres[1].toInt(&commandesValides);
+    if (parametres.size() > 2) {
+        parametresGeneration.graine = parametres[2].toUInt(&graineValide);
+    }
+    if (!livreursValides || !commandesValides || !graineValide ||
+        parametresGeneration.livreurs <= 0 || parametresGeneration.commandes < 0) {
+        erreurs << "Paramètres de génération invalides" << Qt::endl;
+        return usage();
+    }
+
+    const RapportGeneration rapport = GenerateurDonnees(parametresGeneration).generer();
+    if (!rapport.succes) {
+        erreurs << "Erreur lors de la génération après " << rapport.commandes
+                << " commandes" << Qt::endl;
+        return 1;
+    }
+
+    sortie << "livreurs;" << rapport.livreurs << "\n"
+           << "commandes;" << rapport.commandes << "\n"
+           << "duree_ms;" << rapport.dureeMs << Qt::endl;
+    return 0;
+}
+
+int ModeConsole::usage()
+{
+    erreurs << "Usage: LogisticsManagementSystem --console <commande> [fichier]\n"
+               "  rapport-commandes <fichier.pdf>\n"
+               "  rapport-livreurs <fichier.pdf>\n"
+               "  export-commandes <fichier.xlsx|fichier.csv>\n"
+               "  export-livreurs <fichier.xlsx|fichier.csv>\n"
+               "  statistiques\n"
+               "  repartition\n"
+               "  maintenance\n"
+               "  generer <livreurs> <commandes> [graine]" << Qt::endl;
+    return 2;
+}
@@ -0,0 +1,57 @@
+#ifndef MODECONSOLE_H
+#define MODECONSOLE_H
+
+#include <QStringList>
+#include <QTextStream>
+
+// Exécution sans interface graphique, pour les traitements planifiés (cron)
+// sur des serveurs sans session de bureau :
+//
+//   LogisticsManagementSystem --console <commande> [fichier]
+//
+//   rapport-commandes <fichier.pdf>   rapport PDF des commandes
+//   rapport-livreurs <fichier.pdf>    rapport PDF des livreurs et tournées
+//   export-commandes <fichier>        liste des commandes (.xlsx ou .csv)
+//   export-livreurs <fichier>         liste des livreurs (.xlsx ou .csv)
+//   statistiques                      agrégats et délais sur la sortie standard
+//   repartition                       répartition des commandes en attente
+//   maintenance                       purge du journal des suppressions
+//   generer <livreurs> <commandes> [graine]
+//                                     jeu de données synthétique (tests de charge)
+//
+// Aucune fenêtre ni boîte de dialogue : les erreurs vont sur stderr et le
+// code de sortie indique le résultat (0 succès, 1 échec, 2 usage).
+class ModeConsole
+{
+public:
+    static bool estDemande(int argc, char* argv[]);
+    static int executer(int argc, char* argv[]);
+
+    // Nom, version, organisation et chemins des plugins, communs aux deux
+    // modes (les QSettings sont ainsi partagés avec l'interface)
+    static void configurerApplication();
+
+private:
+    ModeConsole(const QStringList& arguments);
+
+    int lancer();
+    int genererRapportCommandes(const QString& fichier);
+    int genererRapportLivreurs(const QString& fichier);
+    int exporterCommandes(const QString& fichier);
+    int exporterLivreurs(const QString& fichier);
+    int afficherStatistiques();
+    int repartir();
+    int maintenance();
+    int generer();
+    int usage();
+
+    // Les rapports PDF ont besoin du rendu du texte (QGuiApplication)
+    static bool besoinRendu(const QString& commande);
+
+    QString commande;
+    QStringList parametres;
+    QTextStream sortie;
+    QTextStream erreurs;
+};
+
+#endif // MODECONSOLE_H
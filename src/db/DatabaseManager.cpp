@@ -1,25 +1,44 @@
 #include "DatabaseManager.h"
+#include "GenerateurDonnees.h"
+#include "InstrumentationRequetes.h"
+#include "utils/Trace.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
-#include <QMessageBox>
-#include <QApplication>
+#include <QCoreApplication>
+#include <QThread>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QRegularExpression>
 
 DatabaseManager* DatabaseManager::instance = nullptr;
 
+namespace {
+
+// Échec d'une instruction de migration déjà passée : nom déjà utilisé
+// (ORA-00955), colonne déjà ajoutée (ORA-01430), colonnes déjà indexées
+// (ORA-01408). Toute autre erreur fait échouer la migration.
+bool dejaPresent(const QSqlQuery& query)
+{
+    const QString erreur = query.lastError().text();
+    return erreur.contains("ORA-00955") || erreur.contains("ORA-01430") || erreur.contains("ORA-01408");
+}
+
+}
+
 DatabaseManager::DatabaseManager(QObject *parent) : QObject(parent)
 {
-    // Vérifier les drivers disponibles
-    QStringList drivers = QSqlDatabase::drivers();
-    qDebug() << "Drivers SQL disponibles:" << drivers;
+    // Pilotes cherchés aussi à côté de l'exécutable (<dossier>/sqldrivers),
+    // avant le seul parcours des plugins du démarrage
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath());
 
     // Utiliser Oracle (QOCI) comme driver principal
-    if (drivers.contains("QOCI")) {
+    if (QSqlDatabase::isDriverAvailable("QOCI")) {
         database = QSqlDatabase::addDatabase("QOCI");
         qDebug() << "Utilisation du driver QOCI (Oracle)";
     } else {
         // Fallback vers QODBC si QOCI n'est pas disponible
+        qDebug() << "Driver QOCI absent, drivers disponibles:" << QSqlDatabase::drivers();
         database = QSqlDatabase::addDatabase("QODBC");
         qDebug() << "Utilisation du driver QODBC en fallback";
     }
@@ -40,23 +59,26 @@ DatabaseManager::~DatabaseManager()
 
 bool DatabaseManager::connectToDatabase()
 {
-    // Vérifier les drivers disponibles à nouveau avant la connexion
-    QStringList drivers = QSqlDatabase::drivers();
-    qDebug() << "Drivers SQL disponibles avant connexion:" << drivers;
-    
-    // Afficher où Qt cherche les plugins
-    qDebug() << "Qt Library Paths:" << QApplication::libraryPaths();
-    
-    // Tentative de chargement manuel du pilote
-    QApplication::addLibraryPath(QApplication::applicationDirPath() + "/sqldrivers");
-    QApplication::addLibraryPath(QApplication::applicationDirPath());
-    
+    configurer();
+    return ouvrirConnexion() && verifierSchema();
+}
+
+void DatabaseManager::configurer()
+{
     // Configuration Oracle
     database.setHostName("localhost");
     database.setDatabaseName("XE");
     database.setUserName("system");
     database.setPassword("++652100"); 
     database.setPort(1521);
+}
+
+bool DatabaseManager::ouvrirConnexion()
+{
+    PorteeTrace portee("DatabaseManager::ouvrirConnexion", "db");
+    if (database.isOpen()) {
+        return true;
+    }
     
     qDebug() << "Tentative de connexion Oracle avec: "
              << "Driver=" << database.driverName()
@@ -72,18 +94,162 @@ bool DatabaseManager::connectToDatabase()
     }
 
     qDebug() << "Connexion à Oracle réussie !";
+    return true;
+}
+
+bool DatabaseManager::verifierSchema()
+{
+    // Schéma SQLite créé à l'ouverture (CREATE ... IF NOT EXISTS)
+    if (isSqlite()) {
+        return true;
+    }
     
-    // Vérifier si les tables existent déjà et les créer seulement si nécessaire
-    if (!checkTablesExist()) {
-        qDebug() << "Tables non trouvées, création des tables...";
-        createTables();
-    } else {
-        qDebug() << "Tables existantes trouvées, connexion prête à l'utilisation.";
+    PorteeTrace portee("DatabaseManager::verifierSchema", "db");
+    int version = 0;
+    if (!versionSchema(version)) {
+        return false;
     }
     
+    // Démarrage à chaud : une seule lecture, ni DDL ni catalogue
+    if (version < SCHEMA_VERSION) {
+        if (version < 0) {
+            // Base antérieure au suivi des versions, ou base vide : les
+            // migrations tolèrent les objets déjà présents
+            QSqlQuery createTable(connexion());
+            if (!createTable.exec("CREATE TABLE SCHEMA_VERSION ("
+                                  "VERSION NUMBER PRIMARY KEY, "
+                                  "DESCRIPTION VARCHAR2(200), "
+                                  "APPLIQUEE_LE DATE DEFAULT SYSDATE)")
+                && !createTable.lastError().text().contains("ORA-00955")) {
+                showDatabaseError("Erreur de création de SCHEMA_VERSION:\n" + createTable.lastError().text());
+                return false;
+            }
+            version = 0;
+        }
+        
+        for (int cible = version + 1; cible <= SCHEMA_VERSION; ++cible) {
+            if (!appliquerMigration(cible)) {
+                showDatabaseError(QString("Échec de la migration du schéma vers la version %1").arg(cible));
+                return false;
+            }
+            // Clé primaire : un autre client ayant migré en même temps ne
+            // produit pas de doublon (seule la violation d'unicité est ignorée)
+            QSqlQuery insert(connexion());
+            insert.prepare("INSERT INTO SCHEMA_VERSION (VERSION, DESCRIPTION) VALUES (?, ?)");
+            insert.addBindValue(cible);
+            insert.addBindValue(descriptionMigration(cible));
+            if (!insert.exec() && !insert.lastError().text().contains("ORA-00001")) {
+                showDatabaseError(QString("Erreur d'enregistrement de la version %1 du schéma:\n").arg(cible)
+                                  + insert.lastError().text());
+                return false;
+            }
+        }
+    }
+    qDebug() << "Schéma à jour, version" << SCHEMA_VERSION;
     return true;
 }
 
+bool DatabaseManager::versionSchema(int& version)
+{
+    // Lue sans executeQuery : table absente (ORA-00942) attendue sur une
+    // ancienne base, version -1 ; toute autre erreur interrompt la connexion
+    QSqlQuery query(connexion());
+    if (query.exec("SELECT COALESCE(MAX(VERSION), 0) FROM SCHEMA_VERSION") && query.next()) {
+        version = query.value(0).toInt();
+        return true;
+    }
+    if (query.lastError().text().contains("ORA-00942")) {
+        version = -1;
+        return true;
+    }
+    showDatabaseError("Erreur de lecture de la version du schéma:\n" + query.lastError().text());
+    return false;
+}
+
+bool DatabaseManager::purgerSuppressions()
+{
+    // Maintenance planifiée (mode console), pas à chaque démarrage : au-delà
+    // de la rétention, les vues se rechargent entièrement
+    PorteeTrace portee("DatabaseManager::purgerSuppressions", "db");
+    const QString limite = isSqlite()
+        ? QString("datetime('now', 'localtime', '-%1 days')").arg(DELETION_RETENTION_DAYS)
+        : QString("SYSDATE - %1").arg(DELETION_RETENTION_DAYS);
+    QSqlQuery purge(connexion());
+    if (!purge.exec("DELETE FROM SUPPRESSIONS WHERE DELETED_AT < " + limite)) {
+        showDatabaseError("Erreur de purge du journal des suppressions:\n" + purge.lastError().text());
+        return false;
+    }
+    qDebug() << "Suppressions purgées:" << purge.numRowsAffected();
+    return true;
+}
+
+QString DatabaseManager::descriptionMigration(int version)
+{
+    switch (version) {
+    case 1: return "Tables LIVREURS et COMMANDES, index, clé étrangère en cascade";
+    case 2: return "Colonnes ASSIGNED_AT et DELIVERED_AT";
+    case 3: return "Journal ORDER_EVENTS";
+    case 4: return "Versions par table (TABLE_VERSIONS)";
+    case 5: return "Triggers UPDATED_AT et journal SUPPRESSIONS";
+    case 6: return "Versions par session (SESSION_VERSIONS), sans ligne partagée entre écrivains";
+    case 7: return "Index ORDER_EVENTS(CREATED_AT) pour la fenêtre de relecture du journal";
+    default: return QString();
+    }
+}
+
+bool DatabaseManager::appliquerMigration(int version)
+{
+    // Une migration publiée ne change plus : toute évolution du schéma est
+    // une version de plus (SCHEMA_VERSION et descriptionMigration)
+    qDebug() << "Migration du schéma vers la version" << version << ":" << descriptionMigration(version);
+    switch (version) {
+    case 1:
+        // Tables déjà là (base créée avant le suivi des versions) : index et
+        // clé étrangère vérifiés quand même, les présents sont tolérés
+        return (checkTablesExist() || createTables()) && createIndexes() && updateForeignKeyConstraints();
+    case 2:
+        return addTimestampColumns();
+    case 3:
+        return createOrderEventsTable();
+    case 4:
+        return createVersionTracking();
+    case 5:
+        return createChangeTracking();
+    case 6:
+        return createSessionVersionTracking();
+    case 7:
+        return createOrderEventsDateIndex();
+    default:
+        return false;
+    }
+}
+
+bool DatabaseManager::connectToSqlite(const QString& cheminFichier)
+{
+    // Remplace la connexion par défaut (QOCI/QODBC) créée au démarrage
+    disconnectFromDatabase();
+    const QString nomConnexion = database.connectionName();
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(nomConnexion);
+    
+    database = QSqlDatabase::addDatabase("QSQLITE");
+    database.setDatabaseName(cheminFichier);
+    
+    if (!database.open()) {
+        showDatabaseError("Erreur d'ouverture de la base SQLite:\n" + database.lastError().text());
+        return false;
+    }
+    
+    qDebug() << "Base SQLite ouverte:" << cheminFichier;
+    return createSqliteSchema();
+}
+
+QString DatabaseManager::identifiantBase() const
+{
+    return QString("%1://%2@%3:%4/%5").arg(database.driverName(), database.userName(), database.hostName())
+           .arg(database.port()).arg(database.databaseName());
+}
+
 void DatabaseManager::disconnectFromDatabase()
 {
     if (database.isOpen()) {
@@ -99,14 +265,44 @@ bool DatabaseManager::isConnected()
 
 void DatabaseManager::showDatabaseError(const QString& message)
 {
-    QMessageBox::critical(nullptr, "Erreur de base de données", message);
     qCritical() << message;
+    emit databaseError(message);
+}
+
+QSqlDatabase DatabaseManager::connexion()
+{
+    if (QThread::currentThread() == thread()) {
+        return database;
+    }
+
+    // Copie de la connexion principale propre à ce fil, ouverte au premier
+    // usage et retirée à la fin du fil (fils de QThreadPool compris)
+    const QString nom = QString("%1_fil_%2").arg(database.connectionName())
+                        .arg(quintptr(QThread::currentThreadId()));
+    if (QSqlDatabase::contains(nom)) {
+        return QSqlDatabase::database(nom);
+    }
+
+    QSqlDatabase copie = QSqlDatabase::cloneDatabase(database.connectionName(), nom);
+    if (!copie.open()) {
+        qWarning() << "Connexion secondaire impossible:" << copie.lastError().text();
+    }
+    QObject::connect(QThread::currentThread(), &QThread::finished, QThread::currentThread(), [nom] {
+        QSqlDatabase::removeDatabase(nom);
+    }, Qt::DirectConnection);
+    return copie;
 }
 
 QSqlQuery DatabaseManager::executeQuery(const QString& queryString)
 {
-    QSqlQuery query(database);
-    if (!query.exec(queryString)) {
+    PorteeTrace portee("DatabaseManager::executeQuery", "db", queryString);
+    QSqlQuery query(connexion());
+    QElapsedTimer chrono;
+    chrono.start();
+    InstrumentationRequetes::getInstance()->demarrer();
+    const bool succes = query.exec(queryString);
+    InstrumentationRequetes::getInstance()->enregistrer(queryString, chrono.nsecsElapsed(), query, succes, {});
+    if (!succes) {
         QString error = "Erreur d'exécution de la requête:\n" + query.lastError().text();
         showDatabaseError(error);
     }
@@ -115,14 +311,20 @@ QSqlQuery DatabaseManager::executeQuery(const QString& queryString)
 
 QSqlQuery DatabaseManager::executePreparedQuery(const QString& queryString, const QVariantList& values)
 {
-    QSqlQuery query(database);
+    PorteeTrace portee("DatabaseManager::executePreparedQuery", "db", queryString);
+    QSqlQuery query(connexion());
+    QElapsedTimer chrono;
+    chrono.start();
+    InstrumentationRequetes::getInstance()->demarrer();
     query.prepare(queryString);
 
     for (const QVariant& value : values) {
         query.addBindValue(value);
     }
 
-    if (!query.exec()) {
+    const bool succes = query.exec();
+    InstrumentationRequetes::getInstance()->enregistrer(queryString, chrono.nsecsElapsed(), query, succes, values);
+    if (!succes) {
         QString error = "Erreur d'exécution de la requête préparée:\n" + query.lastError().text();
         showDatabaseError(error);
     }
@@ -130,6 +332,174 @@ QSqlQuery DatabaseManager::executePreparedQuery(const QString& queryString, cons
     return query;
 }
 
+QSqlQuery DatabaseManager::executeBatchQuery(const QString& queryString, const QList<QVariantList>& colonnes)
+{
+    PorteeTrace portee("DatabaseManager::executeBatchQuery", "db", queryString);
+    QSqlQuery query(connexion());
+    QElapsedTimer chrono;
+    chrono.start();
+    InstrumentationRequetes::getInstance()->demarrer();
+    query.prepare(queryString);
+
+    // Liaison par tableaux : une liste de valeurs (une par ligne) par paramètre
+    for (const QVariantList& colonne : colonnes) {
+        query.addBindValue(colonne);
+    }
+
+    const bool succes = query.execBatch();
+    InstrumentationRequetes::getInstance()->enregistrer(queryString, chrono.nsecsElapsed(), query, succes,
+                                                        QVariantList(colonnes.begin(), colonnes.end()));
+    if (!succes) {
+        QString error = "Erreur d'exécution de la requête par lot:\n" + query.lastError().text();
+        showDatabaseError(error);
+    }
+
+    return query;
+}
+
+QVariantList DatabaseManager::executeInsertReturning(const QString& insertString, const QVariantList& values,
+                                                    const QStringList& colonnesRetour,
+                                                    const QVariantList& modeles)
+{
+    PorteeTrace portee("DatabaseManager::executeInsertReturning", "db", insertString);
+    QSqlQuery query(connexion());
+    QVariantList retour;
+
+    QElapsedTimer chrono;
+    chrono.start();
+    InstrumentationRequetes::getInstance()->demarrer();
+
+    if (isSqlite()) {
+        query.prepare(insertString);
+        for (const QVariant& value : values) {
+            query.addBindValue(value);
+        }
+        const bool succes = query.exec();
+        InstrumentationRequetes::getInstance()->enregistrer(insertString, chrono.nsecsElapsed(), query, succes, values);
+        if (!succes) {
+            showDatabaseError("Erreur d'exécution de l'insertion:\n" + query.lastError().text());
+            return retour;
+        }
+
+        // Identité seule : last_insert_rowid(), sans autre requête
+        const QVariant rowid = query.lastInsertId();
+        if (colonnesRetour.size() == 1) {
+            retour << rowid;
+            return retour;
+        }
+
+        // Colonnes par défaut : relues sur le rowid de la ligne insérée
+        QRegularExpression expression("INSERT\\s+INTO\\s+(\\w+)", QRegularExpression::CaseInsensitiveOption);
+        const QString table = expression.match(insertString).captured(1);
+        QSqlQuery relecture = executePreparedQuery(
+            QString("SELECT %1 FROM %2 WHERE rowid = ?").arg(colonnesRetour.join(", "), table), {rowid});
+        if (relecture.next()) {
+            for (int i = 0; i < colonnesRetour.size(); ++i) {
+                retour << relecture.value(i);
+            }
+        }
+        return retour;
+    }
+
+    // Oracle : paramètres de sortie liés après les valeurs insérées
+    QStringList marqueurs;
+    for (int i = 0; i < colonnesRetour.size(); ++i) {
+        marqueurs << "?";
+    }
+    const QString insertion = QString("%1 RETURNING %2 INTO %3")
+                              .arg(insertString, colonnesRetour.join(", "), marqueurs.join(", "));
+    query.prepare(insertion);
+
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
+    }
+    for (int i = 0; i < colonnesRetour.size(); ++i) {
+        query.addBindValue(modeles.value(i, QVariant(0)), QSql::Out);
+    }
+
+    const bool succes = query.exec();
+    InstrumentationRequetes::getInstance()->enregistrer(insertion, chrono.nsecsElapsed(), query, succes, values);
+    if (!succes) {
+        showDatabaseError("Erreur d'exécution de l'insertion:\n" + query.lastError().text());
+        return retour;
+    }
+
+    for (int i = 0; i < colonnesRetour.size(); ++i) {
+        retour << query.boundValue(values.size() + i);
+    }
+    return retour;
+}
+
+QList<QVariantList> DatabaseManager::executeBatchInsertReturning(const QString& insertString,
+                                                                 const QList<QVariantList>& colonnes,
+                                                                 const QStringList& colonnesRetour,
+                                                                 const QVariantList& modeles)
+{
+    PorteeTrace portee("DatabaseManager::executeBatchInsertReturning", "db", insertString);
+    QList<QVariantList> retour;
+    const int lignes = colonnes.isEmpty() ? 0 : colonnes.first().size();
+
+    if (database.driverName() != "QOCI") {
+        // Pas de tableaux en sortie : une insertion par ligne (même transaction)
+        retour.resize(colonnesRetour.size());
+        for (int ligne = 0; ligne < lignes; ++ligne) {
+            QVariantList values;
+            for (const QVariantList& colonne : colonnes) {
+                values << colonne.value(ligne);
+            }
+            const QVariantList valeurs = executeInsertReturning(insertString, values, colonnesRetour, modeles);
+            if (valeurs.size() != colonnesRetour.size()) {
+                return QList<QVariantList>();
+            }
+            for (int i = 0; i < valeurs.size(); ++i) {
+                retour[i] << valeurs[i];
+            }
+        }
+        return retour;
+    }
+
+    // Oracle : un seul aller-retour, tableaux en entrée comme en sortie
+    QStringList marqueurs;
+    for (int i = 0; i < colonnesRetour.size(); ++i) {
+        marqueurs << "?";
+    }
+    QSqlQuery query(connexion());
+    QElapsedTimer chrono;
+    chrono.start();
+    InstrumentationRequetes::getInstance()->demarrer();
+    const QString insertion = QString("%1 RETURNING %2 INTO %3")
+                              .arg(insertString, colonnesRetour.join(", "), marqueurs.join(", "));
+    query.prepare(insertion);
+
+    for (const QVariantList& colonne : colonnes) {
+        query.addBindValue(colonne);
+    }
+    for (int i = 0; i < colonnesRetour.size(); ++i) {
+        query.addBindValue(QVariantList(lignes, modeles.value(i, QVariant(0))), QSql::Out);
+    }
+
+    const bool succes = query.execBatch();
+    InstrumentationRequetes::getInstance()->enregistrer(insertion, chrono.nsecsElapsed(), query, succes,
+                                                        QVariantList(colonnes.begin(), colonnes.end()));
+    if (!succes) {
+        showDatabaseError("Erreur d'exécution de l'insertion par lot:\n" + query.lastError().text());
+        return retour;
+    }
+
+    // Tableaux en sortie incomplets (pilote ne renvoyant que la dernière
+    // ligne, par exemple) : échec plutôt que des identifiants décalés
+    for (int i = 0; i < colonnesRetour.size(); ++i) {
+        const QVariantList valeurs = query.boundValue(colonnes.size() + i).toList();
+        if (valeurs.size() != lignes) {
+            showDatabaseError(QString("Insertion par lot: %1 valeurs de %2 renvoyées pour %3 lignes")
+                              .arg(valeurs.size()).arg(colonnesRetour[i]).arg(lignes));
+            return QList<QVariantList>();
+        }
+        retour << valeurs;
+    }
+    return retour;
+}
+
 bool DatabaseManager::beginTransaction()
 {
     return database.transaction();
@@ -137,6 +507,7 @@ bool DatabaseManager::beginTransaction()
 
 bool DatabaseManager::commitTransaction()
 {
+    PorteeTrace portee("DatabaseManager::commitTransaction", "db");
     return database.commit();
 }
 
@@ -174,7 +545,7 @@ bool DatabaseManager::createTables()
         )
     )";
     
-    QSqlQuery queryLivreurs(database);
+    QSqlQuery queryLivreurs(connexion());
     qDebug() << "Tentative de création table LIVREURS...";
     if (!queryLivreurs.exec(createLivreurs)) {
         // Si la table existe déjà, ce n'est pas une erreur
@@ -201,11 +572,13 @@ bool DatabaseManager::createTables()
             ID_LIVREUR NUMBER,
             CREATED_AT DATE DEFAULT SYSDATE,
             UPDATED_AT DATE DEFAULT SYSDATE,
+            ASSIGNED_AT DATE,
+            DELIVERED_AT DATE,
             CONSTRAINT FK_COMMANDES_LIVREUR FOREIGN KEY (ID_LIVREUR) REFERENCES LIVREURS(ID_LIVREUR) ON DELETE CASCADE
         )
     )";
     
-    QSqlQuery queryCommandes(database);
+    QSqlQuery queryCommandes(connexion());
     qDebug() << "Tentative de création table COMMANDES...";
     if (!queryCommandes.exec(createCommandes)) {
         // Si la table existe déjà, ce n'est pas une erreur
@@ -221,12 +594,7 @@ bool DatabaseManager::createTables()
         qDebug() << "Table COMMANDES créée avec succès";
     }
     
-    // Créer des index (ils seront ignorés s'ils existent déjà)
-    createIndexes();
-    
-    // Mettre à jour les contraintes pour la suppression en cascade
-    updateForeignKeyConstraints();
-    
+    // Index et contrainte en cascade : migration 1, après la création
     qDebug() << "Vérification/Création des tables terminée avec succès";
     return true;
 }
@@ -234,7 +602,7 @@ bool DatabaseManager::createTables()
 bool DatabaseManager::checkTablesExist()
 {
     // Vérifier si les tables principales existent
-    QSqlQuery query(database);
+    QSqlQuery query(connexion());
     query.prepare("SELECT COUNT(*) FROM USER_TABLES WHERE TABLE_NAME IN ('LIVREURS', 'COMMANDES')");
     
     if (!query.exec()) {
@@ -251,7 +619,7 @@ bool DatabaseManager::checkTablesExist()
     return false;
 }
 
-void DatabaseManager::createIndexes()
+bool DatabaseManager::createIndexes()
 {
     // Créer des index et triggers pour l'auto-update
     QStringList indexQueries = {
@@ -265,29 +633,345 @@ void DatabaseManager::createIndexes()
     };
     
     for (const QString& indexQuery : indexQueries) {
-        QSqlQuery query(database);
-        if (!query.exec(indexQuery)) {
+        QSqlQuery query(connexion());
+        if (query.exec(indexQuery)) {
+            qDebug() << "Index créé avec succès";
+        } else if (dejaPresent(query)) {
             // Les index existants ne sont pas une erreur
-            QString error = query.lastError().text();
-            if (error.contains("name is already used by an existing object") || 
-                error.contains("ORA-00955")) {
-                qDebug() << "Index existe déjà - OK";
-            } else {
-                qDebug() << "Erreur création index:" << error;
-            }
+            qDebug() << "Index existe déjà - OK";
         } else {
-            qDebug() << "Index créé avec succès";
+            qDebug() << "Erreur création index:" << query.lastError().text();
+            return false;
         }
     }
+    return true;
+}
+
+bool DatabaseManager::addTimestampColumns()
+{
+    // Horodatage des transitions : affectation à un livreur et livraison
+    QSqlQuery query(connexion());
+    if (query.exec("ALTER TABLE COMMANDES ADD (ASSIGNED_AT DATE, DELIVERED_AT DATE)")) {
+        qDebug() << "Colonnes ASSIGNED_AT / DELIVERED_AT ajoutées";
+    } else if (dejaPresent(query)) {
+        qDebug() << "Colonnes d'horodatage existent déjà - OK";
+    } else {
+        qDebug() << "Erreur ajout colonnes d'horodatage:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::createOrderEventsTable()
+{
+    // Historique en ajout seul : pas de clé étrangère, les événements
+    // survivent à la suppression de la commande
+    QString createEvents = R"(
+        CREATE TABLE ORDER_EVENTS (
+            ID_EVENEMENT NUMBER GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+            ID_COMMANDE NUMBER NOT NULL,
+            TYPE_EVENEMENT VARCHAR2(20) NOT NULL,
+            STATUT_PRECEDENT VARCHAR2(50),
+            STATUT VARCHAR2(50),
+            ID_LIVREUR NUMBER,
+            VILLE_LIVRAISON VARCHAR2(100),
+            DATE_COMMANDE DATE,
+            ID_CLIENT NUMBER,
+            CREATED_AT DATE DEFAULT SYSDATE
+        )
+    )";
+    
+    QSqlQuery query(connexion());
+    if (query.exec(createEvents)) {
+        qDebug() << "Table ORDER_EVENTS créée avec succès";
+    } else if (dejaPresent(query)) {
+        qDebug() << "Table ORDER_EVENTS existe déjà - OK";
+    } else {
+        qDebug() << "Erreur création table ORDER_EVENTS:" << query.lastError().text();
+        return false;
+    }
+    
+    // Créé aussi quand la table existait : une migration interrompue après
+    // la table le laisserait sinon manquant
+    QSqlQuery index(connexion());
+    if (!index.exec("CREATE INDEX IDX_ORDER_EVENTS_COMMANDE ON ORDER_EVENTS(ID_COMMANDE)") && !dejaPresent(index)) {
+        qDebug() << "Erreur création index ORDER_EVENTS:" << index.lastError().text();
+        return false;
+    }
+    return true;
 }
 
-void DatabaseManager::updateForeignKeyConstraints()
+bool DatabaseManager::createVersionTracking()
+{
+    // Compteur de version par table, incrémenté par trigger à chaque
+    // instruction d'écriture : une seule ligne à relire pour savoir si une
+    // table a changé, quel que soit le client qui l'a modifiée
+    QSqlQuery createTable(connexion());
+    if (!createTable.exec("CREATE TABLE TABLE_VERSIONS ("
+                          "NOM_TABLE VARCHAR2(30) PRIMARY KEY, "
+                          "VERSION NUMBER DEFAULT 0 NOT NULL)")
+        && !dejaPresent(createTable)) {
+        qDebug() << "Erreur création table TABLE_VERSIONS:" << createTable.lastError().text();
+        return false;
+    }
+    
+    for (const QString& table : {QString("COMMANDES"), QString("LIVREURS")}) {
+        QSqlQuery insert(connexion());
+        insert.prepare("INSERT INTO TABLE_VERSIONS (NOM_TABLE, VERSION) "
+                       "SELECT ?, 0 FROM DUAL WHERE NOT EXISTS "
+                       "(SELECT 1 FROM TABLE_VERSIONS WHERE NOM_TABLE = ?)");
+        insert.addBindValue(table);
+        insert.addBindValue(table);
+        if (!insert.exec()) {
+            qDebug() << "Erreur initialisation de TABLE_VERSIONS" << table << ":" << insert.lastError().text();
+            return false;
+        }
+        
+        QSqlQuery trigger(connexion());
+        QString createTrigger = QString(
+            "CREATE OR REPLACE TRIGGER TRG_VERSION_%1 "
+            "AFTER INSERT OR UPDATE OR DELETE ON %1 "
+            "BEGIN "
+            "UPDATE TABLE_VERSIONS SET VERSION = VERSION + 1 WHERE NOM_TABLE = '%1'; "
+            "END;").arg(table);
+        if (!trigger.exec(createTrigger)) {
+            qDebug() << "Erreur création trigger de version" << table << ":" << trigger.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::createSessionVersionTracking()
+{
+    // Un compteur par (table, session) au lieu d'une ligne par table : la
+    // ligne n'est verrouillée que par sa session, les écrivains concurrents
+    // ne s'attendent plus jusqu'au commit. La somme des compteurs validés
+    // croît à chaque transaction validée, quel que soit l'ordre des commits.
+    QSqlQuery createTable(connexion());
+    if (!createTable.exec("CREATE TABLE SESSION_VERSIONS ("
+                          "NOM_TABLE VARCHAR2(30) NOT NULL, "
+                          "ID_SESSION NUMBER NOT NULL, "
+                          "VERSION NUMBER DEFAULT 0 NOT NULL, "
+                          "CONSTRAINT PK_SESSION_VERSIONS PRIMARY KEY (NOM_TABLE, ID_SESSION))")
+        && !dejaPresent(createTable)) {
+        qDebug() << "Erreur création table SESSION_VERSIONS:" << createTable.lastError().text();
+        return false;
+    }
+    
+    for (const QString& table : {QString("COMMANDES"), QString("LIVREURS")}) {
+        // Remplace le trigger de la version 4 (même nom)
+        QSqlQuery trigger(connexion());
+        QString createTrigger = QString(
+            "CREATE OR REPLACE TRIGGER TRG_VERSION_%1 "
+            "AFTER INSERT OR UPDATE OR DELETE ON %1 "
+            "BEGIN "
+            "UPDATE SESSION_VERSIONS SET VERSION = VERSION + 1 "
+            "WHERE NOM_TABLE = '%1' AND ID_SESSION = SYS_CONTEXT('USERENV', 'SID'); "
+            "IF SQL%ROWCOUNT = 0 THEN "
+            "INSERT INTO SESSION_VERSIONS (NOM_TABLE, ID_SESSION, VERSION) "
+            "VALUES ('%1', SYS_CONTEXT('USERENV', 'SID'), 1); "
+            "END IF; "
+            "END;").arg(table);
+        if (!trigger.exec(createTrigger)) {
+            qDebug() << "Erreur création trigger de version" << table << ":" << trigger.lastError().text();
+            return false;
+        }
+    }
+    
+    // Plus alimentée : un client d'avant la migration qui la relirait
+    // échouerait et rechargerait tout, au lieu de ne plus rien voir changer
+    QSqlQuery drop(connexion());
+    if (!drop.exec("DROP TABLE TABLE_VERSIONS") && !drop.lastError().text().contains("ORA-00942")) {
+        qDebug() << "Erreur suppression table TABLE_VERSIONS:" << drop.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::createOrderEventsDateIndex()
+{
+    // Relecture des dernières secondes du journal à chaque synchronisation
+    QSqlQuery index(connexion());
+    if (!index.exec("CREATE INDEX IDX_ORDER_EVENTS_CREATED_AT ON ORDER_EVENTS(CREATED_AT)") && !dejaPresent(index)) {
+        qDebug() << "Erreur création index ORDER_EVENTS(CREATED_AT):" << index.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::createChangeTracking()
+{
+    // UPDATED_AT tenu par trigger : toutes les écritures sont couvertes,
+    // y compris celles des autres clients et des requêtes par lot
+    for (const QString& table : {QString("COMMANDES"), QString("LIVREURS")}) {
+        QSqlQuery trigger(connexion());
+        QString createTrigger = QString(
+            "CREATE OR REPLACE TRIGGER TRG_UPDATED_AT_%1 "
+            "BEFORE INSERT OR UPDATE ON %1 FOR EACH ROW "
+            "BEGIN :NEW.UPDATED_AT := SYSDATE; END;").arg(table);
+        if (!trigger.exec(createTrigger)) {
+            qDebug() << "Erreur création trigger UPDATED_AT" << table << ":" << trigger.lastError().text();
+            return false;
+        }
+        
+        QSqlQuery index(connexion());
+        if (!index.exec(QString("CREATE INDEX IDX_%1_UPDATED_AT ON %1(UPDATED_AT)").arg(table))
+            && !dejaPresent(index)) {
+            qDebug() << "Erreur création index UPDATED_AT" << table << ":" << index.lastError().text();
+            return false;
+        }
+    }
+    
+    // Lignes supprimées : absentes des tables, donc tracées à part
+    QSqlQuery createTable(connexion());
+    if (!createTable.exec("CREATE TABLE SUPPRESSIONS ("
+                          "NOM_TABLE VARCHAR2(30) NOT NULL, "
+                          "ID_LIGNE NUMBER NOT NULL, "
+                          "DELETED_AT DATE DEFAULT SYSDATE)")
+        && !dejaPresent(createTable)) {
+        qDebug() << "Erreur création table SUPPRESSIONS:" << createTable.lastError().text();
+        return false;
+    }
+    
+    QSqlQuery index(connexion());
+    if (!index.exec("CREATE INDEX IDX_SUPPRESSIONS_DATE ON SUPPRESSIONS(DELETED_AT)") && !dejaPresent(index)) {
+        qDebug() << "Erreur création index SUPPRESSIONS:" << index.lastError().text();
+        return false;
+    }
+    
+    const QStringList triggers = {
+        "CREATE OR REPLACE TRIGGER TRG_SUPPRESSION_COMMANDES "
+        "AFTER DELETE ON COMMANDES FOR EACH ROW BEGIN "
+        "INSERT INTO SUPPRESSIONS (NOM_TABLE, ID_LIGNE) VALUES ('COMMANDES', :OLD.ID_COMMANDE); "
+        "END;",
+        "CREATE OR REPLACE TRIGGER TRG_SUPPRESSION_LIVREURS "
+        "AFTER DELETE ON LIVREURS FOR EACH ROW BEGIN "
+        "INSERT INTO SUPPRESSIONS (NOM_TABLE, ID_LIGNE) VALUES ('LIVREURS', :OLD.ID_LIVREUR); "
+        "END;"
+    };
+    for (const QString& createTrigger : triggers) {
+        QSqlQuery trigger(connexion());
+        if (!trigger.exec(createTrigger)) {
+            qDebug() << "Erreur création trigger SUPPRESSIONS:" << trigger.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::createSqliteSchema()
+{
+    // Équivalent SQLite du schéma Oracle (identités en AUTOINCREMENT) ; dates
+    // à l'heure locale, comme currentServerTime, et triggers par ligne (une
+    // seule session : ID_SESSION 0)
+    QStringList instructions = {
+        "PRAGMA foreign_keys = ON",
+        "PRAGMA journal_mode = WAL",
+        "CREATE TABLE IF NOT EXISTS LIVREURS ("
+        " ID_LIVREUR INTEGER PRIMARY KEY AUTOINCREMENT,"
+        " NOM TEXT NOT NULL, TELEPHONE TEXT NOT NULL, ZONE_LIVRAISON TEXT NOT NULL,"
+        " VEHICULE TEXT NOT NULL, DISPONIBILITE INTEGER DEFAULT 1,"
+        " CREATED_AT TEXT DEFAULT (datetime('now', 'localtime')),"
+        " UPDATED_AT TEXT DEFAULT (datetime('now', 'localtime')))",
+        "CREATE TABLE IF NOT EXISTS COMMANDES ("
+        " ID_COMMANDE INTEGER PRIMARY KEY AUTOINCREMENT,"
+        " DATE_COMMANDE TEXT NOT NULL, STATUT TEXT DEFAULT 'En attente',"
+        " VILLE_LIVRAISON TEXT NOT NULL, ID_CLIENT INTEGER NOT NULL,"
+        " ID_LIVREUR INTEGER REFERENCES LIVREURS(ID_LIVREUR) ON DELETE CASCADE,"
+        " CREATED_AT TEXT DEFAULT (datetime('now', 'localtime')),"
+        " UPDATED_AT TEXT DEFAULT (datetime('now', 'localtime')),"
+        " ASSIGNED_AT TEXT, DELIVERED_AT TEXT)",
+        "CREATE TABLE IF NOT EXISTS ORDER_EVENTS ("
+        " ID_EVENEMENT INTEGER PRIMARY KEY AUTOINCREMENT,"
+        " ID_COMMANDE INTEGER NOT NULL, TYPE_EVENEMENT TEXT NOT NULL,"
+        " STATUT_PRECEDENT TEXT, STATUT TEXT, ID_LIVREUR INTEGER, VILLE_LIVRAISON TEXT,"
+        " DATE_COMMANDE TEXT, ID_CLIENT INTEGER, CREATED_AT TEXT DEFAULT (datetime('now', 'localtime')))",
+        "CREATE TABLE IF NOT EXISTS SESSION_VERSIONS (NOM_TABLE TEXT NOT NULL, ID_SESSION INTEGER NOT NULL,"
+        " VERSION INTEGER DEFAULT 0, PRIMARY KEY (NOM_TABLE, ID_SESSION))",
+        "CREATE TABLE IF NOT EXISTS SUPPRESSIONS (NOM_TABLE TEXT NOT NULL, ID_LIGNE INTEGER NOT NULL,"
+        " DELETED_AT TEXT DEFAULT (datetime('now', 'localtime')))",
+        "CREATE INDEX IF NOT EXISTS IDX_SUPPRESSIONS_DATE ON SUPPRESSIONS(DELETED_AT)",
+        "CREATE INDEX IF NOT EXISTS IDX_COMMANDES_UPDATED_AT ON COMMANDES(UPDATED_AT)",
+        "CREATE INDEX IF NOT EXISTS IDX_LIVREURS_UPDATED_AT ON LIVREURS(UPDATED_AT)",
+        "CREATE INDEX IF NOT EXISTS IDX_COMMANDES_STATUT ON COMMANDES(STATUT)",
+        "CREATE INDEX IF NOT EXISTS IDX_COMMANDES_VILLE ON COMMANDES(VILLE_LIVRAISON)",
+        "CREATE INDEX IF NOT EXISTS IDX_COMMANDES_DATE ON COMMANDES(DATE_COMMANDE)",
+        "CREATE INDEX IF NOT EXISTS IDX_COMMANDES_LIVREUR ON COMMANDES(ID_LIVREUR)",
+        "CREATE INDEX IF NOT EXISTS IDX_LIVREURS_ZONE ON LIVREURS(ZONE_LIVRAISON)",
+        "CREATE INDEX IF NOT EXISTS IDX_ORDER_EVENTS_COMMANDE ON ORDER_EVENTS(ID_COMMANDE)",
+        "CREATE INDEX IF NOT EXISTS IDX_ORDER_EVENTS_CREATED_AT ON ORDER_EVENTS(CREATED_AT)"
+    };
+    
+    const QList<QPair<QString, QString>> tables = {{"COMMANDES", "ID_COMMANDE"}, {"LIVREURS", "ID_LIVREUR"}};
+    for (const auto& [table, cle] : tables) {
+        // UPDATED_AT posé après coup (pas de :NEW modifiable en SQLite), sauf
+        // si la requête l'a fixé elle-même ; suppressions journalisées
+        instructions << QString("CREATE TRIGGER IF NOT EXISTS TRG_UPDATED_AT_%1 AFTER UPDATE ON %1 "
+                                "FOR EACH ROW WHEN NEW.UPDATED_AT IS OLD.UPDATED_AT BEGIN "
+                                "UPDATE %1 SET UPDATED_AT = datetime('now', 'localtime') WHERE %2 = NEW.%2; "
+                                "END").arg(table, cle)
+                     << QString("CREATE TRIGGER IF NOT EXISTS TRG_SUPPRESSION_%1 AFTER DELETE ON %1 "
+                                "FOR EACH ROW BEGIN "
+                                "INSERT INTO SUPPRESSIONS (NOM_TABLE, ID_LIGNE) VALUES ('%1', OLD.%2); "
+                                "END").arg(table, cle)
+                     << QString("INSERT OR IGNORE INTO SESSION_VERSIONS (NOM_TABLE, ID_SESSION, VERSION) "
+                                "VALUES ('%1', 0, 0)").arg(table);
+        for (const QString& evenement : {QString("INSERT"), QString("UPDATE"), QString("DELETE")}) {
+            instructions << QString("CREATE TRIGGER IF NOT EXISTS TRG_VERSION_%1_%2 AFTER %2 ON %1 BEGIN "
+                                    "UPDATE SESSION_VERSIONS SET VERSION = VERSION + 1 "
+                                    "WHERE NOM_TABLE = '%1' AND ID_SESSION = 0; "
+                                    "END").arg(table, evenement);
+        }
+    }
+    
+    QSqlQuery query(database);
+    for (const QString& instruction : instructions) {
+        if (!query.exec(instruction)) {
+            showDatabaseError("Erreur de création du schéma SQLite:\n" + query.lastError().text());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::lireVersionsTables(QHash<QString, qint64>& versions)
+{
+    // Requête directe : un échec ne doit pas ouvrir de boîte de dialogue
+    // à chaque passage du minuteur
+    QSqlQuery query(connexion());
+    if (!query.exec("SELECT NOM_TABLE, SUM(VERSION) FROM SESSION_VERSIONS GROUP BY NOM_TABLE")) {
+        return false;
+    }
+    while (query.next()) {
+        versions.insert(query.value(0).toString(), query.value(1).toLongLong());
+    }
+    return true;
+}
+
+QDateTime DatabaseManager::currentServerTime()
+{
+    // Même horloge que les triggers UPDATED_AT / DELETED_AT
+    QSqlQuery query(connexion());
+    // Format ISO (séparateur T) sur SQLite, lu sans ambiguïté par QDateTime
+    const QString maintenant = isSqlite() ? "SELECT strftime('%Y-%m-%dT%H:%M:%S', 'now', 'localtime')"
+                                          : "SELECT SYSDATE FROM DUAL";
+    if (query.exec(maintenant) && query.next()) {
+        return query.value(0).toDateTime();
+    }
+    return QDateTime();
+}
+
+bool DatabaseManager::updateForeignKeyConstraints()
 {
     qDebug() << "Mise à jour des contraintes de clé étrangère pour CASCADE...";
     
     // Vérifier si la contrainte actuelle existe et la supprimer si nécessaire
-    QSqlQuery checkConstraint(database);
-    checkConstraint.exec("SELECT constraint_name FROM user_constraints WHERE table_name = 'COMMANDES' AND constraint_type = 'R'");
+    QSqlQuery checkConstraint(connexion());
+    if (!checkConstraint.exec("SELECT constraint_name FROM user_constraints WHERE table_name = 'COMMANDES' AND constraint_type = 'R'")) {
+        qDebug() << "Erreur lecture des contraintes:" << checkConstraint.lastError().text();
+        return false;
+    }
     
     QStringList constraintsToUpdate;
     while (checkConstraint.next()) {
@@ -298,17 +982,18 @@ void DatabaseManager::updateForeignKeyConstraints()
     
     // Supprimer TOUTES les anciennes contraintes de clé étrangère
     for (const QString& constraintName : constraintsToUpdate) {
-        QSqlQuery dropConstraint(database);
+        QSqlQuery dropConstraint(connexion());
         QString dropQuery = QString("ALTER TABLE COMMANDES DROP CONSTRAINT %1").arg(constraintName);
         if (dropConstraint.exec(dropQuery)) {
             qDebug() << "Ancienne contrainte supprimée:" << constraintName;
         } else {
             qDebug() << "Erreur suppression contrainte:" << dropConstraint.lastError().text();
+            return false;
         }
     }
     
     // Ajouter la nouvelle contrainte CASCADE
-    QSqlQuery addConstraint(database);
+    QSqlQuery addConstraint(connexion());
     QString addConstraintQuery = R"(
         ALTER TABLE COMMANDES 
         ADD CONSTRAINT FK_COMMANDES_LIVREUR_CASCADE 
@@ -319,14 +1004,13 @@ void DatabaseManager::updateForeignKeyConstraints()
         qDebug() << "Nouvelle contrainte CASCADE ajoutée avec succès";
     } else {
         QString error = addConstraint.lastError().text();
-        if (error.contains("name is already used by an existing object") || 
-            error.contains("ORA-00955")) {
+        if (dejaPresent(addConstraint)) {
             qDebug() << "Contrainte CASCADE existe déjà - OK";
         } else {
             qDebug() << "Erreur ajout contrainte CASCADE:" << error;
             
             // Si échec, essayer avec un nom différent
-            QSqlQuery addConstraint2(database);
+            QSqlQuery addConstraint2(connexion());
             QString addConstraintQuery2 = R"(
                 ALTER TABLE COMMANDES 
                 ADD CONSTRAINT FK_COMM_LIVR_CASCADE 
@@ -337,9 +1021,11 @@ void DatabaseManager::updateForeignKeyConstraints()
                 qDebug() << "Contrainte CASCADE ajoutée avec nom alternatif";
             } else {
                 qDebug() << "Échec total ajout contrainte CASCADE:" << addConstraint2.lastError().text();
+                return false;
             }
         }
     }
+    return true;
 }
 
 bool DatabaseManager::insertSampleData()
@@ -353,45 +1039,20 @@ bool DatabaseManager::insertSampleData()
     }
     
     qDebug() << "Insertion de données de test...";
-    
-    // Insérer des livreurs de test avec TOUS les champs
-    QStringList livreursData = {
-        "INSERT INTO LIVREURS (NOM, TELEPHONE, ZONE_LIVRAISON, VEHICULE, DISPONIBILITE) VALUES ('Ahmed Ben Ali', '22123456', 'Tunis Centre', 'Moto Yamaha', 1)",
-        "INSERT INTO LIVREURS (NOM, TELEPHONE, ZONE_LIVRAISON, VEHICULE, DISPONIBILITE) VALUES ('Fatma Khalil', '98765432', 'Ariana', 'Voiture Peugeot', 1)",
-        "INSERT INTO LIVREURS (NOM, TELEPHONE, ZONE_LIVRAISON, VEHICULE, DISPONIBILITE) VALUES ('Mohamed Sassi', '55666777', 'Sfax Nord', 'Camionnette', 0)",
-        "INSERT INTO LIVREURS (NOM, TELEPHONE, ZONE_LIVRAISON, VEHICULE, DISPONIBILITE) VALUES ('Leila Trabelsi', '20304050', 'Sousse Centre', 'Moto Honda', 1)",
-        "INSERT INTO LIVREURS (NOM, TELEPHONE, ZONE_LIVRAISON, VEHICULE, DISPONIBILITE) VALUES ('Karim Mansouri', '70809090', 'Monastir', 'Voiture Renault', 1)"
-    };
-    
-    for (const QString& livreurQuery : livreursData) {
-        QSqlQuery query(database);
-        if (!query.exec(livreurQuery)) {
-            qDebug() << "Erreur insertion livreur:" << query.lastError().text();
-            return false;
-        }
-        qDebug() << "Livreur inséré avec succès";
-    }
-    
-    // Insérer des commandes de test
-    QStringList commandesData = {
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE-5, 'Livree', 'Tunis', 1001, 1)",
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE-3, 'En cours', 'Ariana', 1002, 2)",
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE-10, 'En cours', 'Sfax', 1003, 3)",
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE-1, 'En attente', 'Sousse', 1004, NULL)",
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE-2, 'En cours', 'Monastir', 1005, 5)",
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE, 'En attente', 'Tunis', 1006, NULL)",
-        "INSERT INTO COMMANDES (DATE_COMMANDE, STATUT, VILLE_LIVRAISON, ID_CLIENT, ID_LIVREUR) VALUES (SYSDATE-7, 'Livree', 'Gabes', 1007, 4)"
-    };
-    
-    for (const QString& commandeQuery : commandesData) {
-        QSqlQuery query(database);
-        if (!query.exec(commandeQuery)) {
-            qDebug() << "Erreur insertion commande:" << query.lastError().text();
-            return false;
-        }
-        qDebug() << "Commande insérée avec succès";
+
+    // Petit jeu reproductible ; les volumes de charge passent par le même générateur
+    ParametresGeneration parametres;
+    parametres.livreurs = 5;
+    parametres.commandes = 50;
+    parametres.debut = QDate::currentDate().addDays(-14);
+    parametres.fin = QDate::currentDate();
+
+    GenerateurDonnees generateur(parametres);
+    if (!generateur.generer().succes) {
+        qDebug() << "Erreur lors de l'insertion des données de test";
+        return false;
     }
-    
+
     qDebug() << "Données de test insérées avec succès";
     return true;
 }
@@ -405,12 +1066,13 @@ void DatabaseManager::initializeDatabaseWithSampleData()
     }
 }
 
-void DatabaseManager::forceUpdateConstraints()
+bool DatabaseManager::forceUpdateConstraints()
 {
     if (isConnected()) {
         qDebug() << "Forçage de la mise à jour des contraintes...";
-        updateForeignKeyConstraints();
+        return updateForeignKeyConstraints();
     } else {
         qDebug() << "Base de données non connectée, impossible de mettre à jour les contraintes";
+        return false;
     }
 }
@@ -6,8 +6,10 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QDateTime>
 #include <QDebug>
-#include <QMessageBox>
 
 class DatabaseManager : public QObject
 {
@@ -23,12 +25,42 @@ public:
     static DatabaseManager* getInstance();
     ~DatabaseManager();
     
+    // configurer, ouvrirConnexion puis verifierSchema
     bool connectToDatabase();
+    // Paramètres de la connexion principale, sans l'ouvrir
+    void configurer();
+    bool ouvrirConnexion();
+    // Version du schéma relue (une requête) et migrations appliquées si
+    // elle est en retard ; depuis n'importe quel fil, connexion de ce fil
+    bool verifierSchema();
+    // Base SQLite locale de substitution (bancs d'essai, jeux de données) :
+    // même schéma logique, sans triggers ni journal des suppressions
+    bool connectToSqlite(const QString& cheminFichier);
+    bool isSqlite() const { return database.driverName() == "QSQLITE"; }
+    // Base désignée (pilote, utilisateur, hôte, port, nom) : clé des caches locaux
+    QString identifiantBase() const;
     void disconnectFromDatabase();
     bool isConnected();
     
+    // Utilisables depuis n'importe quel fil : hors du fil de l'application,
+    // chaque fil a sa propre connexion (lectures en arrière-plan). Les
+    // transactions ne portent que sur la connexion principale.
     QSqlQuery executeQuery(const QString& queryString);
     QSqlQuery executePreparedQuery(const QString& queryString, const QVariantList& values = QVariantList());
+    QSqlQuery executeBatchQuery(const QString& queryString, const QList<QVariantList>& colonnes);
+    
+    // Insertion renvoyant les colonnes générées (identité, valeurs par défaut)
+    // sans relecture : RETURNING ... INTO sous Oracle, last_insert_rowid()
+    // sous SQLite. modeles fixe le type de chaque valeur renvoyée (entier par
+    // défaut). Liste vide en cas d'échec.
+    QVariantList executeInsertReturning(const QString& insertString, const QVariantList& values,
+                                        const QStringList& colonnesRetour,
+                                        const QVariantList& modeles = QVariantList());
+    // Variante par lot : une liste de valeurs (une par ligne) par colonne renvoyée
+    QList<QVariantList> executeBatchInsertReturning(const QString& insertString,
+                                                    const QList<QVariantList>& colonnes,
+                                                    const QStringList& colonnesRetour,
+                                                    const QVariantList& modeles = QVariantList());
     
     bool beginTransaction();
     bool commitTransaction();
@@ -36,17 +68,46 @@ public:
     
     QString getLastError();
     
+    // Suivi des modifications (filigranes UPDATED_AT)
+    QDateTime currentServerTime();
+    // Version de chaque table (somme des compteurs par session), depuis
+    // n'importe quel fil ; false sans dialogue si la lecture échoue
+    bool lireVersionsTables(QHash<QString, qint64>& versions);
+    // Chevauchement entre deux lectures : une transaction validée après la
+    // lecture précédente peut porter un UPDATED_AT antérieur au filigrane
+    static constexpr int WATERMARK_MARGIN_SECS = 60;
+    static constexpr int DELETION_RETENTION_DAYS = 7;
+    // Dernière migration du schéma Oracle (table SCHEMA_VERSION)
+    static constexpr int SCHEMA_VERSION = 7;
+    
     // Database initialization
     bool createTables();
     bool insertSampleData();
     bool checkTablesExist();
     void initializeDatabaseWithSampleData(); // Méthode pour initialiser avec des données si vide
-    void forceUpdateConstraints(); // Forcer la mise à jour des contraintes
+    bool forceUpdateConstraints(); // Forcer la mise à jour des contraintes
+    // Journal des suppressions au-delà de la rétention (maintenance planifiée)
+    bool purgerSuppressions();
+    
+signals:
+    // Erreurs toujours journalisées ; l'interface les affiche en s'y connectant
+    void databaseError(const QString& message);
     
 private:
+    QSqlDatabase connexion();
+    bool versionSchema(int& version);
+    bool appliquerMigration(int version);
+    static QString descriptionMigration(int version);
     void showDatabaseError(const QString& error);
-    void createIndexes();
-    void updateForeignKeyConstraints();
+    bool createIndexes();
+    bool updateForeignKeyConstraints();
+    bool addTimestampColumns();
+    bool createOrderEventsTable();
+    bool createVersionTracking();
+    bool createChangeTracking();
+    bool createSessionVersionTracking();
+    bool createOrderEventsDateIndex();
+    bool createSqliteSchema();
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,213 @@
+#include "GenerateurDonnees.h"
+#include "DatabaseManager.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+const QStringList PRENOMS = {"Ahmed", "Fatma", "Mohamed", "Leila", "Karim", "Amira", "Youssef",
+                             "Sana", "Walid", "Ines", "Hichem", "Nour", "Sami", "Rania"};
+const QStringList NOMS = {"Ben Ali", "Khalil", "Sassi", "Trabelsi", "Mansouri", "Jaziri",
+                          "Gharbi", "Hammami", "Bouazizi", "Chaabane", "Dridi", "Mejri"};
+const QStringList SECTEURS = {"Centre", "Nord", "Sud"};
+const QStringList VEHICULES = {"Velo", "Moto Yamaha", "Moto Honda", "Voiture Peugeot",
+                               "Voiture Renault", "Camionnette"};
+
+// Entier dans [0, n) : multiplication puis décalage sur 32 bits
+int tirerEntier(std::mt19937& generateur, int n)
+{
+    return static_cast<int>((quint64(generateur()) * quint64(n)) >> 32);
+}
+
+// Réel dans [0, 1) à partir d'un seul tirage de 32 bits
+double tirerReel(std::mt19937& generateur)
+{
+    return generateur() / 4294967296.0;
+}
+
+// Loi discrète par inversion de la fonction de répartition
+class LoiDiscrete
+{
+public:
+    explicit LoiDiscrete(const std::vector<double>& poids)
+    {
+        double total = 0.0;
+        for (double p : poids) {
+            total += std::max(0.0, p);
+            cumuls.push_back(total);
+        }
+    }
+
+    int tirer(std::mt19937& generateur) const
+    {
+        const double u = tirerReel(generateur) * cumuls.back();
+        const auto it = std::upper_bound(cumuls.begin(), cumuls.end(), u);
+        return std::min<int>(int(it - cumuls.begin()), int(cumuls.size()) - 1);
+    }
+
+private:
+    std::vector<double> cumuls;
+};
+
+// Loi de Zipf sur n rangs : poids 1 / (k + 1)^s
+LoiDiscrete loiZipf(int n, double s)
+{
+    std::vector<double> poids(n);
+    for (int k = 0; k < n; ++k) {
+        poids[k] = 1.0 / std::pow(k + 1, s);
+    }
+    return LoiDiscrete(poids);
+}
+
+}
+
+GenerateurDonnees::GenerateurDonnees(const ParametresGeneration& parametres)
+    : parametres(parametres)
+{
+}
+
+RapportGeneration GenerateurDonnees::generer()
+{
+    RapportGeneration rapport;
+    QElapsedTimer chrono;
+    chrono.start();
+
+    DatabaseManager* db = DatabaseManager::getInstance();
+    const ParametresGeneration& p = parametres;
+    if (p.villes.isEmpty() || p.statuts.isEmpty() || p.livreurs <= 0) {
+        return rapport;
+    }
+
+    std::mt19937 generateur(p.graine);
+    auto tirer = [&generateur](int n) { return tirerEntier(generateur, n); };
+    auto probabilite = [&generateur](double q) { return tirerReel(generateur) < q; };
+    const LoiDiscrete loiVille = loiZipf(p.villes.size(), p.asymetrieVilles);
+    auto villeZipf = [&generateur, &loiVille] { return loiVille.tirer(generateur); };
+
+    const QStringList statuts = p.statuts.keys();
+    const LoiDiscrete loiStatut(std::vector<double>(p.statuts.begin(), p.statuts.end()));
+
+    // Livreurs : identifiants renvoyés par l'insertion pour les affectations
+    QVariantList noms, telephones, zones, vehicules, disponibilites;
+    QList<int> villesLivreurs;
+    for (int i = 0; i < p.livreurs; ++i) {
+        const int ville = villeZipf();
+        villesLivreurs << ville;
+        noms << PRENOMS[tirer(PRENOMS.size())] + " " + NOMS[tirer(NOMS.size())];
+        telephones << QString::number(20000000 + tirer(80000000));
+        zones << p.villes[ville] + " " + SECTEURS[tirer(SECTEURS.size())];
+        vehicules << VEHICULES[tirer(VEHICULES.size())];
+        disponibilites << (probabilite(p.partDisponibles) ? 1 : 0);
+    }
+
+    if (!db->beginTransaction()) {
+        return rapport;
+    }
+    const QList<QVariantList> generes = db->executeBatchInsertReturning(
+        "INSERT INTO LIVREURS (nom, telephone, zone_livraison, vehicule, disponibilite) VALUES (?, ?, ?, ?, ?)",
+        {noms, telephones, zones, vehicules, disponibilites}, {"id_livreur"});
+    if (generes.isEmpty() || generes.first().size() != p.livreurs || !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return rapport;
+    }
+    rapport.livreurs = p.livreurs;
+
+    // Livreurs par ville : une commande va de préférence à un livreur local
+    QHash<int, std::vector<int>> livreursParVille;
+    std::vector<int> tousLivreurs;
+    for (int i = 0; i < p.livreurs; ++i) {
+        const int id = generes.first()[i].toInt();
+        livreursParVille[villesLivreurs[i]].push_back(id);
+        tousLivreurs.push_back(id);
+    }
+
+    const int joursPeriode = std::max<qint64>(1, p.debut.daysTo(p.fin) + 1);
+    // Pas de date future : bornée à la fin de la période, ou à l'instant
+    // présent si elle n'est pas encore écoulée
+    const QDateTime maintenant = std::min(p.fin.addDays(1).startOfDay().addSecs(-1),
+                                          QDateTime::currentDateTime());
+    const QString insertion = "INSERT INTO COMMANDES (date_commande, statut, ville_livraison, id_client, "
+                              "id_livreur, assigned_at, delivered_at) VALUES (?, ?, ?, ?, ?, ?, ?)";
+    // Événements CREATION : les clients ouverts suivent COMMANDES par le journal
+    const QString journal = "INSERT INTO ORDER_EVENTS (id_commande, type_evenement, statut, id_livreur, "
+                            "ville_livraison, date_commande, id_client) VALUES (?, 'CREATION', ?, ?, ?, ?, ?)";
+
+    const int tailleLot = std::max(1, p.tailleLot);
+    for (int debutLot = 0; debutLot < p.commandes; debutLot += tailleLot) {
+        const int finLot = std::min(p.commandes, debutLot + tailleLot);
+        QVariantList dates, statutsLot, villes, clients, livreurs, affectations, livraisons;
+
+        for (int i = debutLot; i < finLot; ++i) {
+            const int ville = villeZipf();
+            const QDate date = p.debut.addDays(tirer(joursPeriode));
+            const QString statut = statuts[loiStatut.tirer(generateur)];
+
+            // Affectation : commandes en cours et livrées, la moitié des annulées
+            const bool affectee = statut == "En cours" || statut == "Livree" ||
+                                  (statut == "Annulee" && probabilite(0.5));
+            // Nulls typés : le type de chaque colonne du lot reste homogène
+            QVariant livreur(QMetaType::fromType<int>());
+            QVariant affectation(QMetaType::fromType<QDateTime>());
+            QVariant livraison(QMetaType::fromType<QDateTime>());
+            if (affectee) {
+                auto locaux = livreursParVille.constFind(ville);
+                const std::vector<int>& candidats =
+                    (locaux != livreursParVille.constEnd() && probabilite(0.8)) ? *locaux : tousLivreurs;
+                livreur = candidats[tirer(int(candidats.size()))];
+
+                QDateTime dateAffectation = date.startOfDay().addSecs(8 * 3600 + tirer(12 * 3600));
+                if (dateAffectation > maintenant) {
+                    dateAffectation = maintenant;
+                }
+                affectation = dateAffectation;
+
+                if (statut == "Livree") {
+                    QDateTime dateLivraison = dateAffectation.addSecs(
+                        3600 + qint64(tirer(std::max(1, p.delaiLivraisonMaxJours) * 24)) * 3600);
+                    if (dateLivraison > maintenant) {
+                        dateLivraison = maintenant;
+                    }
+                    livraison = dateLivraison;
+                }
+            }
+
+            dates << date;
+            statutsLot << statut;
+            villes << p.villes[ville];
+            clients << 1000 + tirer(std::max(1, p.clients));
+            livreurs << livreur;
+            affectations << affectation;
+            livraisons << livraison;
+        }
+
+        // Une transaction par lot : volume d'annulation borné, commandes et
+        // événements validés ensemble
+        if (!db->beginTransaction()) {
+            return rapport;
+        }
+        const QList<QVariantList> ids = db->executeBatchInsertReturning(insertion,
+            {dates, statutsLot, villes, clients, livreurs, affectations, livraisons}, {"id_commande"});
+        if (ids.isEmpty() || ids.first().size() != finLot - debutLot) {
+            db->rollbackTransaction();
+            return rapport;
+        }
+        QSqlQuery evenements = db->executeBatchQuery(journal,
+            {ids.first(), statutsLot, livreurs, villes, dates, clients});
+        if (evenements.lastError().isValid() || !db->commitTransaction()) {
+            db->rollbackTransaction();
+            return rapport;
+        }
+
+        rapport.commandes = finLot;
+        qDebug() << "Commandes générées:" << rapport.commandes << "/" << p.commandes;
+    }
+
+    rapport.succes = true;
+    rapport.dureeMs = chrono.elapsed();
+    return rapport;
+}
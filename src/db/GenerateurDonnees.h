@@ -0,0 +1,63 @@
+#ifndef GENERATEURDONNEES_H
+#define GENERATEURDONNEES_H
+
+#include <QDate>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+// Paramètres d'un jeu de données synthétique
+struct ParametresGeneration
+{
+    int livreurs = 100;
+    int commandes = 10000;
+    quint32 graine = 42;                 // même graine, mêmes données
+
+    // Villes par popularité décroissante ; poids du rang k en 1 / k^s
+    QStringList villes = {"Tunis", "Sfax", "Sousse", "Ariana", "Monastir", "Bizerte",
+                          "Nabeul", "Kairouan", "Gabes", "Gafsa"};
+    double asymetrieVilles = 1.0;        // s = 0 : répartition uniforme
+
+    // Proportions relatives des statuts
+    QMap<QString, double> statuts = {{"En attente", 0.15}, {"En cours", 0.25},
+                                     {"Livree", 0.55}, {"Annulee", 0.05}};
+
+    // Période fixe : une même graine donne les mêmes données quel que soit
+    // le jour de la génération
+    QDate debut = QDate(2024, 1, 1);
+    QDate fin = QDate(2024, 6, 29);
+    double partDisponibles = 0.8;        // livreurs disponibles
+    int delaiLivraisonMaxJours = 10;
+    int clients = 50000;
+
+    int tailleLot = 50000;               // lignes par lot et par transaction
+};
+
+// Bilan d'une génération
+struct RapportGeneration
+{
+    bool succes = false;
+    int livreurs = 0;
+    int commandes = 0;
+    qint64 dureeMs = 0;
+};
+
+// Génération déterministe de livreurs et de commandes réalistes : villes et
+// zones selon une loi de Zipf, mélange de statuts, dates de commande,
+// d'affectation et de livraison cohérentes. Tirages faits ici à partir de
+// la suite mt19937 (spécifiée par la norme), sans les lois std:: dont
+// l'algorithme varie d'une bibliothèque standard à l'autre. Chargement en
+// masse par liaison de tableaux (un aller-retour par lot sous Oracle), une
+// transaction par lot pour les commandes et leurs événements CREATION.
+class GenerateurDonnees
+{
+public:
+    explicit GenerateurDonnees(const ParametresGeneration& parametres = ParametresGeneration());
+
+    RapportGeneration generer();
+
+private:
+    ParametresGeneration parametres;
+};
+
+#endif // GENERATEURDONNEES_H
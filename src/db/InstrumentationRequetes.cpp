@@ -0,0 +1,364 @@
+#include "InstrumentationRequetes.h"
+#include <QSettings>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QSqlRecord>
+#include <algorithm>
+
+InstrumentationRequetes* InstrumentationRequetes::instance = nullptr;
+
+namespace {
+
+// Lecture en cours sur ce fil : les lignes converties par les services lui
+// sont attribuées jusqu'à l'exécution suivante
+struct LectureEnCours
+{
+    QString cle;
+    qint64 lignes = 0;
+    qint64 octets = 0;
+    qint64 tailleLigne = 0;      // dernière taille mesurée
+};
+
+thread_local LectureEnCours lectureEnCours;
+
+}
+
+double StatistiquesRequete::centileMs(double q) const
+{
+    // Borne supérieure de la classe qui contient le centile demandé
+    const qint64 rang = qint64(q * appels);
+    qint64 cumul = 0;
+    for (size_t i = 0; i < BORNES_LATENCE_MS.size(); ++i) {
+        cumul += histogramme[i];
+        if (cumul > rang) {
+            return BORNES_LATENCE_MS[i];
+        }
+    }
+    return dureeMaxNs / 1e6;
+}
+
+InstrumentationRequetes::InstrumentationRequetes()
+    : appelsCumules(0)
+    , dureeCumuleeNs(0)
+{
+    QSettings settings;
+    settings.beginGroup("Instrumentation");
+    active = settings.value("active", true).toBool();
+    seuilLent = settings.value("seuilLentMs", 200).toInt();
+    tailleMaxJournal = settings.value("tailleJournalKo", 1024).toLongLong() * 1024;
+    settings.endGroup();
+
+    const QString repertoire = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (!repertoire.isEmpty() && QDir().mkpath(repertoire)) {
+        journal = repertoire + "/requetes_lentes.log";
+    }
+}
+
+InstrumentationRequetes* InstrumentationRequetes::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new InstrumentationRequetes();
+    }
+    return instance;
+}
+
+void InstrumentationRequetes::definirActive(bool actif)
+{
+    active = actif;
+    QSettings().setValue("Instrumentation/active", actif);
+}
+
+void InstrumentationRequetes::definirSeuilLent(int millisecondes)
+{
+    seuilLent = millisecondes;
+    QSettings().setValue("Instrumentation/seuilLentMs", millisecondes);
+}
+
+QString InstrumentationRequetes::normaliser(const QString& sql)
+{
+    static const QRegularExpression litteraux("'(?:[^']|'')*'");
+    static const QRegularExpression parametresNommes(":\\w+");
+    static const QRegularExpression nombres("\\b\\d+(?:\\.\\d+)?\\b");
+    static const QRegularExpression espaces("\\s+");
+    static const QRegularExpression listesIn("\\bIN\\s*\\(\\s*\\?(?:\\s*,\\s*\\?)*\\s*\\)",
+                                             QRegularExpression::CaseInsensitiveOption);
+
+    QString texte = sql;
+    texte.replace(litteraux, "?");
+    texte.replace(parametresNommes, "?");
+    texte.replace(nombres, "?");
+    texte.replace(espaces, " ");
+    // Listes IN découpées par paquets : une seule entrée quel que soit leur nombre
+    texte.replace(listesIn, "IN (?...)");
+    return texte.trimmed();
+}
+
+QString InstrumentationRequetes::cle(const QString& sql)
+{
+    // Les textes exécutés sont presque toujours les mêmes : normalisation mise en cache
+    auto it = clesConnues.constFind(sql);
+    if (it != clesConnues.constEnd()) {
+        return it.value();
+    }
+    if (clesConnues.size() >= CLES_CONSERVEES) {
+        clesConnues.clear();
+    }
+    const QString normalise = normaliser(sql);
+    clesConnues.insert(sql, normalise);
+    return normalise;
+}
+
+qint64 InstrumentationRequetes::taille(const QVariant& valeur)
+{
+    if (valeur.isNull()) {
+        return 0;
+    }
+    switch (valeur.typeId()) {
+    case QMetaType::QString:
+        return valeur.toString().size();
+    case QMetaType::QByteArray:
+        return valeur.toByteArray().size();
+    case QMetaType::QVariantList: {
+        qint64 total = 0;
+        for (const QVariant& element : valeur.toList()) {
+            total += taille(element);
+        }
+        return total;
+    }
+    case QMetaType::Bool:
+        return 1;
+    default:
+        return 8;                // nombres, dates
+    }
+}
+
+QString InstrumentationRequetes::decrire(const QVariantList& valeurs)
+{
+    QStringList textes;
+    for (const QVariant& valeur : valeurs) {
+        if (textes.size() == 20) {
+            textes << "...";
+            break;
+        }
+        if (valeur.typeId() == QMetaType::QVariantList) {
+            textes << QString("<lot de %1 lignes>").arg(valeur.toList().size());
+        } else if (valeur.isNull()) {
+            textes << "NULL";
+        } else if (valeur.typeId() == QMetaType::QString) {
+            QString texte = valeur.toString();
+            if (texte.size() > 80) {
+                texte = texte.left(80) + "...";
+            }
+            textes << "'" + texte + "'";
+        } else {
+            textes << valeur.toString();
+        }
+    }
+    return textes.join(", ");
+}
+
+void InstrumentationRequetes::reporterLignes()
+{
+    if (lectureEnCours.lignes > 0 && !lectureEnCours.cle.isEmpty()) {
+        auto it = statistiques.find(lectureEnCours.cle);
+        if (it != statistiques.end()) {
+            it->lignes += lectureEnCours.lignes;
+            it->octets += lectureEnCours.octets;
+        }
+    }
+    lectureEnCours.lignes = 0;
+    lectureEnCours.octets = 0;
+}
+
+void InstrumentationRequetes::enregistrer(const QString& sql, qint64 dureeNs, const QSqlQuery& query,
+                                          bool succes, const QVariantList& valeurs)
+{
+    enCours.fetchAndSubRelaxed(1);
+    if (!active) {
+        return;
+    }
+
+    qint64 envoyes = 0;
+    for (const QVariant& valeur : valeurs) {
+        envoyes += taille(valeur);
+    }
+    const double dureeMs = dureeNs / 1e6;
+
+    QMutexLocker verrouillage(&verrou);
+    reporterLignes();
+    ++appelsCumules;
+    dureeCumuleeNs += dureeNs;
+
+    const QString normalise = cle(sql);
+    StatistiquesRequete& stats = statistiques[normalise];
+    if (stats.sql.isEmpty()) {
+        stats.sql = normalise;
+    }
+    ++stats.appels;
+    if (!succes) {
+        ++stats.erreurs;
+    }
+    stats.dureeTotaleNs += dureeNs;
+    stats.dureeMaxNs = std::max(stats.dureeMaxNs, dureeNs);
+    stats.octets += envoyes;
+
+    const auto classe = std::lower_bound(BORNES_LATENCE_MS.begin(), BORNES_LATENCE_MS.end(), dureeMs);
+    ++stats.histogramme[classe - BORNES_LATENCE_MS.begin()];
+
+    // Lecture : lignes comptées au fil de leur conversion ; écriture : lignes touchées
+    if (succes && query.isSelect()) {
+        lectureEnCours.cle = normalise;
+        lectureEnCours.tailleLigne = 0;
+    } else {
+        lectureEnCours.cle.clear();
+        const int touchees = succes ? query.numRowsAffected() : 0;
+        if (touchees > 0) {
+            stats.lignes += touchees;
+        }
+    }
+
+    if (seuilLent >= 0 && dureeMs >= seuilLent) {
+        RequeteLente lente;
+        lente.date = QDateTime::currentDateTime();
+        lente.dureeMs = dureeMs;
+        lente.sql = sql.simplified();
+        lente.valeurs = decrire(valeurs);
+
+        lentes.append(lente);
+        if (lentes.size() > LENTES_CONSERVEES) {
+            lentes.removeFirst();
+        }
+
+        ecrireJournal(QString("%1 | %2 ms | %3 | %4 | [%5]")
+                      .arg(lente.date.toString(Qt::ISODateWithMs))
+                      .arg(dureeMs, 0, 'f', 1)
+                      .arg(QString(succes ? "ok" : "erreur"), lente.sql, lente.valeurs));
+    }
+}
+
+void InstrumentationRequetes::ligneLue(const QSqlQuery& query)
+{
+    if (!active) {
+        return;
+    }
+
+    // Taille mesurée sur une ligne de temps en temps, reportée sur les suivantes
+    if (lectureEnCours.lignes % ECHANTILLON_OCTETS == 0) {
+        const QSqlRecord enregistrement = query.record();
+        qint64 octets = 0;
+        for (int i = 0; i < enregistrement.count(); ++i) {
+            octets += taille(enregistrement.value(i));
+        }
+        lectureEnCours.tailleLigne = octets;
+    }
+    ++lectureEnCours.lignes;
+    lectureEnCours.octets += lectureEnCours.tailleLigne;
+}
+
+QList<StatistiquesRequete> InstrumentationRequetes::plusCouteuses(int n, Critere critere)
+{
+    QList<StatistiquesRequete> liste;
+    {
+        QMutexLocker verrouillage(&verrou);
+        reporterLignes();
+        liste = statistiques.values();
+    }
+
+    auto mesure = [critere](const StatistiquesRequete& stats) -> qint64 {
+        switch (critere) {
+        case DureeMax: return stats.dureeMaxNs;
+        case Appels: return stats.appels;
+        case Lignes: return stats.lignes;
+        case Octets: return stats.octets;
+        default: return stats.dureeTotaleNs;
+        }
+    };
+    std::sort(liste.begin(), liste.end(), [&mesure](const StatistiquesRequete& a, const StatistiquesRequete& b) {
+        return mesure(a) > mesure(b);
+    });
+    return liste.mid(0, n);
+}
+
+QList<RequeteLente> InstrumentationRequetes::dernieresLentes(int n) const
+{
+    QMutexLocker verrouillage(&verrou);
+    return lentes.mid(std::max<qsizetype>(0, lentes.size() - n));
+}
+
+qint64 InstrumentationRequetes::totalAppels() const
+{
+    QMutexLocker verrouillage(&verrou);
+    return appelsCumules;
+}
+
+qint64 InstrumentationRequetes::totalDureeNs() const
+{
+    QMutexLocker verrouillage(&verrou);
+    return dureeCumuleeNs;
+}
+
+QString InstrumentationRequetes::rapport(int n)
+{
+    QString texte;
+    QTextStream flux(&texte);
+    flux << "Requêtes les plus coûteuses (durée totale) au "
+         << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+    flux << QString("%1 %2 %3 %4 %5 %6 %7  %8\n")
+            .arg("appels", 8).arg("total ms", 10).arg("moy ms", 8).arg("p95 ms", 8)
+            .arg("max ms", 8).arg("lignes", 10).arg("octets", 12).arg("sql");
+
+    for (const StatistiquesRequete& stats : plusCouteuses(n)) {
+        flux << QString("%1 %2 %3 %4 %5 %6 %7  %8\n")
+                .arg(stats.appels, 8)
+                .arg(stats.dureeTotaleNs / 1e6, 10, 'f', 1)
+                .arg(stats.dureeMoyenneMs(), 8, 'f', 2)
+                .arg(stats.centileMs(0.95), 8, 'f', 1)
+                .arg(stats.dureeMaxNs / 1e6, 8, 'f', 1)
+                .arg(stats.lignes, 10)
+                .arg(stats.octets, 12)
+                .arg(stats.sql);
+    }
+    return texte;
+}
+
+void InstrumentationRequetes::ecrireRapport(int n)
+{
+    if (!active) {
+        return;
+    }
+    const QString texte = rapport(n);
+    QMutexLocker verrouillage(&verrou);
+    ecrireJournal(texte.trimmed());
+}
+
+void InstrumentationRequetes::reinitialiser()
+{
+    QMutexLocker verrouillage(&verrou);
+    statistiques.clear();
+    lentes.clear();
+    lectureEnCours = LectureEnCours();
+}
+
+void InstrumentationRequetes::ecrireJournal(const QString& texte)
+{
+    if (journal.isEmpty()) {
+        return;
+    }
+
+    // Rotation : requetes_lentes.log -> .1 -> .2 -> .3 (supprimé)
+    if (QFile(journal).size() >= tailleMaxJournal) {
+        QFile::remove(QString("%1.%2").arg(journal).arg(ARCHIVES_JOURNAL));
+        for (int i = ARCHIVES_JOURNAL - 1; i >= 1; --i) {
+            QFile::rename(QString("%1.%2").arg(journal).arg(i), QString("%1.%2").arg(journal).arg(i + 1));
+        }
+        QFile::rename(journal, journal + ".1");
+    }
+
+    QFile fichier(journal);
+    if (fichier.open(QIODevice::Append | QIODevice::Text)) {
+        QTextStream(&fichier) << texte << "\n";
+    }
+}
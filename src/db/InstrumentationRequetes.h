@@ -0,0 +1,122 @@
+#ifndef INSTRUMENTATIONREQUETES_H
+#define INSTRUMENTATIONREQUETES_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QSqlQuery>
+#include <array>
+
+// Bornes supérieures (ms) des classes de l'histogramme des latences ;
+// la dernière classe reçoit tout ce qui dépasse la dernière borne
+constexpr std::array<double, 12> BORNES_LATENCE_MS = {
+    0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000
+};
+
+// Mesures cumulées d'une requête normalisée
+struct StatistiquesRequete
+{
+    QString sql;                 // texte normalisé (littéraux et listes IN remplacés)
+    qint64 appels = 0;
+    qint64 erreurs = 0;
+    qint64 dureeTotaleNs = 0;
+    qint64 dureeMaxNs = 0;
+    qint64 lignes = 0;           // lignes lues (entités construites) ou modifiées
+    qint64 octets = 0;           // paramètres envoyés et lignes lues (estimation)
+    std::array<qint64, BORNES_LATENCE_MS.size() + 1> histogramme = {};
+
+    double dureeMoyenneMs() const { return appels ? dureeTotaleNs / 1e6 / appels : 0.0; }
+    // Centile approché par la borne de sa classe dans l'histogramme
+    double centileMs(double q) const;
+};
+
+// Exécution au-delà du seuil, telle qu'écrite dans le journal des requêtes lentes
+struct RequeteLente
+{
+    QDateTime date;
+    double dureeMs = 0.0;
+    QString sql;                 // texte exécuté, non normalisé
+    QString valeurs;             // paramètres liés, tronqués
+};
+
+// Instrumentation des requêtes passées par DatabaseManager : nombre
+// d'appels, latences (total, max, histogramme), lignes et volume par texte
+// SQL normalisé. Les exécutions plus lentes que le seuil sont écrites avec
+// leurs paramètres dans un journal tournant. Réglages dans les paramètres
+// de l'application (groupe « Instrumentation »).
+class InstrumentationRequetes
+{
+private:
+    static InstrumentationRequetes* instance;
+
+    InstrumentationRequetes();
+
+public:
+    static InstrumentationRequetes* getInstance();
+
+    enum Critere { DureeTotale, DureeMax, Appels, Lignes, Octets };
+
+    bool estActive() const { return active; }
+    void definirActive(bool actif);
+    int seuilLentMs() const { return seuilLent; }
+    void definirSeuilLent(int millisecondes);
+
+    // Exécution commencée ; enregistrer la clôt (requêtes en cours)
+    void demarrer() { enCours.fetchAndAddRelaxed(1); }
+    int requetesEnCours() const { return enCours.loadRelaxed(); }
+    // Une exécution (appelé par DatabaseManager après exec / execBatch)
+    void enregistrer(const QString& sql, qint64 dureeNs, const QSqlQuery& query,
+                     bool succes, const QVariantList& valeurs);
+    // Une ligne convertie par un service : attribuée à la dernière lecture
+    // exécutée sur le même fil
+    void ligneLue(const QSqlQuery& query);
+
+    // Les n requêtes les plus coûteuses selon le critère
+    QList<StatistiquesRequete> plusCouteuses(int n, Critere critere = DureeTotale);
+    QList<RequeteLente> dernieresLentes(int n) const;
+    // Cumuls depuis le démarrage, non remis à zéro : allers-retours et temps
+    // passé en base entre deux instants
+    qint64 totalAppels() const;
+    qint64 totalDureeNs() const;
+    // Tableau texte des n requêtes les plus coûteuses ; ecrireRapport
+    // l'ajoute au journal
+    QString rapport(int n = 20);
+    void ecrireRapport(int n = 20);
+    void reinitialiser();
+
+    QString cheminJournal() const { return journal; }
+
+    static QString normaliser(const QString& sql);
+
+private:
+    void ecrireJournal(const QString& texte);
+    void reporterLignes();
+    QString cle(const QString& sql);
+    static qint64 taille(const QVariant& valeur);
+    static QString decrire(const QVariantList& valeurs);
+
+    bool active;
+    int seuilLent;
+    qint64 tailleMaxJournal;
+    QString journal;
+
+    QAtomicInt enCours;
+    mutable QMutex verrou;
+    qint64 appelsCumules;
+    qint64 dureeCumuleeNs;
+    QHash<QString, StatistiquesRequete> statistiques;
+    QHash<QString, QString> clesConnues;     // texte exécuté -> texte normalisé
+    QList<RequeteLente> lentes;
+
+    static constexpr int ARCHIVES_JOURNAL = 3;
+    static constexpr int LENTES_CONSERVEES = 50;
+    static constexpr int CLES_CONSERVEES = 4096;
+    static constexpr int ECHANTILLON_OCTETS = 32;   // une ligne mesurée sur 32
+};
+
+#endif // INSTRUMENTATIONREQUETES_H
@@ -31,6 +31,14 @@ bool Commande::isValid() const
            date_commande.isValid();
 }
 
+double Commande::delaiLivraisonJours() const
+{
+    if (!date_livraison.isValid() || !date_commande.isValid()) {
+        return -1.0;
+    }
+    return date_commande.startOfDay().secsTo(date_livraison) / 86400.0;
+}
+
 bool Commande::operator==(const Commande& other) const
 {
     return id_commande == other.id_commande;
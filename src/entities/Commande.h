@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QDate>
+#include <QDateTime>
 #include <QList>
 
 class Commande
@@ -14,6 +15,8 @@ private:
     QString ville_livraison;
     int id_client;
     int id_livreur;
+    QDateTime date_affectation;  // passage à un livreur
+    QDateTime date_livraison;    // passage au statut Livree
     
 public:
     // Constructeurs
@@ -28,6 +31,8 @@ public:
     QString getVilleLivraison() const { return ville_livraison; }
     int getIdClient() const { return id_client; }
     int getIdLivreur() const { return id_livreur; }
+    QDateTime getDateAffectation() const { return date_affectation; }
+    QDateTime getDateLivraison() const { return date_livraison; }
     
     // Setters
     void setIdCommande(int id) { id_commande = id; }
@@ -36,10 +41,14 @@ public:
     void setVilleLivraison(const QString& ville) { ville_livraison = ville; }
     void setIdClient(int id) { id_client = id; }
     void setIdLivreur(int id) { id_livreur = id; }
+    void setDateAffectation(const QDateTime& date) { date_affectation = date; }
+    void setDateLivraison(const QDateTime& date) { date_livraison = date; }
     
     // Méthodes utilitaires
     QString toString() const;
     bool isValid() const;
+    // Jours écoulés entre la commande et sa livraison (-1 si non livrée)
+    double delaiLivraisonJours() const;
     
     // Opérateurs
     bool operator==(const Commande& other) const;
@@ -1,33 +1,67 @@
 #include <QApplication>
 #include <QStyleFactory>
 #include <QDir>
+#include <QMessageBox>
 #include "ui/MainWindow.h"
 #include "db/DatabaseManager.h"
+#include "db/InstrumentationRequetes.h"
+#include "utils/Trace.h"
+#include "utils/SurveillantBoucle.h"
+#include "cli/ModeConsole.h"
 
 int main(int argc, char *argv[])
 {
+    // Traitements planifiés (rapports, exports, répartition) sans interface
+    if (ModeConsole::estDemande(argc, argv)) {
+        return ModeConsole::executer(argc, argv);
+    }
+    
     QApplication app(argc, argv);
     
-    // Fix Qt platform plugin path
-    QString appDir = QApplication::applicationDirPath();
-    QApplication::addLibraryPath(appDir);
-    QApplication::addLibraryPath(appDir + "/platforms");
-    QApplication::addLibraryPath(appDir + "/sqldrivers");
+    // Plugins, nom et organisation de l'application (communs au mode console)
+    ModeConsole::configurerApplication();
     
-    // Set application properties
-    app.setApplicationName("Système de Gestion Logistique");
-    app.setApplicationVersion("1.0.0");
-    app.setOrganizationName("Aymen Jallouli");
+    // Trace d'exécution (chrome://tracing) écrite à la fermeture si
+    // LOGISTICS_TRACE donne le fichier de sortie
+    const QString cheminTrace = qEnvironmentVariable("LOGISTICS_TRACE");
+    if (!cheminTrace.isEmpty()) {
+        Trace::demarrer();
+    }
     
     // Set modern style
     app.setStyle(QStyleFactory::create("Fusion"));
     
     // Initialize database connection
     DatabaseManager* dbManager = DatabaseManager::getInstance();
-    if (!dbManager->connectToDatabase()) {
-        return -1;
+    // Contexte &app : les erreurs des lectures en arrière-plan s'affichent sur le fil principal
+    QObject::connect(dbManager, &DatabaseManager::databaseError, &app, [](const QString& message) {
+        QMessageBox::critical(nullptr, "Erreur de base de données", message);
+    });
+    // Paramètres seulement : la fenêtre ouvre la connexion une fois affichée,
+    // le schéma est vérifié en parallèle sur un fil du pool
+    dbManager->configurer();
+    
+    // Bilan des requêtes les plus coûteuses de la session, dans le journal des requêtes lentes
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [] {
+        InstrumentationRequetes::getInstance()->ecrireRapport();
+    });
+    if (!cheminTrace.isEmpty()) {
+        // Sauf si elle a déjà été arrêtée depuis le menu Affichage
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [cheminTrace] {
+            if (Trace::estActive()) {
+                Trace::arreter(cheminTrace);
+            }
+        });
     }
     
+    // Chien de garde de la boucle d'événements (blocages.log) ; la
+    // construction de la fenêtre compte déjà, la boucle ne tournant pas encore
+    SurveillantBoucle* surveillant = SurveillantBoucle::getInstance();
+    surveillant->demarrer();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [surveillant] {
+        surveillant->arreter();
+    });
+    
     // Create and show main window
     MainWindow window;
     window.show();
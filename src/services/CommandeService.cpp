@@ -1,9 +1,17 @@
 #include "CommandeService.h"
+#include "IndexFiltres.h"
+#include "MoniteurSLA.h"
+#include "StatistiquesLivraison.h"
+#include "JournalEvenements.h"
 #include "db/DatabaseManager.h"
+#include "db/InstrumentationRequetes.h"
+#include "utils/ExportTableur.h"
+#include "utils/Trace.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QMap>
+#include <QStringList>
 #include <QPdfWriter>
 #include <QPainter>
 #include <QStandardPaths>
@@ -12,25 +20,127 @@ CommandeService::CommandeService()
 {
 }
 
-bool CommandeService::ajouterCommande(const Commande& commande)
+bool CommandeService::ajouterCommande(const Commande& commande, Commande* resultat)
 {
+    PorteeTrace portee("CommandeService::ajouterCommande", "service");
+    
     if (!commande.isValid()) {
         return false;
     }
     
     DatabaseManager* db = DatabaseManager::getInstance();
-    QString query = "INSERT INTO COMMANDES (date_commande, statut, ville_livraison, id_client, id_livreur) "
-                   "VALUES (?, ?, ?, ?, ?)";
+    QString query = "INSERT INTO COMMANDES (date_commande, statut, ville_livraison, id_client, id_livreur, "
+                   "assigned_at, delivered_at) VALUES (?, ?, ?, ?, ?, ?, ?)";
+    
+    Commande horodatee = commande;
+    QDateTime maintenant;
+    if (!horodaterTransitions(horodatee, Commande(), maintenant)) {
+        return false;
+    }
     
     QVariantList values;
-    values << commande.getDateCommande()
-           << commande.getStatut()
-           << commande.getVilleLivraison()
-           << commande.getIdClient()
-           << (commande.getIdLivreur() > 0 ? commande.getIdLivreur() : QVariant());
+    values << horodatee.getDateCommande()
+           << horodatee.getStatut()
+           << horodatee.getVilleLivraison()
+           << horodatee.getIdClient()
+           << (horodatee.getIdLivreur() > 0 ? horodatee.getIdLivreur() : QVariant())
+           << valeurDate(horodatee.getDateAffectation())
+           << valeurDate(horodatee.getDateLivraison());
+    
+    // Insertion et événement dans la même transaction
+    if (!db->beginTransaction()) {
+        return false;
+    }
     
-    QSqlQuery result = db->executePreparedQuery(query, values);
-    return !result.lastError().isValid();
+    // Identifiant généré renvoyé par l'insertion elle-même
+    QVariantList generes = db->executeInsertReturning(query, values, {"id_commande"});
+    if (generes.isEmpty() || generes.first().toInt() <= 0) {
+        db->rollbackTransaction();
+        return false;
+    }
+    horodatee.setIdCommande(generes.first().toInt());
+    
+    JournalEvenements journal;
+    if (!journal.ecrire(EvenementCommande::depuis("CREATION", horodatee)) ||
+        !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres::getInstance()->commandeEnregistree(horodatee);
+    
+    if (resultat) {
+        *resultat = horodatee;
+    }
+    return true;
+}
+
+bool CommandeService::ajouterCommandes(const QList<Commande>& commandes, QList<Commande>* resultat)
+{
+    PorteeTrace portee("CommandeService::ajouterCommandes", "service");
+    
+    QList<Commande> horodatees;
+    QDateTime maintenant;
+    QVariantList dates, statuts, villes, idsClients, idsLivreurs, datesAffectation, datesLivraison;
+    for (const Commande& commande : commandes) {
+        if (!commande.isValid()) {
+            return false;
+        }
+        Commande horodatee = commande;
+        if (!horodaterTransitions(horodatee, Commande(), maintenant)) {
+            return false;
+        }
+        
+        dates << horodatee.getDateCommande();
+        statuts << horodatee.getStatut();
+        villes << horodatee.getVilleLivraison();
+        idsClients << horodatee.getIdClient();
+        idsLivreurs << (horodatee.getIdLivreur() > 0 ? horodatee.getIdLivreur() : QVariant());
+        datesAffectation << valeurDate(horodatee.getDateAffectation());
+        datesLivraison << valeurDate(horodatee.getDateLivraison());
+        horodatees << horodatee;
+    }
+    
+    if (horodatees.isEmpty()) {
+        return true;
+    }
+    
+    DatabaseManager* db = DatabaseManager::getInstance();
+    QString query = "INSERT INTO COMMANDES (date_commande, statut, ville_livraison, id_client, id_livreur, "
+                   "assigned_at, delivered_at) VALUES (?, ?, ?, ?, ?, ?, ?)";
+    
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    QList<QVariantList> generes = db->executeBatchInsertReturning(query,
+        {dates, statuts, villes, idsClients, idsLivreurs, datesAffectation, datesLivraison}, {"id_commande"});
+    if (generes.isEmpty() || generes.first().size() != horodatees.size()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    QList<EvenementCommande> evenements;
+    for (int i = 0; i < horodatees.size(); ++i) {
+        horodatees[i].setIdCommande(generes.first()[i].toInt());
+        evenements << EvenementCommande::depuis("CREATION", horodatees[i]);
+    }
+    
+    JournalEvenements journal;
+    if (!journal.ecrire(evenements) || !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    for (const Commande& commande : horodatees) {
+        index->commandeEnregistree(commande);
+    }
+    
+    if (resultat) {
+        *resultat = horodatees;
+    }
+    return true;
 }
 
 Commande CommandeService::obtenirCommande(int id)
@@ -49,12 +159,16 @@ Commande CommandeService::obtenirCommande(int id)
 
 QList<Commande> CommandeService::obtenirToutesCommandes()
 {
+    PorteeTrace portee("CommandeService::obtenirToutesCommandes", "service");
+    
     QList<Commande> commandes;
     DatabaseManager* db = DatabaseManager::getInstance();
     QString query = "SELECT * FROM COMMANDES ORDER BY date_commande DESC";
     
     QSqlQuery result = db->executeQuery(query);
     
+    // Lecture et conversion des lignes, hors exécution de la requête
+    PorteeTrace lecture("CommandeService::mapFromQuery", "mapping");
     while (result.next()) {
         commandes.append(mapFromQuery(result));
     }
@@ -62,36 +176,96 @@ QList<Commande> CommandeService::obtenirToutesCommandes()
     return commandes;
 }
 
-bool CommandeService::modifierCommande(const Commande& commande)
+bool CommandeService::modifierCommande(const Commande& commande, Commande* resultat)
 {
+    PorteeTrace portee("CommandeService::modifierCommande", "service");
+    
     if (!commande.isValid()) {
         return false;
     }
     
+    IndexFiltres* index = IndexFiltres::getInstance();
+    Commande precedente = etatActuel(commande.getIdCommande());
+    
+    Commande horodatee = commande;
+    QDateTime maintenant;
+    if (!horodaterTransitions(horodatee, precedente, maintenant)) {
+        return false;
+    }
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     QString query = "UPDATE COMMANDES SET date_commande = ?, statut = ?, "
-                   "ville_livraison = ?, id_client = ?, id_livreur = ? "
+                   "ville_livraison = ?, id_client = ?, id_livreur = ?, "
+                   "assigned_at = ?, delivered_at = ? "
                    "WHERE id_commande = ?";
     
     QVariantList values;
-    values << commande.getDateCommande()
-           << commande.getStatut()
-           << commande.getVilleLivraison()
-           << commande.getIdClient()
-           << (commande.getIdLivreur() > 0 ? commande.getIdLivreur() : QVariant())
-           << commande.getIdCommande();
+    values << horodatee.getDateCommande()
+           << horodatee.getStatut()
+           << horodatee.getVilleLivraison()
+           << horodatee.getIdClient()
+           << (horodatee.getIdLivreur() > 0 ? horodatee.getIdLivreur() : QVariant())
+           << valeurDate(horodatee.getDateAffectation())
+           << valeurDate(horodatee.getDateLivraison())
+           << horodatee.getIdCommande();
+    
+    if (!db->beginTransaction()) {
+        return false;
+    }
     
+    // Commande absente ou supprimée entre-temps : ni événement ni ligne indexée
     QSqlQuery result = db->executePreparedQuery(query, values);
-    return !result.lastError().isValid();
+    if (result.lastError().isValid() || result.numRowsAffected() != 1) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    JournalEvenements journal;
+    if (!journal.ecrire(EvenementCommande::depuis("MODIFICATION", horodatee, precedente.getStatut())) ||
+        !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    index->commandeEnregistree(horodatee);
+    
+    if (resultat) {
+        *resultat = horodatee;
+    }
+    return true;
 }
 
 bool CommandeService::supprimerCommande(int id)
 {
+    PorteeTrace portee("CommandeService::supprimerCommande", "service");
+    
+    // Dernier état connu, conservé dans l'événement de suppression
+    Commande precedente = etatActuel(id);
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     QString query = "DELETE FROM COMMANDES WHERE id_commande = ?";
     
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    // Déjà supprimée (ou inconnue) : pas d'événement SUPPRESSION
     QSqlQuery result = db->executePreparedQuery(query, {id});
-    return !result.lastError().isValid();
+    if (result.lastError().isValid() || result.numRowsAffected() != 1) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    precedente.setIdCommande(id);
+    JournalEvenements journal;
+    if (!journal.ecrire(EvenementCommande::depuis("SUPPRESSION", precedente, precedente.getStatut())) ||
+        !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres::getInstance()->commandeSupprimee(id);
+    return true;
 }
 
 QList<Commande> CommandeService::rechercherCommandes(const QString& statut, 
@@ -99,6 +273,14 @@ QList<Commande> CommandeService::rechercherCommandes(const QString& statut,
                                                      const QDate& dateDebut, 
                                                      const QDate& dateFin)
 {
+    PorteeTrace portee("CommandeService::rechercherCommandes", "service");
+    
+    // Résolution par l'index bitmap en mémoire, sans aller-retour base
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->filtrerCommandes(statut, ville, dateDebut, dateFin);
+    }
+    
     QList<Commande> commandes;
     DatabaseManager* db = DatabaseManager::getInstance();
     
@@ -129,6 +311,7 @@ QList<Commande> CommandeService::rechercherCommandes(const QString& statut,
     
     QSqlQuery result = db->executePreparedQuery(query, values);
     
+    PorteeTrace lecture("CommandeService::mapFromQuery", "mapping");
     while (result.next()) {
         commandes.append(mapFromQuery(result));
     }
@@ -146,6 +329,7 @@ QList<Commande> CommandeService::trierCommandes(const QString& critere, bool cro
     
     QSqlQuery result = db->executeQuery(query);
     
+    PorteeTrace lecture("CommandeService::mapFromQuery", "mapping");
     while (result.next()) {
         commandes.append(mapFromQuery(result));
     }
@@ -153,11 +337,54 @@ QList<Commande> CommandeService::trierCommandes(const QString& critere, bool cro
     return commandes;
 }
 
+ModificationsCommandes CommandeService::obtenirModificationsDepuis(const QDateTime& filigrane)
+{
+    PorteeTrace portee("CommandeService::obtenirModificationsDepuis", "service");
+    
+    ModificationsCommandes modifications;
+    DatabaseManager* db = DatabaseManager::getInstance();
+    
+    // Nouveau filigrane lu avant les lignes : rien ne peut être manqué
+    modifications.filigrane = db->currentServerTime();
+    
+    // Rétention des suppressions jugée à l'horloge du serveur, celle des
+    // filigranes : filigrane invalide, l'appelant relit tout
+    if (!modifications.filigrane.isValid() || !filigrane.isValid() ||
+        filigrane.daysTo(modifications.filigrane) >= DatabaseManager::DELETION_RETENTION_DAYS) {
+        modifications.filigrane = QDateTime();
+        return modifications;
+    }
+    QDateTime depuis = filigrane.addSecs(-DatabaseManager::WATERMARK_MARGIN_SECS);
+    // Dates SQLite en texte : le paramètre lié est ramené au format des triggers
+    const QString borne = db->isSqlite() ? "datetime(?)" : "?";
+    
+    QSqlQuery result = db->executePreparedQuery(
+        "SELECT * FROM COMMANDES WHERE updated_at >= " + borne + " ORDER BY date_commande DESC", {depuis});
+    PorteeTrace lecture("CommandeService::mapFromQuery", "mapping");
+    while (result.next()) {
+        modifications.modifiees.append(mapFromQuery(result));
+    }
+    
+    QSqlQuery supprimees = db->executePreparedQuery(
+        "SELECT id_ligne FROM SUPPRESSIONS WHERE nom_table = 'COMMANDES' AND deleted_at >= " + borne, {depuis});
+    while (supprimees.next()) {
+        modifications.supprimees.append(supprimees.value("id_ligne").toInt());
+    }
+    
+    return modifications;
+}
+
 double CommandeService::calculerDelaiMoyenLivraison()
 {
+    // Résumé maintenu à chaque livraison, sans relire les commandes livrées
+    if (IndexFiltres::getInstance()->assurerChargement()) {
+        return StatistiquesLivraison::getInstance()->global().moyenne;
+    }
+    
+    // Délai réel : de la commande à la livraison (différence de DATE en jours)
     DatabaseManager* db = DatabaseManager::getInstance();
-    QString query = "SELECT AVG(EXTRACT(DAY FROM (SYSDATE - date_commande))) as delai_moyen "
-                   "FROM COMMANDES WHERE statut = 'Livree'";
+    QString query = "SELECT AVG(delivered_at - date_commande) as delai_moyen "
+                   "FROM COMMANDES WHERE statut = 'Livree' AND delivered_at IS NOT NULL";
     
     QSqlQuery result = db->executeQuery(query);
     
@@ -168,18 +395,210 @@ double CommandeService::calculerDelaiMoyenLivraison()
     return 0.0;
 }
 
-bool CommandeService::affecterLivreur(int idCommande, int idLivreur)
+bool CommandeService::affecterLivreur(int idCommande, int idLivreur, Commande* resultat)
+{
+    PorteeTrace portee("CommandeService::affecterLivreur", "service");
+    
+    DatabaseManager* db = DatabaseManager::getInstance();
+    QString query = "UPDATE COMMANDES SET id_livreur = ?, statut = 'En cours', assigned_at = ? "
+                   "WHERE id_commande = ?";
+    
+    Commande commande = etatActuel(idCommande);
+    QString statutPrecedent = commande.getStatut();
+    
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    // Même horloge que UPDATED_AT, pas celle du poste
+    QDateTime maintenant = db->currentServerTime();
+    if (!maintenant.isValid()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    QSqlQuery result = db->executePreparedQuery(query, {idLivreur, maintenant, idCommande});
+    if (result.lastError().isValid() || result.numRowsAffected() != 1) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    commande.setIdCommande(idCommande);
+    commande.setIdLivreur(idLivreur);
+    commande.setStatut("En cours");
+    commande.setDateAffectation(maintenant);
+    JournalEvenements journal;
+    if (!journal.ecrire(EvenementCommande::depuis("AFFECTATION", commande, statutPrecedent)) ||
+        !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres::getInstance()->livreurAffecte(idCommande, idLivreur, maintenant);
+    
+    if (resultat) {
+        *resultat = commande;
+    }
+    return true;
+}
+
+bool CommandeService::changerStatutCommandes(const QList<int>& ids, const QString& statut,
+                                             QList<Commande>* resultat)
+{
+    PorteeTrace portee("CommandeService::changerStatutCommandes", "service");
+    
+    QDateTime maintenant;
+    QList<Commande> commandes;
+    QList<EvenementCommande> evenements;
+    QVariantList statuts, datesAffectation, datesLivraison, idsCommandes;
+    
+    for (const Commande& precedente : etatsActuels(ids)) {
+        Commande commande = precedente;
+        commande.setStatut(statut);
+        if (!horodaterTransitions(commande, precedente, maintenant)) {
+            return false;
+        }
+        
+        statuts << statut;
+        datesAffectation << valeurDate(commande.getDateAffectation());
+        datesLivraison << valeurDate(commande.getDateLivraison());
+        idsCommandes << commande.getIdCommande();
+        evenements << EvenementCommande::depuis("MODIFICATION", commande, precedente.getStatut());
+        commandes << commande;
+    }
+    
+    if (commandes.isEmpty()) {
+        return false;
+    }
+    
+    DatabaseManager* db = DatabaseManager::getInstance();
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    QString query = "UPDATE COMMANDES SET statut = ?, assigned_at = ?, delivered_at = ? "
+                   "WHERE id_commande = ?";
+    QSqlQuery result = db->executeBatchQuery(query, {statuts, datesAffectation, datesLivraison, idsCommandes});
+    
+    JournalEvenements journal;
+    if (result.lastError().isValid() || !journal.ecrire(evenements) || !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    for (const Commande& commande : commandes) {
+        index->commandeEnregistree(commande);
+    }
+    
+    if (resultat) {
+        *resultat = commandes;
+    }
+    return true;
+}
+
+bool CommandeService::affecterLivreurCommandes(const QList<int>& ids, int idLivreur,
+                                               QList<Commande>* resultat)
 {
+    PorteeTrace portee("CommandeService::affecterLivreurCommandes", "service");
+    
+    // Une seule heure du serveur pour tout le lot
+    QDateTime maintenant = DatabaseManager::getInstance()->currentServerTime();
+    if (!maintenant.isValid()) {
+        return false;
+    }
+    QList<Commande> commandes;
+    QList<EvenementCommande> evenements;
+    QVariantList idsLivreurs, datesAffectation, idsCommandes;
+    
+    for (const Commande& precedente : etatsActuels(ids)) {
+        Commande commande = precedente;
+        commande.setIdLivreur(idLivreur);
+        commande.setStatut("En cours");
+        commande.setDateAffectation(maintenant);
+        
+        idsLivreurs << idLivreur;
+        datesAffectation << maintenant;
+        idsCommandes << commande.getIdCommande();
+        evenements << EvenementCommande::depuis("AFFECTATION", commande, precedente.getStatut());
+        commandes << commande;
+    }
+    
+    if (commandes.isEmpty()) {
+        return false;
+    }
+    
     DatabaseManager* db = DatabaseManager::getInstance();
-    QString query = "UPDATE COMMANDES SET id_livreur = ?, statut = 'En cours' "
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    QString query = "UPDATE COMMANDES SET id_livreur = ?, statut = 'En cours', assigned_at = ? "
                    "WHERE id_commande = ?";
+    QSqlQuery result = db->executeBatchQuery(query, {idsLivreurs, datesAffectation, idsCommandes});
     
-    QSqlQuery result = db->executePreparedQuery(query, {idLivreur, idCommande});
-    return !result.lastError().isValid();
+    JournalEvenements journal;
+    if (result.lastError().isValid() || !journal.ecrire(evenements) || !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    for (const Commande& commande : commandes) {
+        index->livreurAffecte(commande.getIdCommande(), idLivreur, maintenant);
+    }
+    
+    if (resultat) {
+        *resultat = commandes;
+    }
+    return true;
+}
+
+bool CommandeService::supprimerCommandes(const QList<int>& ids, QList<int>* supprimees)
+{
+    PorteeTrace portee("CommandeService::supprimerCommandes", "service");
+    
+    DatabaseManager* db = DatabaseManager::getInstance();
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    // Dernier état de chaque commande, lu sous verrou et conservé dans son
+    // événement ; les commandes déjà supprimées par un autre poste sont écartées
+    QList<Commande> precedentes;
+    if (!verrouillerEtats(ids, precedentes) || precedentes.isEmpty()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    QList<EvenementCommande> evenements;
+    QVariantList idsCommandes;
+    for (const Commande& precedente : precedentes) {
+        idsCommandes << precedente.getIdCommande();
+        evenements << EvenementCommande::depuis("SUPPRESSION", precedente, precedente.getStatut());
+    }
+    
+    QSqlQuery result = db->executeBatchQuery("DELETE FROM COMMANDES WHERE id_commande = ?", {idsCommandes});
+    
+    JournalEvenements journal;
+    if (result.lastError().isValid() || !journal.ecrire(evenements) || !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    for (const QVariant& id : idsCommandes) {
+        index->commandeSupprimee(id.toInt());
+        if (supprimees) {
+            supprimees->append(id.toInt());
+        }
+    }
+    return true;
 }
 
 QMap<QString, int> CommandeService::obtenirStatistiquesParStatut()
 {
+    PorteeTrace portee("CommandeService::obtenirStatistiquesParStatut", "service");
+    
     QMap<QString, int> statistiques;
     DatabaseManager* db = DatabaseManager::getInstance();
     QString query = "SELECT statut, COUNT(*) as nombre FROM COMMANDES GROUP BY statut";
@@ -195,6 +614,8 @@ QMap<QString, int> CommandeService::obtenirStatistiquesParStatut()
 
 QMap<QString, int> CommandeService::obtenirStatistiquesParVille()
 {
+    PorteeTrace portee("CommandeService::obtenirStatistiquesParVille", "service");
+    
     QMap<QString, int> statistiques;
     DatabaseManager* db = DatabaseManager::getInstance();
     QString query = "SELECT ville_livraison, COUNT(*) as nombre FROM COMMANDES GROUP BY ville_livraison";
@@ -208,8 +629,29 @@ QMap<QString, int> CommandeService::obtenirStatistiquesParVille()
     return statistiques;
 }
 
+QMap<QDate, int> CommandeService::obtenirStatistiquesParDate()
+{
+    PorteeTrace portee("CommandeService::obtenirStatistiquesParDate", "service");
+    
+    QMap<QDate, int> statistiques;
+    DatabaseManager* db = DatabaseManager::getInstance();
+    // Regroupement par jour côté serveur : une DATE Oracle peut porter une heure
+    const QString jour = db->isSqlite() ? "date(date_commande)" : "TRUNC(date_commande)";
+    QString query = QString("SELECT %1 as jour, COUNT(*) as nombre FROM COMMANDES GROUP BY %1").arg(jour);
+    
+    QSqlQuery result = db->executeQuery(query);
+    
+    while (result.next()) {
+        statistiques[result.value("jour").toDate()] = result.value("nombre").toInt();
+    }
+    
+    return statistiques;
+}
+
 bool CommandeService::genererPDFCommande(int idCommande, const QString& cheminFichier)
 {
+    PorteeTrace portee("CommandeService::genererPDFCommande", "rapport", cheminFichier);
+    
     Commande commande = obtenirCommande(idCommande);
     if (!commande.isValid()) {
         return false;
@@ -252,8 +694,34 @@ bool CommandeService::genererPDFCommande(int idCommande, const QString& cheminFi
     return true;
 }
 
+bool CommandeService::genererListeCommandes(const QString& cheminFichier)
+{
+    PorteeTrace portee("CommandeService::genererListeCommandes", "rapport", cheminFichier);
+    
+    QList<Commande> commandes = obtenirToutesCommandes();
+    
+    QList<QVariantList> lignes;
+    for (const Commande& commande : commandes) {
+        lignes << QVariantList{commande.getIdCommande(),
+                               commande.getDateCommande(),
+                               commande.getStatut(),
+                               commande.getVilleLivraison(),
+                               commande.getIdClient(),
+                               commande.getIdLivreur() > 0 ? QVariant(commande.getIdLivreur()) : QVariant(),
+                               commande.getDateAffectation().isValid() ? QVariant(commande.getDateAffectation()) : QVariant(),
+                               commande.getDateLivraison().isValid() ? QVariant(commande.getDateLivraison()) : QVariant()};
+    }
+    
+    // Format selon l'extension : .xlsx (par défaut) ou .csv
+    return ExportTableur::enregistrer(cheminFichier, "Commandes",
+        {"ID", "Date", "Statut", "Ville", "Client", "Livreur", "Affectée le", "Livrée le"},
+        lignes);
+}
+
 bool CommandeService::genererRapportCommandes(const QString& cheminFichier)
 {
+    PorteeTrace portee("CommandeService::genererRapportCommandes", "rapport", cheminFichier);
+    
     QList<Commande> commandes = obtenirToutesCommandes();
     
     QPdfWriter writer(cheminFichier);
@@ -321,16 +789,59 @@ bool CommandeService::genererRapportCommandes(const QString& cheminFichier)
 
 QList<Commande> CommandeService::obtenirCommandesEnRetard()
 {
+    PorteeTrace portee("CommandeService::obtenirCommandesEnRetard", "service");
+    
+    MoniteurSLA* sla = MoniteurSLA::getInstance();
+    
+    // Ensemble tenu à jour par le moniteur, aucune requête à relancer
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        QList<Commande> commandes;
+        for (int id : sla->commandesEnRetard()) {
+            commandes.append(index->obtenirCommande(id));
+        }
+        return commandes;
+    }
+    
+    // Sans index : présélection sur le plus court délai, puis règle par ville
+    int delaiMinimum = sla->getDelaiDefaut();
+    for (int delai : sla->delaisParVille()) {
+        delaiMinimum = qMin(delaiMinimum, delai);
+    }
+    QDate aujourdhui = QDate::currentDate();
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     QString query = "SELECT * FROM COMMANDES WHERE statut = 'En retard' OR "
-                   "(statut = 'En cours' AND date_commande < ?)";
+                   "(statut = 'En cours' AND date_commande < ?) ORDER BY date_commande";
     
-    // Commandes de plus de 7 jours considérées en retard
-    QDate dateRetard = QDate::currentDate().addDays(-7);
+    QSqlQuery result = db->executePreparedQuery(query, {aujourdhui.addDays(-delaiMinimum)});
     
-    QSqlQuery result = db->executePreparedQuery(query, {dateRetard});
+    QList<Commande> commandes;
+    while (result.next()) {
+        Commande commande = mapFromQuery(result);
+        if (commande.getStatut() == "En retard" || sla->echeance(commande) < aujourdhui) {
+            commandes.append(commande);
+        }
+    }
+    
+    return commandes;
+}
+
+QList<Commande> CommandeService::obtenirCommandesActivesLivreur(int idLivreur)
+{
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->commandesActives(idLivreur);
+    }
+    
+    DatabaseManager* db = DatabaseManager::getInstance();
+    QString query = "SELECT * FROM COMMANDES WHERE id_livreur = ? "
+                   "AND statut IN ('En attente', 'En cours') ORDER BY date_commande DESC";
+    
+    QSqlQuery result = db->executePreparedQuery(query, {idLivreur});
     
     QList<Commande> commandes;
+    PorteeTrace lecture("CommandeService::mapFromQuery", "mapping");
     while (result.next()) {
         commandes.append(mapFromQuery(result));
     }
@@ -340,6 +851,8 @@ QList<Commande> CommandeService::obtenirCommandesEnRetard()
 
 Commande CommandeService::mapFromQuery(const QSqlQuery& query)
 {
+    InstrumentationRequetes::getInstance()->ligneLue(query);
+
     Commande commande;
     commande.setIdCommande(query.value("id_commande").toInt());
     commande.setDateCommande(query.value("date_commande").toDate());
@@ -347,20 +860,120 @@ Commande CommandeService::mapFromQuery(const QSqlQuery& query)
     commande.setVilleLivraison(query.value("ville_livraison").toString());
     commande.setIdClient(query.value("id_client").toInt());
     commande.setIdLivreur(query.value("id_livreur").toInt());
+    commande.setDateAffectation(query.value("assigned_at").toDateTime());
+    commande.setDateLivraison(query.value("delivered_at").toDateTime());
     
     return commande;
 }
 
-int CommandeService::obtenirProchainId()
+Commande CommandeService::etatActuel(int id)
 {
-    DatabaseManager* db = DatabaseManager::getInstance();
-    QString query = "SELECT NVL(MAX(id_commande), 0) + 1 as next_id FROM COMMANDES";
-    
-    QSqlQuery result = db->executeQuery(query);
+    // L'index s'il est chargé, sinon la base
+    IndexFiltres* index = IndexFiltres::getInstance();
+    return index->estCharge() ? index->obtenirCommande(id) : obtenirCommande(id);
+}
+
+QList<Commande> CommandeService::etatsActuels(const QList<int>& ids)
+{
+    // Commandes introuvables (supprimées entre-temps) ignorées
+    QList<Commande> commandes;
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->estCharge()) {
+        for (int id : ids) {
+            Commande commande = index->obtenirCommande(id);
+            if (commande.isValid()) {
+                commandes.append(commande);
+            }
+        }
+        return commandes;
+    }
     
-    if (result.next()) {
-        return result.value("next_id").toInt();
+    // Sinon lecture par tranches de 1000 (limite Oracle d'une liste IN)
+    DatabaseManager* db = DatabaseManager::getInstance();
+    for (int debut = 0; debut < ids.size(); debut += 1000) {
+        const QList<int> tranche = ids.mid(debut, 1000);
+        QStringList marqueurs;
+        QVariantList values;
+        for (int id : tranche) {
+            marqueurs << "?";
+            values << id;
+        }
+        
+        QSqlQuery result = db->executePreparedQuery(
+            QString("SELECT * FROM COMMANDES WHERE id_commande IN (%1)").arg(marqueurs.join(", ")), values);
+        while (result.next()) {
+            commandes.append(mapFromQuery(result));
+        }
+    }
+    return commandes;
+}
+
+bool CommandeService::verrouillerEtats(const QList<int>& ids, QList<Commande>& commandes)
+{
+    // Par tranches de 1000 (limite Oracle d'une liste IN) ; SQLite verrouille
+    // déjà la base entière à l'écriture
+    DatabaseManager* db = DatabaseManager::getInstance();
+    for (int debut = 0; debut < ids.size(); debut += 1000) {
+        const QList<int> tranche = ids.mid(debut, 1000);
+        QStringList marqueurs;
+        QVariantList values;
+        for (int id : tranche) {
+            marqueurs << "?";
+            values << id;
+        }
+        
+        QString query = QString("SELECT * FROM COMMANDES WHERE id_commande IN (%1)").arg(marqueurs.join(", "));
+        if (!db->isSqlite()) {
+            query += " FOR UPDATE";
+        }
+        QSqlQuery result = db->executePreparedQuery(query, values);
+        if (result.lastError().isValid()) {
+            return false;
+        }
+        while (result.next()) {
+            commandes.append(mapFromQuery(result));
+        }
+    }
+    return true;
+}
+
+bool CommandeService::horodaterTransitions(Commande& commande, const Commande& precedente,
+                                           QDateTime& maintenant)
+{
+    // Heure du serveur, lue au plus une fois par opération et seulement
+    // si une transition est datée : les postes ne partagent pas d'horloge
+    auto heureServeur = [&maintenant]() {
+        if (!maintenant.isValid()) {
+            maintenant = DatabaseManager::getInstance()->currentServerTime();
+        }
+        return maintenant.isValid();
+    };
+    
+    // Affectation conservée tant que le livreur ne change pas
+    if (commande.getIdLivreur() <= 0) {
+        commande.setDateAffectation(QDateTime());
+    } else if (commande.getIdLivreur() == precedente.getIdLivreur()) {
+        commande.setDateAffectation(precedente.getDateAffectation());
+    } else if (heureServeur()) {
+        commande.setDateAffectation(maintenant);
+    } else {
+        return false;
     }
     
-    return 1;
+    // Livraison datée uniquement au passage au statut Livree
+    if (commande.getStatut() != "Livree") {
+        commande.setDateLivraison(QDateTime());
+    } else if (precedente.getStatut() == "Livree") {
+        commande.setDateLivraison(precedente.getDateLivraison());
+    } else if (heureServeur()) {
+        commande.setDateLivraison(maintenant);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QVariant CommandeService::valeurDate(const QDateTime& date)
+{
+    return date.isValid() ? QVariant(date) : QVariant();
 }
@@ -5,18 +5,31 @@
 #include <QVariant>
 #include <QSqlQuery>
 #include <QDate>
+#include <QDateTime>
 #include "entities/Commande.h"
 
+// Lignes modifiées ou supprimées depuis un filigrane (UPDATED_AT)
+struct ModificationsCommandes
+{
+    QList<Commande> modifiees;   // insérées ou mises à jour
+    QList<int> supprimees;
+    QDateTime filigrane;         // à fournir à l'appel suivant
+};
+
 class CommandeService
 {
 public:
     CommandeService();
     
     // CRUD Operations
-    bool ajouterCommande(const Commande& commande);
+    // resultat : ligne telle qu'enregistrée (identifiant, dates), pour
+    // mettre à jour une vue sans la recharger
+    bool ajouterCommande(const Commande& commande, Commande* resultat = nullptr);
+    // Insertion en lot (un aller-retour sous Oracle), identifiants renvoyés
+    bool ajouterCommandes(const QList<Commande>& commandes, QList<Commande>* resultat = nullptr);
     Commande obtenirCommande(int id);
     QList<Commande> obtenirToutesCommandes();
-    bool modifierCommande(const Commande& commande);
+    bool modifierCommande(const Commande& commande, Commande* resultat = nullptr);
     bool supprimerCommande(int id);
     
     // Recherche et tri multicritères
@@ -27,10 +40,25 @@ public:
     
     QList<Commande> trierCommandes(const QString& critere, bool croissant = true);
     
+    // Synchronisation différentielle des vues ; filigrane du résultat
+    // invalide si la lecture échoue ou si filigrane dépasse la rétention
+    // des suppressions (relecture complète à faire)
+    ModificationsCommandes obtenirModificationsDepuis(const QDateTime& filigrane);
+    
     // Fonctionnalités métier
     double calculerDelaiMoyenLivraison();
-    bool affecterLivreur(int idCommande, int idLivreur);
+    bool affecterLivreur(int idCommande, int idLivreur, Commande* resultat = nullptr);
     QList<Commande> obtenirCommandesEnRetard();
+    QList<Commande> obtenirCommandesActivesLivreur(int idLivreur);
+    
+    // Opérations groupées : une requête par lot et une seule transaction.
+    // Les commandes résultantes sont fournies pour rafraîchir la vue.
+    bool changerStatutCommandes(const QList<int>& ids, const QString& statut,
+                                QList<Commande>* resultat = nullptr);
+    bool affecterLivreurCommandes(const QList<int>& ids, int idLivreur,
+                                  QList<Commande>* resultat = nullptr);
+    // Identifiants réellement supprimés dans supprimees (sans ceux déjà disparus)
+    bool supprimerCommandes(const QList<int>& ids, QList<int>* supprimees = nullptr);
     
     // Statistiques
     QMap<QString, int> obtenirStatistiquesParStatut();
@@ -40,10 +68,19 @@ public:
     // Génération de documents
     bool genererPDFCommande(int idCommande, const QString& cheminFichier);
     bool genererRapportCommandes(const QString& cheminFichier);
+    // Export tableur (.xlsx ou .csv selon l'extension)
+    bool genererListeCommandes(const QString& cheminFichier);
     
 private:
     Commande mapFromQuery(const QSqlQuery& query);
-    int obtenirProchainId();
+    Commande etatActuel(int id);
+    QList<Commande> etatsActuels(const QList<int>& ids);
+    // États lus en base et verrouillés jusqu'à la fin de la transaction en cours
+    bool verrouillerEtats(const QList<int>& ids, QList<Commande>& commandes);
+    // Dates d'affectation et de livraison selon la transition depuis l'état
+    // précédent, à l'heure du serveur (lue dans maintenant si encore invalide)
+    bool horodaterTransitions(Commande& commande, const Commande& precedente, QDateTime& maintenant);
+    static QVariant valeurDate(const QDateTime& date);
 };
 
 #endif // COMMANDESERVICE_H
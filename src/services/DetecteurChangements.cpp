@@ -0,0 +1,91 @@
+#include "DetecteurChangements.h"
+#include "db/DatabaseManager.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QStringList>
+
+DetecteurChangements* DetecteurChangements::instance = nullptr;
+
+DetecteurChangements::DetecteurChangements(QObject *parent)
+    : QObject(parent)
+    , initialise(false)
+    , passages(0)
+    , passagesInchanges(0)
+{
+    connect(&minuteur, &QTimer::timeout, this, &DetecteurChangements::verifier);
+    connect(&lecture, &QFutureWatcher<LectureVersions>::finished, this, &DetecteurChangements::lectureTerminee);
+}
+
+DetecteurChangements* DetecteurChangements::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new DetecteurChangements();
+    }
+    return instance;
+}
+
+void DetecteurChangements::demarrer(int intervalleMs)
+{
+    minuteur.start(intervalleMs);
+}
+
+void DetecteurChangements::arreter()
+{
+    minuteur.stop();
+}
+
+void DetecteurChangements::verifier()
+{
+    if (lecture.isRunning()) {
+        return;
+    }
+    if (!DatabaseManager::getInstance()->isConnected()) {
+        emit verificationTerminee(false);
+        return;
+    }
+
+    // Requête sur la connexion du fil du pool : un serveur lent ne fige
+    // plus la fenêtre à chaque passage du minuteur
+    lecture.setFuture(QtConcurrent::run([] {
+        LectureVersions resultat;
+        resultat.valide = DatabaseManager::getInstance()->lireVersionsTables(resultat.versions);
+        return resultat;
+    }));
+}
+
+void DetecteurChangements::lectureTerminee()
+{
+    emit verificationTerminee(comparer(lecture.result()));
+}
+
+bool DetecteurChangements::comparer(const LectureVersions& resultat)
+{
+    if (!resultat.valide) {
+        // Compteurs indisponibles (base injoignable) : versions de référence
+        // conservées, rien n'est signalé ; les changements seront vus au
+        // premier passage qui relit les compteurs
+        return false;
+    }
+
+    QStringList modifiees;
+    for (auto lue = resultat.versions.constBegin(); lue != resultat.versions.constEnd(); ++lue) {
+        auto it = versions.find(lue.key());
+        if (it == versions.end()) {
+            versions.insert(lue.key(), lue.value());
+            // Premier passage : état de référence, rien n'est signalé
+            if (initialise) modifiees << lue.key();
+        } else if (it.value() != lue.value()) {
+            it.value() = lue.value();
+            modifiees << lue.key();
+        }
+    }
+    initialise = true;
+
+    ++passages;
+    if (modifiees.isEmpty()) {
+        ++passagesInchanges;
+    }
+    for (const QString& table : modifiees) {
+        emit tableModifiee(table);
+    }
+    return !modifiees.isEmpty();
+}
@@ -0,0 +1,68 @@
+#ifndef DETECTEURCHANGEMENTS_H
+#define DETECTEURCHANGEMENTS_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QTimer>
+#include <QFutureWatcher>
+
+// Versions relues sur un fil du pool
+struct LectureVersions
+{
+    bool valide = false;
+    QHash<QString, qint64> versions;
+};
+
+// Détection des modifications par table : relecture périodique des
+// compteurs de SESSION_VERSIONS (maintenus par trigger), sur un fil du
+// pool. Une table n'est signalée que si sa version a changé depuis la
+// dernière vérification.
+class DetecteurChangements : public QObject
+{
+    Q_OBJECT
+
+private:
+    static DetecteurChangements* instance;
+
+    DetecteurChangements(QObject *parent = nullptr);
+
+public:
+    static DetecteurChangements* getInstance();
+
+    // Version connue (-1 : pas encore lue)
+    qint64 version(const QString& table) const { return versions.value(table, -1); }
+
+    // Diagnostic : vérifications, et celles qui ont évité un rechargement
+    qint64 verifications() const { return passages; }
+    qint64 verificationsSansChangement() const { return passagesInchanges; }
+
+    void demarrer(int intervalleMs = 10000);
+    void arreter();
+
+public slots:
+    // Relecture en arrière-plan ; sans effet si une relecture est en cours
+    // (son résultat fait foi). Résultat : tableModifiee puis verificationTerminee.
+    void verifier();
+
+signals:
+    void tableModifiee(const QString& table);
+    // modifiee : au moins une table a changé (faux aussi si la relecture a
+    // échoué)
+    void verificationTerminee(bool modifiee);
+
+private slots:
+    void lectureTerminee();
+
+private:
+    bool comparer(const LectureVersions& lecture);
+
+    QHash<QString, qint64> versions;
+    bool initialise;
+    qint64 passages;
+    qint64 passagesInchanges;
+    QTimer minuteur;
+    QFutureWatcher<LectureVersions> lecture;
+};
+
+#endif // DETECTEURCHANGEMENTS_H
@@ -0,0 +1,101 @@
+#include "IndexCharge.h"
+
+IndexCharge::IndexCharge()
+{
+}
+
+bool IndexCharge::Entree::operator<(const Entree& autre) const
+{
+    // Même ordre que "ORDER BY COUNT(c.id_commande) ASC, l.nom ASC"
+    if (charge != autre.charge) return charge < autre.charge;
+    if (nom != autre.nom) return nom < autre.nom;
+    return id < autre.id;
+}
+
+bool IndexCharge::estActive(const QString& statut)
+{
+    return statut == "En attente" || statut == "En cours";
+}
+
+void IndexCharge::vider()
+{
+    charges.clear();
+    positions.clear();
+    parZone.clear();
+    toutesZones.clear();
+}
+
+void IndexCharge::definirLivreur(const Livreur& livreur)
+{
+    const int id = livreur.getIdLivreur();
+    retirerLivreur(id);
+
+    // Seuls les livreurs disponibles sont candidats
+    if (!livreur.getDisponibilite()) return;
+
+    Position position;
+    position.zone = cleZone(livreur.getZoneLivraison());
+    position.entree = {charge(id), livreur.getNom(), id};
+    positions.insert(id, position);
+    inserer(position);
+}
+
+void IndexCharge::retirerLivreur(int idLivreur)
+{
+    auto it = positions.find(idLivreur);
+    if (it == positions.end()) return;
+
+    enlever(it.value());
+    positions.erase(it);
+}
+
+void IndexCharge::modifierCharge(int idLivreur, int delta)
+{
+    if (idLivreur <= 0 || delta == 0) return;
+
+    int& valeur = charges[idLivreur];
+    valeur += delta;
+
+    auto it = positions.find(idLivreur);
+    if (it != positions.end()) {
+        // Repositionner le livreur : suppression + insertion en O(log n)
+        enlever(it.value());
+        it->entree.charge = valeur;
+        inserer(it.value());
+    }
+
+    if (valeur == 0) {
+        charges.remove(idLivreur);
+    }
+}
+
+int IndexCharge::meilleurLivreur(const QString& zone) const
+{
+    if (zone.isEmpty()) {
+        return toutesZones.empty() ? 0 : toutesZones.begin()->id;
+    }
+
+    auto it = parZone.constFind(cleZone(zone));
+    if (it == parZone.constEnd() || it->empty()) {
+        return 0;
+    }
+    return it->begin()->id;
+}
+
+void IndexCharge::inserer(const Position& position)
+{
+    parZone[position.zone].insert(position.entree);
+    toutesZones.insert(position.entree);
+}
+
+void IndexCharge::enlever(const Position& position)
+{
+    auto it = parZone.find(position.zone);
+    if (it != parZone.end()) {
+        it->erase(position.entree);
+        if (it->empty()) {
+            parZone.erase(it);
+        }
+    }
+    toutesZones.erase(position.entree);
+}
@@ -0,0 +1,58 @@
+#ifndef INDEXCHARGE_H
+#define INDEXCHARGE_H
+
+#include <QHash>
+#include <QString>
+#include <set>
+#include "entities/Livreur.h"
+
+// Index ordonné des livreurs disponibles par zone, trié par nombre de
+// commandes actives puis par nom. Le moins chargé d'une zone est en tête :
+// la sélection est une lecture en O(1), les mises à jour en O(log n).
+class IndexCharge
+{
+public:
+    IndexCharge();
+
+    void vider();
+
+    // Livreurs
+    void definirLivreur(const Livreur& livreur);
+    void retirerLivreur(int idLivreur);
+
+    // Charges (commandes 'En attente' ou 'En cours')
+    void modifierCharge(int idLivreur, int delta);
+    int charge(int idLivreur) const { return charges.value(idLivreur, 0); }
+    const QHash<int, int>& toutesCharges() const { return charges; }
+
+    // Livreur disponible le moins chargé (zone vide = toutes zones), 0 si aucun
+    int meilleurLivreur(const QString& zone) const;
+
+    static bool estActive(const QString& statut);
+
+private:
+    struct Entree {
+        int charge;
+        QString nom;
+        int id;
+
+        bool operator<(const Entree& autre) const;
+    };
+
+    struct Position {
+        QString zone; // clé normalisée
+        Entree entree;
+    };
+
+    static QString cleZone(const QString& zone) { return zone.toUpper(); }
+
+    void inserer(const Position& position);
+    void enlever(const Position& position);
+
+    QHash<int, int> charges;
+    QHash<int, Position> positions;                // livreurs disponibles indexés
+    QHash<QString, std::set<Entree>> parZone;
+    std::set<Entree> toutesZones;
+};
+
+#endif // INDEXCHARGE_H
@@ -0,0 +1,512 @@
+#include "IndexFiltres.h"
+#include "CommandeService.h"
+#include "LivreurService.h"
+#include "JournalEvenements.h"
+#include "db/DatabaseManager.h"
+#include "utils/Trace.h"
+#include <QDebug>
+#include <algorithm>
+#include <utility>
+
+IndexFiltres* IndexFiltres::instance = nullptr;
+
+IndexFiltres::IndexFiltres(QObject *parent)
+    : QObject(parent)
+    , charge(false)
+    , servies(0)
+    , chargements(0)
+{
+}
+
+IndexFiltres* IndexFiltres::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new IndexFiltres();
+    }
+    return instance;
+}
+
+bool IndexFiltres::assurerChargement()
+{
+    if (charge) {
+        ++servies;
+        return true;
+    }
+
+    if (!DatabaseManager::getInstance()->isConnected()) {
+        return false;
+    }
+
+    charger(lireSources());
+    return true;
+}
+
+SourcesIndex IndexFiltres::lireSources()
+{
+    PorteeTrace portee("IndexFiltres::lireSources", "index");
+    SourcesIndex sources;
+
+    // Position et filigrane lus avant les tables : les écritures
+    // concurrentes du chargement seront rejouées (sans effet si déjà visibles)
+    sources.positionJournal = JournalEvenements().dernierePosition();
+    sources.filigrane = DatabaseManager::getInstance()->currentServerTime();
+
+    // Un seul parcours de chaque table, ensuite tout est incrémental
+    sources.commandes = CommandeService().obtenirToutesCommandes();
+    sources.livreurs = LivreurService().obtenirTousLivreurs();
+    return sources;
+}
+
+ContenuIndex IndexFiltres::indexer(const SourcesIndex& sources)
+{
+    PorteeTrace portee("IndexFiltres::indexer", "index");
+    ContenuIndex contenu;
+    for (const Commande& commande : sources.commandes) {
+        contenu.indexerCommande(commande);
+    }
+    for (const Livreur& livreur : sources.livreurs) {
+        contenu.indexerLivreur(livreur);
+    }
+    return contenu;
+}
+
+void IndexFiltres::charger(const SourcesIndex& sources)
+{
+    charger(indexer(sources), sources.positionJournal, sources.filigrane);
+}
+
+void IndexFiltres::charger(ContenuIndex&& contenu, qint64 position, const QDateTime& filigrane)
+{
+    PorteeTrace portee("IndexFiltres::charger", "index");
+    invalider();
+
+    static_cast<ContenuIndex&>(*this) = std::move(contenu);
+    // Fenêtre ouverte au filigrane : un événement validé en retard pendant
+    // la lecture des tables est rattrapé
+    curseurJournal = CurseurJournal();
+    curseurJournal.position = position;
+    curseurJournal.horodatage = filigrane;
+    filigraneLivreurs = filigrane;
+    charge = true;
+    ++chargements;
+    qDebug() << "Index bitmap chargé:" << commandes.size() << "commandes,"
+             << livreurs.size() << "livreurs";
+    emit indexRecharge();
+}
+
+void IndexFiltres::reconcilier(const ModificationsCommandes& modificationsCommandes,
+                               const ModificationsLivreurs& modificationsLivreurs,
+                               qint64 position, const QDateTime& filigrane)
+{
+    if (!charge) return;
+
+    PorteeTrace portee("IndexFiltres::reconcilier", "index");
+
+    // Livreurs d'abord : une suppression emporte ses commandes (cascade)
+    appliquerLivreurs(modificationsLivreurs);
+    for (const Commande& commande : modificationsCommandes.modifiees) {
+        commandeEnregistree(commande);
+    }
+    for (int idCommande : modificationsCommandes.supprimees) {
+        commandeSupprimee(idCommande);
+    }
+
+    curseurJournal = CurseurJournal();
+    curseurJournal.position = position;
+    curseurJournal.horodatage = filigrane;
+    filigraneLivreurs = filigrane;
+    qDebug() << "Index réconcilié:" << modificationsCommandes.modifiees.size() << "commandes modifiées,"
+             << modificationsCommandes.supprimees.size() << "supprimées,"
+             << modificationsLivreurs.modifies.size() << "livreurs modifiés,"
+             << modificationsLivreurs.supprimes.size() << "supprimés";
+}
+
+bool IndexFiltres::synchroniserLivreurs()
+{
+    if (!charge) return true;
+
+    PorteeTrace portee("IndexFiltres::synchroniserLivreurs", "index");
+    const ModificationsLivreurs modifications = LivreurService().obtenirModificationsDepuis(filigraneLivreurs);
+    if (!modifications.filigrane.isValid()) {
+        return false;
+    }
+
+    appliquerLivreurs(modifications);
+    filigraneLivreurs = modifications.filigrane;
+    return true;
+}
+
+void IndexFiltres::appliquerLivreurs(const ModificationsLivreurs& modifications)
+{
+    for (const Livreur& livreur : modifications.modifies) {
+        livreurEnregistre(livreur);
+    }
+    for (int idLivreur : modifications.supprimes) {
+        livreurSupprime(idLivreur);
+    }
+}
+
+void IndexFiltres::invalider()
+{
+    charge = false;
+    vider();
+}
+
+void ContenuIndex::vider()
+{
+    commandes.clear();
+    livreurs.clear();
+    toutesCommandes.vider();
+    commandesParStatut.clear();
+    commandesParVille.clear();
+    commandesParLivreur.clear();
+    tousLivreurs.vider();
+    livreursDisponibles.vider();
+    livreursParZone.clear();
+    indexCharge.vider();
+}
+
+void IndexFiltres::synchroniser()
+{
+    if (!charge) return;
+
+    // Seul le dernier état de chaque commande compte : pas d'états
+    // intermédiaires visibles ni de transitions rejouées deux fois (le
+    // curseur écarte les événements déjà lus de sa fenêtre de relecture)
+    QHash<int, EvenementCommande> derniers;
+    JournalEvenements journal;
+    journal.rejouer(curseurJournal, [&derniers](const EvenementCommande& e) {
+        auto it = derniers.constFind(e.idCommande);
+        if (it == derniers.constEnd() || it->idEvenement < e.idEvenement) {
+            derniers.insert(e.idCommande, e);
+        }
+    });
+
+    QList<EvenementCommande> evenements = derniers.values();
+    std::sort(evenements.begin(), evenements.end(),
+              [](const EvenementCommande& a, const EvenementCommande& b) {
+                  return a.idEvenement < b.idEvenement;
+              });
+
+    for (const EvenementCommande& e : evenements) {
+        if (e.type == "SUPPRESSION") {
+            commandeSupprimee(e.idCommande);
+            continue;
+        }
+
+        // Les dates de transition sont déduites de l'état déjà indexé
+        Commande commande = e.versCommande();
+        const Commande actuelle = commandes.value(e.idCommande);
+        if (commande.getIdLivreur() <= 0) {
+            commande.setDateAffectation(QDateTime());
+        } else if (commande.getIdLivreur() == actuelle.getIdLivreur()) {
+            commande.setDateAffectation(actuelle.getDateAffectation());
+        } else {
+            commande.setDateAffectation(e.horodatage);
+        }
+        if (commande.getStatut() != "Livree") {
+            commande.setDateLivraison(QDateTime());
+        } else if (actuelle.getStatut() == "Livree") {
+            commande.setDateLivraison(actuelle.getDateLivraison());
+        } else {
+            commande.setDateLivraison(e.horodatage);
+        }
+        commandeEnregistree(commande);
+    }
+}
+
+// Maintenance incrémentale
+
+void IndexFiltres::commandeEnregistree(const Commande& commande)
+{
+    if (!charge) return;
+
+    int ancienLivreur = 0;
+    bool dejaLivree = false;
+    auto it = commandes.constFind(commande.getIdCommande());
+    if (it != commandes.constEnd()) {
+        ancienLivreur = it->getIdLivreur();
+        dejaLivree = it->getStatut() == "Livree";
+        desindexerCommande(it.value());
+    }
+    indexerCommande(commande);
+
+    // Notification une fois l'état final atteint (pas de -1 puis +1 visible)
+    if (ancienLivreur > 0 && ancienLivreur != commande.getIdLivreur()) {
+        emit chargeModifiee(ancienLivreur, indexCharge.charge(ancienLivreur));
+    }
+    if (commande.getIdLivreur() > 0) {
+        emit chargeModifiee(commande.getIdLivreur(), indexCharge.charge(commande.getIdLivreur()));
+    }
+    emit commandeModifiee(commande.getIdCommande());
+    if (!dejaLivree && commande.getStatut() == "Livree") {
+        emit commandeLivree(commande.getIdCommande());
+    }
+}
+
+void IndexFiltres::commandeSupprimee(int idCommande)
+{
+    if (!charge) return;
+
+    auto it = commandes.constFind(idCommande);
+    if (it != commandes.constEnd()) {
+        const int idLivreur = it->getIdLivreur();
+        desindexerCommande(it.value());
+        if (idLivreur > 0) {
+            emit chargeModifiee(idLivreur, indexCharge.charge(idLivreur));
+        }
+        emit commandeRetiree(idCommande);
+    }
+}
+
+void IndexFiltres::livreurAffecte(int idCommande, int idLivreur, const QDateTime& dateAffectation)
+{
+    if (!charge) return;
+
+    auto it = commandes.constFind(idCommande);
+    if (it == commandes.constEnd()) return;
+
+    // Même effet que CommandeService::affecterLivreur
+    Commande commande = it.value();
+    commande.setIdLivreur(idLivreur);
+    commande.setStatut("En cours");
+    commande.setDateAffectation(dateAffectation);
+    commandeEnregistree(commande);
+}
+
+void IndexFiltres::livreurEnregistre(const Livreur& livreur)
+{
+    if (!charge) return;
+
+    auto it = livreurs.constFind(livreur.getIdLivreur());
+    if (it != livreurs.constEnd()) {
+        desindexerLivreur(it.value());
+    }
+    indexerLivreur(livreur);
+
+    // Le véhicule détermine la capacité
+    emit livreurModifie(livreur.getIdLivreur());
+}
+
+void IndexFiltres::livreurSupprime(int idLivreur)
+{
+    if (!charge) return;
+
+    // Les commandes du livreur sont supprimées en cascade par la contrainte FK
+    const BitmapCompresse cascade = commandesParLivreur.value(idLivreur);
+    cascade.parcourir([this](uint32_t id) {
+        commandeSupprimee(static_cast<int>(id));
+    });
+
+    auto it = livreurs.constFind(idLivreur);
+    if (it != livreurs.constEnd()) {
+        desindexerLivreur(it.value());
+        emit livreurRetire(idLivreur);
+    }
+}
+
+void IndexFiltres::disponibiliteModifiee(int idLivreur, bool disponible)
+{
+    if (!charge) return;
+
+    auto it = livreurs.constFind(idLivreur);
+    if (it == livreurs.constEnd()) return;
+
+    Livreur livreur = it.value();
+    livreur.setDisponibilite(disponible);
+    livreurEnregistre(livreur);
+}
+
+void ContenuIndex::indexerCommande(const Commande& commande)
+{
+    const int id = commande.getIdCommande();
+    commandes.insert(id, commande);
+    toutesCommandes.ajouter(id);
+    commandesParStatut[commande.getStatut()].ajouter(id);
+    commandesParVille[commande.getVilleLivraison()].ajouter(id);
+    if (commande.getIdLivreur() > 0) {
+        commandesParLivreur[commande.getIdLivreur()].ajouter(id);
+        if (IndexCharge::estActive(commande.getStatut())) {
+            indexCharge.modifierCharge(commande.getIdLivreur(), +1);
+        }
+    }
+}
+
+void ContenuIndex::desindexerCommande(const Commande& commande)
+{
+    const int id = commande.getIdCommande();
+    toutesCommandes.retirer(id);
+    retirerDe(commandesParStatut, commande.getStatut(), id);
+    retirerDe(commandesParVille, commande.getVilleLivraison(), id);
+
+    auto it = commandesParLivreur.find(commande.getIdLivreur());
+    if (it != commandesParLivreur.end()) {
+        it->retirer(id);
+        if (it->estVide()) {
+            commandesParLivreur.erase(it);
+        }
+        if (IndexCharge::estActive(commande.getStatut())) {
+            indexCharge.modifierCharge(commande.getIdLivreur(), -1);
+        }
+    }
+
+    commandes.remove(id);
+}
+
+void ContenuIndex::indexerLivreur(const Livreur& livreur)
+{
+    const int id = livreur.getIdLivreur();
+    livreurs.insert(id, livreur);
+    tousLivreurs.ajouter(id);
+    livreursParZone[livreur.getZoneLivraison()].ajouter(id);
+    if (livreur.getDisponibilite()) {
+        livreursDisponibles.ajouter(id);
+    }
+    indexCharge.definirLivreur(livreur);
+}
+
+void ContenuIndex::desindexerLivreur(const Livreur& livreur)
+{
+    const int id = livreur.getIdLivreur();
+    tousLivreurs.retirer(id);
+    livreursDisponibles.retirer(id);
+    retirerDe(livreursParZone, livreur.getZoneLivraison(), id);
+    indexCharge.retirerLivreur(id);
+    livreurs.remove(id);
+}
+
+void ContenuIndex::retirerDe(QMap<QString, BitmapCompresse>& bitmaps, const QString& cle, int id)
+{
+    auto it = bitmaps.find(cle);
+    if (it == bitmaps.end()) return;
+
+    it->retirer(id);
+    if (it->estVide()) {
+        bitmaps.erase(it); // garder uniquement les valeurs présentes
+    }
+}
+
+QMap<QString, int> IndexFiltres::compter(const QMap<QString, BitmapCompresse>& bitmaps)
+{
+    QMap<QString, int> comptes;
+    for (auto it = bitmaps.constBegin(); it != bitmaps.constEnd(); ++it) {
+        comptes.insert(it.key(), static_cast<int>(it->cardinalite()));
+    }
+    return comptes;
+}
+
+// Charges
+
+QMap<int, int> IndexFiltres::chargesActives() const
+{
+    // Tous les livreurs, y compris ceux sans commande active (charge 0)
+    QMap<int, int> resultat;
+    for (auto it = livreurs.constBegin(); it != livreurs.constEnd(); ++it) {
+        resultat.insert(it.key(), indexCharge.charge(it.key()));
+    }
+    return resultat;
+}
+
+Livreur IndexFiltres::meilleurLivreur(const QString& zone) const
+{
+    const int id = indexCharge.meilleurLivreur(zone);
+    return id > 0 ? livreurs.value(id) : Livreur();
+}
+
+// Filtres
+
+BitmapCompresse IndexFiltres::reunionCles(const QMap<QString, BitmapCompresse>& bitmaps,
+                                          const QString& motif, Qt::CaseSensitivity casse)
+{
+    // Équivalent de LIKE '%motif%' : peu de valeurs distinctes, on teste les clés
+    BitmapCompresse resultat;
+    for (auto it = bitmaps.constBegin(); it != bitmaps.constEnd(); ++it) {
+        if (it.key().contains(motif, casse)) {
+            resultat = resultat.ou(it.value());
+        }
+    }
+    return resultat;
+}
+
+QList<Commande> IndexFiltres::filtrerCommandes(const QString& statut, const QString& ville,
+                                               const QDate& dateDebut, const QDate& dateFin) const
+{
+    BitmapCompresse candidats = statut.isEmpty() ? toutesCommandes
+                                                 : commandesParStatut.value(statut);
+
+    if (!ville.isEmpty()) {
+        // LIKE Oracle : sensible à la casse
+        candidats = candidats.et(reunionCles(commandesParVille, ville, Qt::CaseSensitive));
+    }
+
+    QList<Commande> resultats = materialiserCommandes(candidats);
+
+    if (dateDebut.isValid() || dateFin.isValid()) {
+        resultats.erase(std::remove_if(resultats.begin(), resultats.end(),
+            [&](const Commande& c) {
+                return (dateDebut.isValid() && c.getDateCommande() < dateDebut) ||
+                       (dateFin.isValid() && c.getDateCommande() > dateFin);
+            }), resultats.end());
+    }
+
+    return resultats;
+}
+
+QList<Commande> IndexFiltres::commandesActives(int idLivreur) const
+{
+    const BitmapCompresse actives = commandesParStatut.value("En attente")
+                                        .ou(commandesParStatut.value("En cours"));
+    return materialiserCommandes(commandesParLivreur.value(idLivreur).et(actives));
+}
+
+QList<Livreur> IndexFiltres::filtrerLivreurs(const QString& nom, const QString& zone,
+                                             bool disponiblesSeuls) const
+{
+    BitmapCompresse candidats = disponiblesSeuls ? livreursDisponibles : tousLivreurs;
+
+    if (!zone.isEmpty()) {
+        // UPPER(zone) LIKE UPPER(?) : insensible à la casse
+        candidats = candidats.et(reunionCles(livreursParZone, zone, Qt::CaseInsensitive));
+    }
+
+    QList<Livreur> resultats = materialiserLivreurs(candidats);
+
+    if (!nom.isEmpty()) {
+        // Le nom est à forte cardinalité : filtré après matérialisation
+        resultats.erase(std::remove_if(resultats.begin(), resultats.end(),
+            [&](const Livreur& l) { return !l.getNom().contains(nom, Qt::CaseInsensitive); }),
+            resultats.end());
+    }
+
+    return resultats;
+}
+
+QList<Commande> IndexFiltres::materialiserCommandes(const BitmapCompresse& ids) const
+{
+    QList<Commande> resultats;
+    resultats.reserve(static_cast<qsizetype>(ids.cardinalite()));
+    ids.parcourir([&](uint32_t id) {
+        resultats.append(commandes.value(static_cast<int>(id)));
+    });
+
+    // Même ordre que les requêtes SQL : date_commande DESC
+    std::stable_sort(resultats.begin(), resultats.end(), [](const Commande& a, const Commande& b) {
+        return a.getDateCommande() > b.getDateCommande();
+    });
+    return resultats;
+}
+
+QList<Livreur> IndexFiltres::materialiserLivreurs(const BitmapCompresse& ids) const
+{
+    QList<Livreur> resultats;
+    resultats.reserve(static_cast<qsizetype>(ids.cardinalite()));
+    ids.parcourir([&](uint32_t id) {
+        resultats.append(livreurs.value(static_cast<int>(id)));
+    });
+
+    // Même ordre que les requêtes SQL : nom
+    std::stable_sort(resultats.begin(), resultats.end(), [](const Livreur& a, const Livreur& b) {
+        return a.getNom() < b.getNom();
+    });
+    return resultats;
+}
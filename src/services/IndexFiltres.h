@@ -0,0 +1,159 @@
+#ifndef INDEXFILTRES_H
+#define INDEXFILTRES_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QDate>
+#include "entities/Commande.h"
+#include "entities/Livreur.h"
+#include "utils/BitmapCompresse.h"
+#include "IndexCharge.h"
+#include "JournalEvenements.h"
+#include "CommandeService.h"
+#include "LivreurService.h"
+
+// Contenu des tables indexées, lu hors du fil de l'application par
+// IndexFiltres::lireSources puis indexé sur ce fil par IndexFiltres::charger
+struct SourcesIndex
+{
+    bool valide = false;         // renseigné par l'appelant (schéma vérifié, tables lues)
+    QDateTime filigrane;         // heure du serveur avant la lecture (UPDATED_AT)
+    qint64 positionJournal = 0;
+    QList<Commande> commandes;
+    QList<Livreur> livreurs;
+};
+
+// Lignes et bitmaps de l'index, sans signaux ni état de chargement :
+// construits sur n'importe quel fil (IndexFiltres::indexer), puis installés
+// d'un bloc sur le fil de l'application
+struct ContenuIndex
+{
+    void vider();
+    void indexerCommande(const Commande& commande);
+    void desindexerCommande(const Commande& commande);
+    void indexerLivreur(const Livreur& livreur);
+    void desindexerLivreur(const Livreur& livreur);
+
+    static void retirerDe(QMap<QString, BitmapCompresse>& bitmaps, const QString& cle, int id);
+
+    // Lignes en mémoire
+    QHash<int, Commande> commandes;
+    QHash<int, Livreur> livreurs;
+
+    // Bitmaps des commandes
+    BitmapCompresse toutesCommandes;
+    QMap<QString, BitmapCompresse> commandesParStatut;
+    QMap<QString, BitmapCompresse> commandesParVille;
+    QHash<int, BitmapCompresse> commandesParLivreur;
+
+    // Bitmaps des livreurs
+    BitmapCompresse tousLivreurs;
+    BitmapCompresse livreursDisponibles;
+    QMap<QString, BitmapCompresse> livreursParZone;
+
+    // Livreurs disponibles ordonnés par charge, par zone
+    IndexCharge indexCharge;
+};
+
+// Index bitmap en mémoire pour les filtres à faible cardinalité
+// (statut, ville, zone, disponibilité). Chargé une fois depuis la base puis
+// maintenu de façon incrémentale par les services après chaque écriture.
+class IndexFiltres : public QObject, private ContenuIndex
+{
+    Q_OBJECT
+
+private:
+    static IndexFiltres* instance;
+
+    IndexFiltres(QObject *parent = nullptr);
+
+public:
+    static IndexFiltres* getInstance();
+
+    // Chargement
+    bool estCharge() const { return charge; }
+    bool assurerChargement();
+    // Chargement en deux temps (démarrage) : lecture, et au besoin
+    // indexation, sur un fil quelconque, puis installation sur le fil de
+    // l'application
+    static SourcesIndex lireSources();
+    static ContenuIndex indexer(const SourcesIndex& sources);
+    void charger(const SourcesIndex& sources);
+    void charger(ContenuIndex&& contenu, qint64 position, const QDateTime& filigrane);
+    // Écarts entre un chargement (instantané local) et la base, appliqués
+    // comme des écritures ; journal repris à position, fenêtre de relecture
+    // ouverte au filigrane du chargement
+    void reconcilier(const ModificationsCommandes& modificationsCommandes,
+                     const ModificationsLivreurs& modificationsLivreurs,
+                     qint64 position, const QDateTime& filigrane);
+    void invalider();
+    // Application des événements ORDER_EVENTS écrits depuis le chargement
+    void synchroniser();
+    // Livreurs modifiés ou supprimés depuis le filigrane de l'index
+    // (UPDATED_AT / SUPPRESSIONS) ; false si les écarts sont indisponibles
+    bool synchroniserLivreurs();
+
+    // Diagnostic : lectures servies par l'index, chargements complets, taille
+    qint64 lecturesServies() const { return servies; }
+    qint64 chargementsComplets() const { return chargements; }
+    int nombreCommandes() const { return commandes.size(); }
+    int nombreLivreurs() const { return livreurs.size(); }
+
+    // Maintenance incrémentale (appelée après une écriture réussie)
+    void commandeEnregistree(const Commande& commande);
+    void commandeSupprimee(int idCommande);
+    void livreurAffecte(int idCommande, int idLivreur, const QDateTime& dateAffectation);
+    void livreurEnregistre(const Livreur& livreur);
+    void livreurSupprime(int idLivreur);
+    void disponibiliteModifiee(int idLivreur, bool disponible);
+
+    // Filtres résolus par AND/OR de bitmaps avant matérialisation
+    QList<Commande> filtrerCommandes(const QString& statut, const QString& ville,
+                                     const QDate& dateDebut, const QDate& dateFin) const;
+    QList<Commande> commandesActives(int idLivreur) const;
+    QList<Livreur> filtrerLivreurs(const QString& nom, const QString& zone,
+                                   bool disponiblesSeuls) const;
+
+    // Charge des livreurs (commandes actives), maintenue à chaque écriture
+    int chargeActive(int idLivreur) const { return indexCharge.charge(idLivreur); }
+    QMap<int, int> chargesActives() const;
+    Livreur meilleurLivreur(const QString& zone) const;
+
+    // Comptages lus sur les cardinalités des bitmaps, sans matérialisation
+    QMap<QString, int> compterCommandesParStatut() const { return compter(commandesParStatut); }
+    QMap<QString, int> compterCommandesParVille() const { return compter(commandesParVille); }
+    QMap<QString, int> compterLivreursParZone() const { return compter(livreursParZone); }
+    int nombreLivreursDisponibles() const { return static_cast<int>(livreursDisponibles.cardinalite()); }
+    Livreur obtenirLivreur(int idLivreur) const { return livreurs.value(idLivreur); }
+    Commande obtenirCommande(int idCommande) const { return commandes.value(idCommande); }
+
+signals:
+    // Émis après une écriture, jamais pendant le chargement complet
+    void commandeModifiee(int idCommande);
+    void commandeRetiree(int idCommande);
+    void commandeLivree(int idCommande);
+    void chargeModifiee(int idLivreur, int charge);
+    void livreurModifie(int idLivreur);
+    void livreurRetire(int idLivreur);
+    void indexRecharge();
+
+private:
+    static BitmapCompresse reunionCles(const QMap<QString, BitmapCompresse>& bitmaps,
+                                       const QString& motif, Qt::CaseSensitivity casse);
+    void appliquerLivreurs(const ModificationsLivreurs& modifications);
+    static QMap<QString, int> compter(const QMap<QString, BitmapCompresse>& bitmaps);
+
+    QList<Commande> materialiserCommandes(const BitmapCompresse& ids) const;
+    QList<Livreur> materialiserLivreurs(const BitmapCompresse& ids) const;
+
+    bool charge;
+    CurseurJournal curseurJournal; // événements ORDER_EVENTS pris en compte
+    QDateTime filigraneLivreurs;   // écarts LIVREURS lus jusqu'à (horloge du serveur)
+    qint64 servies;
+    qint64 chargements;
+};
+
+#endif // INDEXFILTRES_H
@@ -0,0 +1,257 @@
+#include "InstantaneDonnees.h"
+#include "JournalEvenements.h"
+#include "db/DatabaseManager.h"
+#include "utils/Trace.h"
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QStandardPaths>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// Lecture des enregistrements après l'en-tête ; état du flux vérifié par l'appelant
+void lireEnregistrements(QDataStream& flux, qint64 taille, SourcesIndex& sources)
+{
+    // Statuts, villes, zones et véhicules se répètent : une seule copie
+    // partagée par valeur distincte
+    QHash<QString, QString> partagees;
+    auto partager = [&partagees](const QString& texte) {
+        auto it = partagees.constFind(texte);
+        if (it != partagees.constEnd()) {
+            return it.value();
+        }
+        partagees.insert(texte, texte);
+        return texte;
+    };
+
+    quint32 nombreCommandes = 0;
+    flux >> nombreCommandes;
+    // Nombre incohérent avec la taille : fichier tronqué ou corrompu
+    if (nombreCommandes > taille) {
+        flux.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    sources.commandes.reserve(nombreCommandes);
+    for (quint32 i = 0; i < nombreCommandes && flux.status() == QDataStream::Ok; ++i) {
+        qint32 id, client, livreur;
+        QDate date;
+        QString statut, ville;
+        QDateTime affectation, livraison;
+        flux >> id >> date >> statut >> ville >> client >> livreur >> affectation >> livraison;
+
+        Commande commande(id, date, partager(statut), partager(ville), client, livreur);
+        commande.setDateAffectation(affectation);
+        commande.setDateLivraison(livraison);
+        sources.commandes.append(commande);
+    }
+
+    quint32 nombreLivreurs = 0;
+    flux >> nombreLivreurs;
+    if (nombreLivreurs > taille) {
+        flux.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+    sources.livreurs.reserve(nombreLivreurs);
+    for (quint32 i = 0; i < nombreLivreurs && flux.status() == QDataStream::Ok; ++i) {
+        qint32 id;
+        QString nom, telephone, zone, vehicule;
+        bool disponible;
+        flux >> id >> nom >> telephone >> zone >> vehicule >> disponible;
+        sources.livreurs.append(Livreur(id, nom, telephone, partager(zone), partager(vehicule), disponible));
+    }
+}
+
+// Lignes de l'instantané remplacées par leur version modifiée ou retirées
+// si supprimées ; les lignes nouvelles ajoutées à la fin
+template <typename T>
+QList<T> fusionner(const QList<T>& lignes, const QList<T>& modifiees, const QList<int>& supprimees,
+                   int (T::*identifiant)() const)
+{
+    QHash<int, T> remplacements;
+    for (const T& ligne : modifiees) {
+        remplacements.insert((ligne.*identifiant)(), ligne);
+    }
+    const QSet<int> retirees(supprimees.begin(), supprimees.end());
+
+    QList<T> resultat;
+    resultat.reserve(lignes.size() + remplacements.size());
+    for (const T& ligne : lignes) {
+        const int id = (ligne.*identifiant)();
+        if (retirees.contains(id)) {
+            continue;
+        }
+        auto it = remplacements.find(id);
+        if (it != remplacements.end()) {
+            resultat.append(it.value());
+            remplacements.erase(it);
+        } else {
+            resultat.append(ligne);
+        }
+    }
+    for (const T& ligne : modifiees) {
+        if (remplacements.contains((ligne.*identifiant)())) {
+            resultat.append(ligne);
+        }
+    }
+    return resultat;
+}
+
+}
+
+QString InstantaneDonnees::chemin()
+{
+    const QString repertoire = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (repertoire.isEmpty() || !QDir().mkpath(repertoire)) {
+        return QString();
+    }
+    return repertoire + "/instantane.bin";
+}
+
+SourcesIndex InstantaneDonnees::lire()
+{
+    PorteeTrace portee("InstantaneDonnees::lire", "index");
+    SourcesIndex sources;
+
+    QFile fichier(chemin());
+    if (fichier.fileName().isEmpty() || !fichier.open(QIODevice::ReadOnly)) {
+        return sources;
+    }
+
+    // Projection mémoire : décodage direct des pages du fichier, sans copie
+    // préalable ; lecture classique si la plateforme la refuse
+    const qint64 taille = fichier.size();
+    uchar* projection = fichier.map(0, taille);
+    const QByteArray contenu = projection
+        ? QByteArray::fromRawData(reinterpret_cast<const char*>(projection), taille)
+        : fichier.readAll();
+
+    bool accepte = false;
+    {
+        QDataStream flux(contenu);
+        flux.setVersion(QDataStream::Qt_6_0);
+
+        quint32 signature = 0;
+        quint16 format = 0;
+        qint32 schema = 0;
+        QString base;
+        flux >> signature >> format >> schema >> base >> sources.filigrane >> sources.positionJournal;
+
+        if (flux.status() != QDataStream::Ok || signature != SIGNATURE || format != VERSION_FORMAT) {
+            qDebug() << "Instantané local illisible, ignoré";
+        } else if (schema != DatabaseManager::SCHEMA_VERSION ||
+                   base != DatabaseManager::getInstance()->identifiantBase()) {
+            qDebug() << "Instantané local d'un autre schéma ou d'une autre base, ignoré";
+        } else if (!sources.filigrane.isValid()) {
+            qDebug() << "Instantané local sans filigrane, ignoré";
+        } else {
+            lireEnregistrements(flux, taille, sources);
+            accepte = flux.status() == QDataStream::Ok;
+        }
+    }
+
+    if (projection) {
+        fichier.unmap(projection);
+    }
+    if (!accepte) {
+        return SourcesIndex();
+    }
+
+    sources.valide = true;
+    qDebug() << "Instantané local lu:" << sources.commandes.size() << "commandes,"
+             << sources.livreurs.size() << "livreurs, du" << sources.filigrane.toString(Qt::ISODate);
+    return sources;
+}
+
+bool InstantaneDonnees::ecrire(const SourcesIndex& sources)
+{
+    PorteeTrace portee("InstantaneDonnees::ecrire", "index");
+
+    QSaveFile fichier(chemin());
+    if (fichier.fileName().isEmpty() || !fichier.open(QIODevice::WriteOnly)) {
+        qWarning() << "Impossible d'écrire l'instantané local:" << fichier.fileName();
+        return false;
+    }
+
+    QDataStream flux(&fichier);
+    flux.setVersion(QDataStream::Qt_6_0);
+    flux << SIGNATURE << VERSION_FORMAT << qint32(DatabaseManager::SCHEMA_VERSION)
+         << DatabaseManager::getInstance()->identifiantBase()
+         << sources.filigrane << sources.positionJournal;
+
+    flux << quint32(sources.commandes.size());
+    for (const Commande& commande : sources.commandes) {
+        flux << qint32(commande.getIdCommande()) << commande.getDateCommande()
+             << commande.getStatut() << commande.getVilleLivraison()
+             << qint32(commande.getIdClient()) << qint32(commande.getIdLivreur())
+             << commande.getDateAffectation() << commande.getDateLivraison();
+    }
+
+    flux << quint32(sources.livreurs.size());
+    for (const Livreur& livreur : sources.livreurs) {
+        flux << qint32(livreur.getIdLivreur()) << livreur.getNom() << livreur.getTelephone()
+             << livreur.getZoneLivraison() << livreur.getVehicule() << livreur.getDisponibilite();
+    }
+
+    if (flux.status() != QDataStream::Ok) {
+        fichier.cancelWriting();
+        return false;
+    }
+    return fichier.commit();
+}
+
+ChargementDonnees InstantaneDonnees::actualiser(const SourcesIndex& instantane)
+{
+    PorteeTrace portee("InstantaneDonnees::actualiser", "index");
+    ChargementDonnees chargement;
+
+    if (!DatabaseManager::getInstance()->verifierSchema()) {
+        return chargement;
+    }
+
+    if (instantane.valide) {
+        // Position du journal avant les écarts : les écritures concurrentes
+        // seront rejouées par la synchronisation de l'index
+        const qint64 position = JournalEvenements().dernierePosition();
+        chargement.livreurs = LivreurService().obtenirModificationsDepuis(instantane.filigrane);
+        chargement.commandes = CommandeService().obtenirModificationsDepuis(instantane.filigrane);
+        if (chargement.commandes.filigrane.isValid() && chargement.livreurs.filigrane.isValid()) {
+            chargement.depuisInstantane = true;
+            chargement.sources = appliquer(instantane, chargement);
+            chargement.sources.positionJournal = position;
+            chargement.sources.valide = true;
+            ecrire(chargement.sources);
+            return chargement;
+        }
+        // Écarts indisponibles (instantané au-delà de la rétention des
+        // suppressions à l'horloge du serveur) : lecture complète
+        chargement = ChargementDonnees();
+    }
+
+    chargement.sources = IndexFiltres::lireSources();
+    chargement.sources.valide = true;
+    ecrire(chargement.sources);
+    return chargement;
+}
+
+SourcesIndex InstantaneDonnees::appliquer(const SourcesIndex& instantane, const ChargementDonnees& ecarts)
+{
+    SourcesIndex resultat;
+    // Le plus ancien des deux filigranes : rien n'échappe à la prochaine réconciliation
+    resultat.filigrane = std::min(ecarts.livreurs.filigrane, ecarts.commandes.filigrane);
+    resultat.commandes = fusionner(instantane.commandes, ecarts.commandes.modifiees,
+                                   ecarts.commandes.supprimees, &Commande::getIdCommande);
+    resultat.livreurs = fusionner(instantane.livreurs, ecarts.livreurs.modifies,
+                                  ecarts.livreurs.supprimes, &Livreur::getIdLivreur);
+
+    // Commandes d'un livreur supprimé : cascade FK, comme dans l'index
+    const QSet<int> livreursSupprimes(ecarts.livreurs.supprimes.begin(), ecarts.livreurs.supprimes.end());
+    resultat.commandes.removeIf([&livreursSupprimes](const Commande& commande) {
+        return livreursSupprimes.contains(commande.getIdLivreur());
+    });
+    return resultat;
+}
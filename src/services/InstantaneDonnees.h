@@ -0,0 +1,55 @@
+#ifndef INSTANTANEDONNEES_H
+#define INSTANTANEDONNEES_H
+
+#include <QString>
+#include "IndexFiltres.h"
+#include "CommandeService.h"
+#include "LivreurService.h"
+
+// Résultat du chargement de démarrage, préparé sur un fil du pool
+struct ChargementDonnees
+{
+    SourcesIndex sources;                // état à jour (celui de l'instantané écrit)
+    bool depuisInstantane = false;       // vrai : seuls les écarts sont à appliquer
+    ModificationsCommandes commandes;    // écarts depuis l'instantané
+    ModificationsLivreurs livreurs;
+};
+
+// Instantané relu et indexé sur un fil du pool, installé ensuite d'un bloc
+struct InstantaneIndexe
+{
+    SourcesIndex sources;                // sources.valide faux si absent ou écarté
+    ContenuIndex contenu;
+};
+
+// Instantané local des tables indexées (commandes, livreurs) : relu au
+// démarrage pour remplir les vues avant tout accès à la base, puis
+// réconcilié en arrière-plan par les écarts UPDATED_AT / SUPPRESSIONS.
+//
+// Format binaire versionné (QDataStream) lu par projection mémoire. Un
+// instantané est écarté si son format, la version du schéma ou la base
+// diffèrent, puis, à la réconciliation, s'il est plus ancien que la
+// rétention des suppressions à l'horloge du serveur (écarts alors
+// incomplets) : lecture complète à la place.
+class InstantaneDonnees
+{
+public:
+    static QString chemin();
+
+    // sources.valide faux si absent ou écarté
+    static SourcesIndex lire();
+    // Remplacement atomique du fichier (écriture puis renommage)
+    static bool ecrire(const SourcesIndex& sources);
+
+    // Depuis un fil du pool : schéma vérifié, écarts depuis l'instantané
+    // (lecture complète s'il n'est pas valide), nouvel instantané écrit
+    static ChargementDonnees actualiser(const SourcesIndex& instantane);
+
+private:
+    static SourcesIndex appliquer(const SourcesIndex& instantane, const ChargementDonnees& ecarts);
+
+    static constexpr quint32 SIGNATURE = 0x4C474953;   // « LGIS »
+    static constexpr quint16 VERSION_FORMAT = 1;
+};
+
+#endif // INSTANTANEDONNEES_H
@@ -0,0 +1,181 @@
+#include "JournalEvenements.h"
+#include "db/DatabaseManager.h"
+#include "db/InstrumentationRequetes.h"
+#include <QSqlError>
+
+EvenementCommande EvenementCommande::depuis(const QString& type, const Commande& commande,
+                                            const QString& statutPrecedent)
+{
+    EvenementCommande evenement;
+    evenement.idCommande = commande.getIdCommande();
+    evenement.type = type;
+    evenement.statutPrecedent = statutPrecedent;
+    evenement.statut = commande.getStatut();
+    evenement.idLivreur = commande.getIdLivreur();
+    evenement.villeLivraison = commande.getVilleLivraison();
+    evenement.dateCommande = commande.getDateCommande();
+    evenement.idClient = commande.getIdClient();
+    return evenement;
+}
+
+Commande EvenementCommande::versCommande() const
+{
+    return Commande(idCommande, dateCommande, statut, villeLivraison, idClient, idLivreur);
+}
+
+JournalEvenements::JournalEvenements()
+{
+}
+
+bool JournalEvenements::ecrire(const EvenementCommande& evenement)
+{
+    return ecrire(QList<EvenementCommande>{evenement});
+}
+
+bool JournalEvenements::ecrire(const QList<EvenementCommande>& evenements)
+{
+    if (evenements.isEmpty()) {
+        return true;
+    }
+
+    QVariantList idsCommandes, types, statutsPrecedents, statuts, idsLivreurs, villes, dates, idsClients;
+    for (const EvenementCommande& e : evenements) {
+        idsCommandes << e.idCommande;
+        types << e.type;
+        statutsPrecedents << (e.statutPrecedent.isEmpty() ? QVariant() : QVariant(e.statutPrecedent));
+        statuts << e.statut;
+        idsLivreurs << (e.idLivreur > 0 ? QVariant(e.idLivreur) : QVariant());
+        villes << e.villeLivraison;
+        dates << e.dateCommande;
+        idsClients << e.idClient;
+    }
+
+    // Un seul aller-retour pour tout le lot
+    QString query = "INSERT INTO ORDER_EVENTS (id_commande, type_evenement, statut_precedent, statut, "
+                   "id_livreur, ville_livraison, date_commande, id_client) "
+                   "VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
+    QSqlQuery result = DatabaseManager::getInstance()->executeBatchQuery(query,
+        {idsCommandes, types, statutsPrecedents, statuts, idsLivreurs, villes, dates, idsClients});
+    return !result.lastError().isValid();
+}
+
+bool JournalEvenements::journaliserSuppressionsLivreur(int idLivreur)
+{
+    // À exécuter avant le DELETE : les commandes partent en cascade
+    QString query = "INSERT INTO ORDER_EVENTS (id_commande, type_evenement, statut_precedent, statut, "
+                   "id_livreur, ville_livraison, date_commande, id_client) "
+                   "SELECT id_commande, 'SUPPRESSION', statut, statut, id_livreur, "
+                   "ville_livraison, date_commande, id_client FROM COMMANDES WHERE id_livreur = ?";
+    QSqlQuery result = DatabaseManager::getInstance()->executePreparedQuery(query, {idLivreur});
+    return !result.lastError().isValid();
+}
+
+QList<EvenementCommande> JournalEvenements::lire(qint64 depuis, int limite)
+{
+    QList<EvenementCommande> evenements;
+    DatabaseManager* db = DatabaseManager::getInstance();
+    QString query = "SELECT * FROM ORDER_EVENTS WHERE id_evenement > ? ORDER BY id_evenement ";
+    query += db->isSqlite() ? "LIMIT ?" : "FETCH FIRST ? ROWS ONLY";
+
+    QSqlQuery result = db->executePreparedQuery(query, {depuis, limite});
+    while (result.next()) {
+        evenements.append(mapFromQuery(result));
+    }
+    return evenements;
+}
+
+qint64 JournalEvenements::rejouer(qint64 depuis,
+                                  const std::function<void(const EvenementCommande&)>& consommateur,
+                                  int tailleLot)
+{
+    qint64 position = depuis;
+    while (true) {
+        const QList<EvenementCommande> lot = lire(position, tailleLot);
+        for (const EvenementCommande& evenement : lot) {
+            consommateur(evenement);
+            position = evenement.idEvenement;
+        }
+        if (lot.size() < tailleLot) {
+            break;
+        }
+    }
+    return position;
+}
+
+void JournalEvenements::rejouer(CurseurJournal& curseur,
+                                const std::function<void(const EvenementCommande&)>& consommateur,
+                                int tailleLot)
+{
+    auto consommer = [&curseur, &consommateur](const EvenementCommande& evenement) {
+        if (curseur.fenetre.contains(evenement.idEvenement)) {
+            return;
+        }
+        curseur.fenetre.insert(evenement.idEvenement, evenement.horodatage);
+        if (!curseur.horodatage.isValid() || evenement.horodatage > curseur.horodatage) {
+            curseur.horodatage = evenement.horodatage;
+        }
+        consommateur(evenement);
+    };
+
+    // Validés en retard sous la position déjà atteinte
+    if (curseur.horodatage.isValid()) {
+        const QDateTime depuisLe = curseur.horodatage.addSecs(-DatabaseManager::WATERMARK_MARGIN_SECS);
+        for (const EvenementCommande& evenement : lireFenetre(depuisLe, curseur.position)) {
+            consommer(evenement);
+        }
+    }
+    curseur.position = rejouer(curseur.position, consommer, tailleLot);
+
+    // Sortis de la fenêtre : plus jamais relus, inutile de les retenir
+    const QDateTime limite = curseur.horodatage.addSecs(-DatabaseManager::WATERMARK_MARGIN_SECS);
+    for (auto it = curseur.fenetre.begin(); it != curseur.fenetre.end();) {
+        if (it.value() < limite) {
+            it = curseur.fenetre.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QList<EvenementCommande> JournalEvenements::lireFenetre(const QDateTime& depuisLe, qint64 jusqua)
+{
+    // Index IDX_ORDER_EVENTS_CREATED_AT : quelques secondes d'événements
+    QList<EvenementCommande> evenements;
+    DatabaseManager* db = DatabaseManager::getInstance();
+    const QString query = QString("SELECT * FROM ORDER_EVENTS WHERE created_at >= %1 AND id_evenement <= ? "
+                                  "ORDER BY id_evenement").arg(db->isSqlite() ? "datetime(?)" : "?");
+
+    QSqlQuery result = db->executePreparedQuery(query, {depuisLe, jusqua});
+    while (result.next()) {
+        evenements.append(mapFromQuery(result));
+    }
+    return evenements;
+}
+
+qint64 JournalEvenements::dernierePosition()
+{
+    QSqlQuery result = DatabaseManager::getInstance()->executeQuery(
+        "SELECT COALESCE(MAX(id_evenement), 0) as position FROM ORDER_EVENTS");
+    if (result.next()) {
+        return result.value("position").toLongLong();
+    }
+    return 0;
+}
+
+EvenementCommande JournalEvenements::mapFromQuery(const QSqlQuery& query)
+{
+    InstrumentationRequetes::getInstance()->ligneLue(query);
+
+    EvenementCommande evenement;
+    evenement.idEvenement = query.value("id_evenement").toLongLong();
+    evenement.idCommande = query.value("id_commande").toInt();
+    evenement.type = query.value("type_evenement").toString();
+    evenement.statutPrecedent = query.value("statut_precedent").toString();
+    evenement.statut = query.value("statut").toString();
+    evenement.idLivreur = query.value("id_livreur").toInt();
+    evenement.villeLivraison = query.value("ville_livraison").toString();
+    evenement.dateCommande = query.value("date_commande").toDate();
+    evenement.idClient = query.value("id_client").toInt();
+    evenement.horodatage = query.value("created_at").toDateTime();
+    return evenement;
+}
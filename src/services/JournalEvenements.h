@@ -0,0 +1,77 @@
+#ifndef JOURNALEVENEMENTS_H
+#define JOURNALEVENEMENTS_H
+
+#include <QList>
+#include <QString>
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QVariant>
+#include <QSqlQuery>
+#include <functional>
+#include "entities/Commande.h"
+
+// Événement du cycle de vie d'une commande (ligne de ORDER_EVENTS). Il porte
+// l'état complet de la commande après la transition, ce qui suffit à
+// reconstruire l'état courant en rejouant le journal.
+// Types : CREATION, MODIFICATION, AFFECTATION, SUPPRESSION
+struct EvenementCommande
+{
+    qint64 idEvenement = 0;
+    int idCommande = 0;
+    QString type;
+    QString statutPrecedent;
+    QString statut;
+    int idLivreur = 0;
+    QString villeLivraison;
+    QDate dateCommande;
+    int idClient = 0;
+    QDateTime horodatage;
+
+    static EvenementCommande depuis(const QString& type, const Commande& commande,
+                                    const QString& statutPrecedent = QString());
+    Commande versCommande() const;
+};
+
+// Position de lecture du journal avec fenêtre de relecture. Les identifiants
+// ne sont pas attribués dans l'ordre de validation (sessions concurrentes) :
+// un événement d'identifiant inférieur validé après la lecture précédente est
+// rattrapé en relisant les WATERMARK_MARGIN_SECS qui précèdent le dernier
+// événement lu, dédoublonnés par identifiant.
+struct CurseurJournal
+{
+    qint64 position = 0;                 // plus grand identifiant lu
+    QDateTime horodatage;                // CREATED_AT le plus récent lu (horloge du serveur)
+    QHash<qint64, QDateTime> fenetre;    // identifiants déjà lus dans la fenêtre
+};
+
+// Journal en ajout seul des transitions de commandes. L'écriture se fait dans
+// la transaction de l'appelant, en un seul lot ; la lecture se fait à partir
+// d'une position (identifiant d'événement) pour les consommateurs.
+class JournalEvenements
+{
+public:
+    JournalEvenements();
+
+    // Écriture (transaction ouverte par l'appelant)
+    bool ecrire(const EvenementCommande& evenement);
+    bool ecrire(const QList<EvenementCommande>& evenements);
+    // Variante ensembliste : état relu dans COMMANDES par la même requête
+    bool journaliserSuppressionsLivreur(int idLivreur);
+
+    // Lecture des événements d'identifiant strictement supérieur à depuis
+    QList<EvenementCommande> lire(qint64 depuis, int limite = 1000);
+    // Parcours par pages ; renvoie la position du dernier événement traité
+    qint64 rejouer(qint64 depuis, const std::function<void(const EvenementCommande&)>& consommateur,
+                   int tailleLot = 1000);
+    // Événements pas encore vus par le curseur, fenêtre de relecture comprise
+    void rejouer(CurseurJournal& curseur, const std::function<void(const EvenementCommande&)>& consommateur,
+                 int tailleLot = 1000);
+    qint64 dernierePosition();
+
+private:
+    QList<EvenementCommande> lireFenetre(const QDateTime& depuisLe, qint64 jusqua);
+    EvenementCommande mapFromQuery(const QSqlQuery& query);
+};
+
+#endif // JOURNALEVENEMENTS_H
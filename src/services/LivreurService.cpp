@@ -1,18 +1,30 @@
 #include "LivreurService.h"
+#include "IndexFiltres.h"
+#include "JournalEvenements.h"
+#include "ModeleCapacite.h"
+#include "MoniteurSurcharge.h"
+#include "PlanificateurTournees.h"
 #include "db/DatabaseManager.h"
+#include "db/InstrumentationRequetes.h"
+#include "utils/ExportTableur.h"
+#include "utils/Trace.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QDebug>
 #include <QDate>
+#include <QPdfWriter>
+#include <QPainter>
 
 LivreurService::LivreurService(QObject *parent)
     : QObject(parent)
 {
 }
 
-bool LivreurService::ajouterLivreur(const Livreur& livreur)
+bool LivreurService::ajouterLivreur(const Livreur& livreur, Livreur* resultat)
 {
+    PorteeTrace portee("LivreurService::ajouterLivreur", "service");
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     
     QString query = "INSERT INTO LIVREURS (nom, telephone, zone_livraison, vehicule, disponibilite) "
@@ -25,8 +37,20 @@ bool LivreurService::ajouterLivreur(const Livreur& livreur)
            << livreur.getVehicule()
            << (livreur.getDisponibilite() ? 1 : 0);
     
-    QSqlQuery result = db->executePreparedQuery(query, values);
-    return !result.lastError().isValid();
+    // Identifiant généré renvoyé par l'insertion elle-même
+    QVariantList generes = db->executeInsertReturning(query, values, {"id_livreur"});
+    if (generes.isEmpty() || generes.first().toInt() <= 0) {
+        return false;
+    }
+    
+    Livreur cree = livreur;
+    cree.setIdLivreur(generes.first().toInt());
+    IndexFiltres::getInstance()->livreurEnregistre(cree);
+    
+    if (resultat) {
+        *resultat = cree;
+    }
+    return true;
 }
 
 Livreur LivreurService::obtenirLivreur(int id)
@@ -48,12 +72,16 @@ Livreur LivreurService::obtenirLivreur(int id)
 
 QList<Livreur> LivreurService::obtenirTousLivreurs()
 {
+    PorteeTrace portee("LivreurService::obtenirTousLivreurs", "service");
+    
     QList<Livreur> livreurs;
     DatabaseManager* db = DatabaseManager::getInstance();
     
     QString query = "SELECT * FROM LIVREURS ORDER BY nom";
     QSqlQuery result = db->executePreparedQuery(query, {});
     
+    // Lecture et conversion des lignes, hors exécution de la requête
+    PorteeTrace lecture("LivreurService::mapFromQuery", "mapping");
     while (result.next()) {
         livreurs.append(mapFromQuery(result));
     }
@@ -63,6 +91,8 @@ QList<Livreur> LivreurService::obtenirTousLivreurs()
 
 bool LivreurService::modifierLivreur(const Livreur& livreur)
 {
+    PorteeTrace portee("LivreurService::modifierLivreur", "service");
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     
     QString query = "UPDATE LIVREURS SET nom = ?, telephone = ?, zone_livraison = ?, "
@@ -77,11 +107,18 @@ bool LivreurService::modifierLivreur(const Livreur& livreur)
            << livreur.getIdLivreur();
     
     QSqlQuery result = db->executePreparedQuery(query, values);
-    return !result.lastError().isValid();
+    if (result.lastError().isValid()) {
+        return false;
+    }
+    
+    IndexFiltres::getInstance()->livreurEnregistre(livreur);
+    return true;
 }
 
 bool LivreurService::supprimerLivreur(int id)
 {
+    PorteeTrace portee("LivreurService::supprimerLivreur", "service");
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     
     // D'abord, compter les commandes qui seront supprimées en cascade
@@ -99,22 +136,43 @@ bool LivreurService::supprimerLivreur(int id)
     QVariantList values;
     values << id;
     
+    // Commandes supprimées en cascade : journalisées dans la même transaction
+    if (!db->beginTransaction()) {
+        return false;
+    }
+    
+    JournalEvenements journal;
+    if (!journal.journaliserSuppressionsLivreur(id)) {
+        db->rollbackTransaction();
+        return false;
+    }
+    
     QSqlQuery result = db->executePreparedQuery(query, values);
     
-    if (!result.lastError().isValid()) {
+    if (!result.lastError().isValid() && db->commitTransaction()) {
         qDebug() << "Livreur supprimé avec succès (ID:" << id << ")";
+        IndexFiltres::getInstance()->livreurSupprime(id);
         if (commandesASupprimer > 0) {
             qDebug() << "Commandes associées supprimées automatiquement:" << commandesASupprimer;
         }
         return true;
     } else {
         qDebug() << "Erreur suppression livreur:" << result.lastError().text();
+        db->rollbackTransaction();
         return false;
     }
 }
 
 QList<Livreur> LivreurService::rechercherLivreurs(const QString& nom, const QString& zone, bool disponibiliteSeule)
 {
+    PorteeTrace portee("LivreurService::rechercherLivreurs", "service");
+    
+    // Résolution par l'index bitmap en mémoire, sans aller-retour base
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->filtrerLivreurs(nom, zone, disponibiliteSeule);
+    }
+    
     QList<Livreur> livreurs;
     DatabaseManager* db = DatabaseManager::getInstance();
     
@@ -139,6 +197,7 @@ QList<Livreur> LivreurService::rechercherLivreurs(const QString& nom, const QStr
     
     QSqlQuery result = db->executePreparedQuery(query, values);
     
+    PorteeTrace lecture("LivreurService::mapFromQuery", "mapping");
     while (result.next()) {
         livreurs.append(mapFromQuery(result));
     }
@@ -146,6 +205,43 @@ QList<Livreur> LivreurService::rechercherLivreurs(const QString& nom, const QStr
     return livreurs;
 }
 
+ModificationsLivreurs LivreurService::obtenirModificationsDepuis(const QDateTime& filigrane)
+{
+    PorteeTrace portee("LivreurService::obtenirModificationsDepuis", "service");
+    
+    ModificationsLivreurs modifications;
+    DatabaseManager* db = DatabaseManager::getInstance();
+    
+    // Nouveau filigrane lu avant les lignes : rien ne peut être manqué
+    modifications.filigrane = db->currentServerTime();
+    
+    // Rétention des suppressions jugée à l'horloge du serveur, celle des
+    // filigranes : filigrane invalide, l'appelant relit tout
+    if (!modifications.filigrane.isValid() || !filigrane.isValid() ||
+        filigrane.daysTo(modifications.filigrane) >= DatabaseManager::DELETION_RETENTION_DAYS) {
+        modifications.filigrane = QDateTime();
+        return modifications;
+    }
+    QDateTime depuis = filigrane.addSecs(-DatabaseManager::WATERMARK_MARGIN_SECS);
+    // Dates SQLite en texte : le paramètre lié est ramené au format des triggers
+    const QString borne = db->isSqlite() ? "datetime(?)" : "?";
+    
+    QSqlQuery result = db->executePreparedQuery(
+        "SELECT * FROM LIVREURS WHERE updated_at >= " + borne + " ORDER BY nom", {depuis});
+    PorteeTrace lecture("LivreurService::mapFromQuery", "mapping");
+    while (result.next()) {
+        modifications.modifies.append(mapFromQuery(result));
+    }
+    
+    QSqlQuery supprimes = db->executePreparedQuery(
+        "SELECT id_ligne FROM SUPPRESSIONS WHERE nom_table = 'LIVREURS' AND deleted_at >= " + borne, {depuis});
+    while (supprimes.next()) {
+        modifications.supprimes.append(supprimes.value("id_ligne").toInt());
+    }
+    
+    return modifications;
+}
+
 QList<Livreur> LivreurService::trierLivreurs(const QString& critere, bool croissant)
 {
     QList<Livreur> livreurs;
@@ -169,6 +265,7 @@ QList<Livreur> LivreurService::trierLivreurs(const QString& critere, bool croiss
     
     QSqlQuery result = db->executePreparedQuery(query, {});
     
+    PorteeTrace lecture("LivreurService::mapFromQuery", "mapping");
     while (result.next()) {
         livreurs.append(mapFromQuery(result));
     }
@@ -178,6 +275,8 @@ QList<Livreur> LivreurService::trierLivreurs(const QString& critere, bool croiss
 
 bool LivreurService::mettreAJourDisponibilite(int idLivreur, bool disponible)
 {
+    PorteeTrace portee("LivreurService::mettreAJourDisponibilite", "service");
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     
     QString query = "UPDATE livreurs SET disponibilite = ? WHERE id_livreur = ?";
@@ -185,17 +284,30 @@ bool LivreurService::mettreAJourDisponibilite(int idLivreur, bool disponible)
     values << (disponible ? 1 : 0) << idLivreur;
     
     QSqlQuery result = db->executePreparedQuery(query, values);
-    return !result.lastError().isValid();
+    if (result.lastError().isValid()) {
+        return false;
+    }
+    
+    IndexFiltres::getInstance()->disponibiliteModifiee(idLivreur, disponible);
+    return true;
 }
 
 QList<Livreur> LivreurService::obtenirLivreursDisponibles()
 {
+    PorteeTrace portee("LivreurService::obtenirLivreursDisponibles", "service");
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->filtrerLivreurs("", "", true);
+    }
+    
     QList<Livreur> livreurs;
     DatabaseManager* db = DatabaseManager::getInstance();
     
     QString query = "SELECT * FROM LIVREURS WHERE disponibilite = 1 ORDER BY nom";
     QSqlQuery result = db->executePreparedQuery(query, {});
     
+    PorteeTrace lecture("LivreurService::mapFromQuery", "mapping");
     while (result.next()) {
         livreurs.append(mapFromQuery(result));
     }
@@ -205,21 +317,38 @@ QList<Livreur> LivreurService::obtenirLivreursDisponibles()
 
 QList<Livreur> LivreurService::obtenirLivreursSurcharges()
 {
+    PorteeTrace portee("LivreurService::obtenirLivreursSurcharges", "service");
+    
     QList<Livreur> livreursSurcharges;
+
+    // État tenu à jour par le moniteur à chaque changement de charge
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        for (int id : MoniteurSurcharge::getInstance()->livreursSurcharges()) {
+            livreursSurcharges.append(index->obtenirLivreur(id));
+        }
+        return livreursSurcharges;
+    }
+
     DatabaseManager* db = DatabaseManager::getInstance();
     
+    // Le seuil dépend du véhicule : comparaison faite après lecture
     QString query = "SELECT l.id_livreur, l.nom, l.telephone, l.zone_livraison, l.vehicule, l.disponibilite, COUNT(c.id_commande) as nb_commandes "
                    "FROM LIVREURS l "
                    "LEFT JOIN COMMANDES c ON l.id_livreur = c.id_livreur "
                    "AND c.statut IN ('En attente', 'En cours') "
                    "GROUP BY l.id_livreur, l.nom, l.telephone, l.zone_livraison, l.vehicule, l.disponibilite "
-                   "HAVING COUNT(c.id_commande) > 5 "
+                   "HAVING COUNT(c.id_commande) > 0 "
                    "ORDER BY nb_commandes DESC";
     
     QSqlQuery result = db->executePreparedQuery(query, {});
     
+    ModeleCapacite* capacites = ModeleCapacite::getInstance();
     while (result.next()) {
-        livreursSurcharges.append(mapFromQuery(result));
+        Livreur livreur = mapFromQuery(result);
+        if (result.value("nb_commandes").toInt() > capacites->capacite(livreur)) {
+            livreursSurcharges.append(livreur);
+        }
     }
     
     return livreursSurcharges;
@@ -227,11 +356,21 @@ QList<Livreur> LivreurService::obtenirLivreursSurcharges()
 
 Livreur LivreurService::obtenirMeilleurLivreur(const QString& zone)
 {
+    PorteeTrace portee("LivreurService::obtenirMeilleurLivreur", "service");
+    
+    // Lecture en tête de l'index de charge, sans agrégation SQL
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->meilleurLivreur(zone);
+    }
+    
     DatabaseManager* db = DatabaseManager::getInstance();
     
+    // Seules les commandes actives comptent dans la charge
     QString query = "SELECT l.id_livreur, l.nom, l.telephone, l.zone_livraison, l.vehicule, l.disponibilite, COUNT(c.id_commande) as nb_commandes "
                    "FROM LIVREURS l "
                    "LEFT JOIN COMMANDES c ON l.id_livreur = c.id_livreur "
+                   "AND c.statut IN ('En attente', 'En cours') "
                    "WHERE l.disponibilite = 1";
     
     QVariantList values;
@@ -254,6 +393,8 @@ Livreur LivreurService::obtenirMeilleurLivreur(const QString& zone)
 
 QMap<QString, int> LivreurService::obtenirStatistiquesParZone()
 {
+    PorteeTrace portee("LivreurService::obtenirStatistiquesParZone", "service");
+    
     QMap<QString, int> statistiques;
     DatabaseManager* db = DatabaseManager::getInstance();
     
@@ -275,6 +416,8 @@ QMap<QString, int> LivreurService::obtenirStatistiquesParZone()
 
 QMap<bool, int> LivreurService::obtenirStatistiquesDisponibilite()
 {
+    PorteeTrace portee("LivreurService::obtenirStatistiquesDisponibilite", "service");
+    
     QMap<bool, int> statistiques;
     DatabaseManager* db = DatabaseManager::getInstance();
     
@@ -295,6 +438,13 @@ QMap<bool, int> LivreurService::obtenirStatistiquesDisponibilite()
 
 QMap<int, int> LivreurService::obtenirStatistiquesChargesDeTravail()
 {
+    PorteeTrace portee("LivreurService::obtenirStatistiquesChargesDeTravail", "service");
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->chargesActives();
+    }
+    
     QMap<int, int> statistiques;
     DatabaseManager* db = DatabaseManager::getInstance();
     
@@ -318,22 +468,139 @@ QMap<int, int> LivreurService::obtenirStatistiquesChargesDeTravail()
 
 bool LivreurService::genererRapportLivreurs(const QString& cheminFichier)
 {
-    // TODO: Implémenter la génération de rapport PDF
-    Q_UNUSED(cheminFichier)
-    qDebug() << "Génération de rapport PDF pour les livreurs - À implémenter";
+    PorteeTrace portee("LivreurService::genererRapportLivreurs", "rapport", cheminFichier);
+    
+    QList<Livreur> livreurs = obtenirTousLivreurs();
+    
+    // Tournées de tous les livreurs, optimisées en parallèle
+    PlanificateurTournees planificateur;
+    QList<Tournee> tournees = planificateur.planifier(livreurs);
+    
+    QPdfWriter writer(cheminFichier);
+    writer.setPageSize(QPageSize::A4);
+    writer.setResolution(300); // 300 DPI pour une meilleure qualité
+    
+    QPainter painter(&writer);
+    
+    // Configuration des dimensions (en unités de périphérique)
+    int pageWidth = writer.width();
+    int pageHeight = writer.height();
+    int margin = pageWidth / 20; // Marge de 5%
+    int lineHeight = pageHeight / 60; // Hauteur de ligne adaptée
+    int y = margin;
+    
+    // Titre principal
+    painter.setFont(QFont("Arial", 18, QFont::Bold));
+    painter.drawText(margin, y, "RAPPORT DES LIVREURS");
+    y += lineHeight * 2;
+    
+    // Informations générales
+    painter.setFont(QFont("Arial", 12));
+    painter.drawText(margin, y, QString("Date de génération: %1").arg(QDate::currentDate().toString("dd/MM/yyyy")));
+    y += lineHeight;
+    painter.drawText(margin, y, QString("Nombre total de livreurs: %1").arg(livreurs.size()));
+    y += lineHeight * 2;
+    
+    // En-têtes du tableau
+    painter.setFont(QFont("Arial", 10, QFont::Bold));
+    int col1 = margin;
+    int col2 = margin + pageWidth / 12;
+    int col3 = margin + 3 * pageWidth / 10;
+    int col4 = margin + pageWidth / 2;
+    int col5 = margin + 7 * pageWidth / 10;
+    
+    painter.drawText(col1, y, "ID");
+    painter.drawText(col2, y, "Nom");
+    painter.drawText(col3, y, "Zone");
+    painter.drawText(col4, y, "Véhicule");
+    painter.drawText(col5, y, "Statut");
+    y += lineHeight;
+    
+    // Ligne de séparation
+    painter.drawLine(margin, y, pageWidth - margin, y);
+    y += lineHeight / 2;
+    
+    // Données
+    painter.setFont(QFont("Arial", 9));
+    for (const Livreur& livreur : livreurs) {
+        if (y > pageHeight - margin * 2) { // Nouvelle page si nécessaire
+            writer.newPage();
+            y = margin;
+        }
+        
+        painter.drawText(col1, y, QString::number(livreur.getIdLivreur()));
+        painter.drawText(col2, y, livreur.getNom());
+        painter.drawText(col3, y, livreur.getZoneLivraison());
+        painter.drawText(col4, y, livreur.getVehicule());
+        painter.drawText(col5, y, livreur.getDisponibiliteText());
+        y += lineHeight;
+    }
+    
+    // Section des tournées planifiées
+    y += lineHeight;
+    if (y > pageHeight - margin * 4) {
+        writer.newPage();
+        y = margin;
+    }
+    painter.setFont(QFont("Arial", 14, QFont::Bold));
+    painter.drawText(margin, y, "TOURNÉES PLANIFIÉES");
+    y += lineHeight * 2;
+    
+    for (int i = 0; i < tournees.size(); ++i) {
+        const Tournee& tournee = tournees[i];
+        if (tournee.etapes.isEmpty()) continue;
+        
+        if (y > pageHeight - margin * 3) {
+            writer.newPage();
+            y = margin;
+        }
+        
+        painter.setFont(QFont("Arial", 10, QFont::Bold));
+        painter.drawText(margin, y, QString("%1 - %2 commande(s) - %3 km")
+                         .arg(livreurs[i].getNom())
+                         .arg(tournee.etapes.size())
+                         .arg(tournee.distanceKm, 0, 'f', 0));
+        y += lineHeight;
+        
+        painter.setFont(QFont("Arial", 9));
+        QRect zoneTexte(margin, y - lineHeight + lineHeight / 4, pageWidth - 2 * margin, lineHeight * 3);
+        QRect utilise;
+        painter.drawText(zoneTexte, Qt::TextWordWrap, tournee.itineraire(), &utilise);
+        y += utilise.height() + lineHeight / 2;
+    }
+    
     return true;
 }
 
 bool LivreurService::genererListeLivreurs(const QString& cheminFichier)
 {
-    // TODO: Implémenter la génération de liste Excel
-    Q_UNUSED(cheminFichier)
-    qDebug() << "Génération de liste Excel pour les livreurs - À implémenter";
-    return true;
+    PorteeTrace portee("LivreurService::genererListeLivreurs", "rapport", cheminFichier);
+    
+    QList<Livreur> livreurs = obtenirTousLivreurs();
+    ModeleCapacite* modele = ModeleCapacite::getInstance();
+    
+    QList<QVariantList> lignes;
+    for (const Livreur& livreur : livreurs) {
+        lignes << QVariantList{livreur.getIdLivreur(),
+                               livreur.getNom(),
+                               livreur.getTelephone(),
+                               livreur.getZoneLivraison(),
+                               livreur.getVehicule(),
+                               livreur.getDisponibilite(),
+                               compterCommandesActives(livreur.getIdLivreur()),
+                               modele->capacite(livreur)};
+    }
+    
+    // Format selon l'extension : .xlsx (par défaut) ou .csv
+    return ExportTableur::enregistrer(cheminFichier, "Livreurs",
+        {"ID", "Nom", "Téléphone", "Zone", "Véhicule", "Disponible", "Commandes actives", "Capacité"},
+        lignes);
 }
 
 Livreur LivreurService::mapFromQuery(const QSqlQuery& query)
 {
+    InstrumentationRequetes::getInstance()->ligneLue(query);
+
     Livreur livreur;
     livreur.setIdLivreur(query.value("id_livreur").toInt());
     livreur.setNom(query.value("nom").toString());
@@ -344,22 +611,13 @@ Livreur LivreurService::mapFromQuery(const QSqlQuery& query)
     return livreur;
 }
 
-int LivreurService::obtenirProchainId()
+int LivreurService::compterCommandesActives(int idLivreur)
 {
-    DatabaseManager* db = DatabaseManager::getInstance();
-    
-    QString query = "SELECT COALESCE(MAX(id_livreur), 0) + 1 as next_id FROM livreurs";
-    QSqlQuery result = db->executePreparedQuery(query, {});
-    
-    if (result.next()) {
-        return result.value("next_id").toInt();
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (index->assurerChargement()) {
+        return index->chargeActive(idLivreur);
     }
     
-    return 1;
-}
-
-int LivreurService::compterCommandesActives(int idLivreur)
-{
     DatabaseManager* db = DatabaseManager::getInstance();
     
     QString query = "SELECT COUNT(*) as nombre FROM commandes "
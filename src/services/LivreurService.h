@@ -5,10 +5,19 @@
 #include <QList>
 #include <QMap>
 #include <QString>
+#include <QDateTime>
 #include "entities/Livreur.h"
 
 class QSqlQuery;
 
+// Lignes modifiées ou supprimées depuis un filigrane (UPDATED_AT)
+struct ModificationsLivreurs
+{
+    QList<Livreur> modifies;     // insérés ou mis à jour
+    QList<int> supprimes;
+    QDateTime filigrane;         // à fournir à l'appel suivant
+};
+
 class LivreurService : public QObject
 {
     Q_OBJECT
@@ -17,7 +26,8 @@ public:
     explicit LivreurService(QObject *parent = nullptr);
 
     // CRUD de base
-    bool ajouterLivreur(const Livreur& livreur);
+    // resultat : livreur avec l'identifiant généré
+    bool ajouterLivreur(const Livreur& livreur, Livreur* resultat = nullptr);
     Livreur obtenirLivreur(int id);
     QList<Livreur> obtenirTousLivreurs();
     bool modifierLivreur(const Livreur& livreur);
@@ -29,6 +39,11 @@ public:
                                      bool disponibiliteSeule = false);
     QList<Livreur> trierLivreurs(const QString& critere, bool croissant = true);
 
+    // Synchronisation différentielle des vues ; filigrane du résultat
+    // invalide si la lecture échoue ou si filigrane dépasse la rétention
+    // des suppressions (relecture complète à faire)
+    ModificationsLivreurs obtenirModificationsDepuis(const QDateTime& filigrane);
+
     // Fonctionnalités métier
     bool mettreAJourDisponibilite(int idLivreur, bool disponible);
     QList<Livreur> obtenirLivreursDisponibles();
@@ -50,7 +65,6 @@ public:
     
 private:
     Livreur mapFromQuery(const QSqlQuery& query);
-    int obtenirProchainId();
 };
 
 #endif // LIVREURSERVICE_H
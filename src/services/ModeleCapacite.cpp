@@ -0,0 +1,98 @@
+#include "ModeleCapacite.h"
+#include "TableDistances.h"
+#include <QSettings>
+
+ModeleCapacite* ModeleCapacite::instance = nullptr;
+
+ModeleCapacite::ModeleCapacite()
+{
+    charger();
+}
+
+ModeleCapacite* ModeleCapacite::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new ModeleCapacite();
+    }
+    return instance;
+}
+
+void ModeleCapacite::charger()
+{
+    // Valeurs par défaut, remplacées par celles enregistrées
+    capacitesType = {
+        {"Velo", 3},
+        {"Moto", 5},
+        {"Voiture", 8},
+        {"Camionnette", 15}
+    };
+
+    QSettings settings;
+    settings.beginGroup("CapacitesVehicules");
+    for (const QString& type : settings.childKeys()) {
+        capacitesType[typeConnu(type)] = settings.value(type).toInt();
+    }
+    settings.endGroup();
+
+    settings.beginGroup("CapacitesLivreurs");
+    for (const QString& cle : settings.childKeys()) {
+        capacitesLivreur[cle.toInt()] = settings.value(cle).toInt();
+    }
+    settings.endGroup();
+}
+
+QString ModeleCapacite::typeVehicule(const QString& vehicule) const
+{
+    const QString libelle = TableDistances::normaliser(vehicule);
+    for (auto it = capacitesType.constBegin(); it != capacitesType.constEnd(); ++it) {
+        if (libelle.contains(TableDistances::normaliser(it.key()))) {
+            return it.key();
+        }
+    }
+    return QString();
+}
+
+QString ModeleCapacite::typeConnu(const QString& type) const
+{
+    const QString normalise = TableDistances::normaliser(type);
+    for (auto it = capacitesType.constBegin(); it != capacitesType.constEnd(); ++it) {
+        if (TableDistances::normaliser(it.key()) == normalise) {
+            return it.key();
+        }
+    }
+    return type;
+}
+
+int ModeleCapacite::capaciteVehicule(const QString& vehicule) const
+{
+    const QString type = typeVehicule(vehicule);
+    return type.isEmpty() ? CAPACITE_PAR_DEFAUT : capacitesType.value(type);
+}
+
+int ModeleCapacite::capacite(const Livreur& livreur) const
+{
+    auto it = capacitesLivreur.constFind(livreur.getIdLivreur());
+    if (it != capacitesLivreur.constEnd()) {
+        return it.value();
+    }
+    return capaciteVehicule(livreur.getVehicule());
+}
+
+void ModeleCapacite::definirCapaciteType(const QString& type, int capacite)
+{
+    const QString cle = typeConnu(type);
+    capacitesType[cle] = capacite;
+    QSettings().setValue("CapacitesVehicules/" + cle, capacite);
+}
+
+void ModeleCapacite::definirCapaciteLivreur(int idLivreur, int capacite)
+{
+    capacitesLivreur[idLivreur] = capacite;
+    QSettings().setValue(QString("CapacitesLivreurs/%1").arg(idLivreur), capacite);
+}
+
+void ModeleCapacite::supprimerCapaciteLivreur(int idLivreur)
+{
+    capacitesLivreur.remove(idLivreur);
+    QSettings().remove(QString("CapacitesLivreurs/%1").arg(idLivreur));
+}
@@ -0,0 +1,47 @@
+#ifndef MODELECAPACITE_H
+#define MODELECAPACITE_H
+
+#include <QMap>
+#include <QHash>
+#include <QString>
+#include "entities/Livreur.h"
+
+// Capacité maximale de commandes actives d'un livreur : valeur par type de
+// véhicule, avec surcharge possible pour un livreur donné. Les valeurs sont
+// conservées dans les paramètres de l'application (QSettings).
+class ModeleCapacite
+{
+private:
+    static ModeleCapacite* instance;
+
+    ModeleCapacite();
+
+public:
+    static ModeleCapacite* getInstance();
+
+    // Capacité effective d'un livreur (surcharge individuelle, sinon véhicule)
+    int capacite(const Livreur& livreur) const;
+    int capaciteVehicule(const QString& vehicule) const;
+
+    // Type de véhicule reconnu dans le libellé, sans tenir compte de la
+    // casse ni des accents ("Moto Yamaha" -> "Moto", "Vélo" -> "Velo")
+    QString typeVehicule(const QString& vehicule) const;
+
+    // Configuration
+    QMap<QString, int> capacitesParType() const { return capacitesType; }
+    void definirCapaciteType(const QString& type, int capacite);
+    void definirCapaciteLivreur(int idLivreur, int capacite);
+    void supprimerCapaciteLivreur(int idLivreur);
+
+    static constexpr int CAPACITE_PAR_DEFAUT = 5;
+
+private:
+    void charger();
+    // Clé existante de même forme normalisée que type, sinon type
+    QString typeConnu(const QString& type) const;
+
+    QMap<QString, int> capacitesType;
+    QHash<int, int> capacitesLivreur;
+};
+
+#endif // MODELECAPACITE_H
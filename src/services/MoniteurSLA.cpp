@@ -0,0 +1,212 @@
+#include "MoniteurSLA.h"
+#include "IndexFiltres.h"
+#include <QSettings>
+#include <QSignalBlocker>
+#include <QDateTime>
+#include <algorithm>
+
+MoniteurSLA* MoniteurSLA::instance = nullptr;
+
+MoniteurSLA::MoniteurSLA(QObject *parent)
+    : QObject(parent)
+    , delaiDefaut(7)
+{
+    QSettings settings;
+    delaiDefaut = settings.value("SLA/delaiDefaut", 7).toInt();
+    settings.beginGroup("SLA/villes");
+    for (const QString& ville : settings.childKeys()) {
+        delaisVille[ville.toUpper()] = settings.value(ville).toInt();
+    }
+    settings.endGroup();
+
+    minuteur.setSingleShot(true);
+    connect(&minuteur, &QTimer::timeout, this, &MoniteurSLA::verifier);
+
+    IndexFiltres* index = IndexFiltres::getInstance();
+    connect(index, &IndexFiltres::commandeModifiee, this, &MoniteurSLA::commandeModifiee);
+    connect(index, &IndexFiltres::commandeRetiree, this, &MoniteurSLA::commandeRetiree);
+    connect(index, &IndexFiltres::indexRecharge, this, &MoniteurSLA::reconstruire);
+
+    if (index->estCharge()) {
+        reconstruire();
+    }
+    programmerProchaineVerification();
+}
+
+MoniteurSLA* MoniteurSLA::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new MoniteurSLA();
+    }
+    return instance;
+}
+
+// Règles
+
+int MoniteurSLA::delaiJours(const QString& ville) const
+{
+    return delaisVille.value(ville.toUpper(), delaiDefaut);
+}
+
+void MoniteurSLA::definirDelaiDefaut(int jours)
+{
+    delaiDefaut = jours;
+    QSettings().setValue("SLA/delaiDefaut", jours);
+    reconstruire();
+}
+
+void MoniteurSLA::definirDelaiVille(const QString& ville, int jours)
+{
+    delaisVille[ville.toUpper()] = jours;
+    QSettings().setValue("SLA/villes/" + ville.toUpper(), jours);
+    reconstruire();
+}
+
+void MoniteurSLA::supprimerDelaiVille(const QString& ville)
+{
+    delaisVille.remove(ville.toUpper());
+    QSettings().remove("SLA/villes/" + ville.toUpper());
+    reconstruire();
+}
+
+QDate MoniteurSLA::echeance(const Commande& commande) const
+{
+    return commande.getDateCommande().addDays(delaiJours(commande.getVilleLivraison()));
+}
+
+// Suivi incrémental
+
+void MoniteurSLA::suivre(const Commande& commande)
+{
+    const int id = commande.getIdCommande();
+    const QString& statut = commande.getStatut();
+
+    if (statut == "En retard") {
+        echeances.insert(id, echeance(commande));
+        marquerEnRetard(id);
+        return;
+    }
+
+    if (statut != "En cours") {
+        oublier(id);
+        return;
+    }
+
+    const QDate date = echeance(commande);
+    echeances.insert(id, date);
+
+    if (date < QDate::currentDate()) {
+        marquerEnRetard(id);
+        return;
+    }
+
+    // Échéance repoussée (date ou ville modifiée) : plus en retard
+    if (enRetard.remove(id)) {
+        emit retardResolu(id);
+    }
+    tas.push({date, id});
+
+    // Compactage quand les entrées périmées dominent le tas
+    if (tas.size() > 2 * static_cast<size_t>(echeances.size()) + 64) {
+        std::vector<Echeance> valides;
+        valides.reserve(echeances.size());
+        while (!tas.empty()) {
+            const Echeance e = tas.top();
+            tas.pop();
+            if (!enRetard.contains(e.idCommande) && echeances.value(e.idCommande) == e.date) {
+                valides.push_back(e);
+            }
+        }
+        tas = decltype(tas)(std::greater<Echeance>(), std::move(valides));
+    }
+}
+
+void MoniteurSLA::oublier(int idCommande)
+{
+    // L'entrée du tas devient périmée, elle sera ignorée au dépilement
+    echeances.remove(idCommande);
+    if (enRetard.remove(idCommande)) {
+        emit retardResolu(idCommande);
+    }
+}
+
+void MoniteurSLA::marquerEnRetard(int idCommande)
+{
+    if (!enRetard.contains(idCommande)) {
+        enRetard.insert(idCommande);
+        emit commandeEnRetard(idCommande);
+    }
+}
+
+void MoniteurSLA::commandeModifiee(int idCommande)
+{
+    suivre(IndexFiltres::getInstance()->obtenirCommande(idCommande));
+}
+
+void MoniteurSLA::commandeRetiree(int idCommande)
+{
+    oublier(idCommande);
+}
+
+void MoniteurSLA::verifier()
+{
+    // Seules les échéances dépassées sont dépilées
+    const QDate aujourdhui = QDate::currentDate();
+    while (!tas.empty() && tas.top().date < aujourdhui) {
+        const Echeance e = tas.top();
+        tas.pop();
+        auto it = echeances.constFind(e.idCommande);
+        if (it != echeances.constEnd() && it.value() == e.date) {
+            marquerEnRetard(e.idCommande);
+        }
+    }
+    programmerProchaineVerification();
+}
+
+void MoniteurSLA::programmerProchaineVerification()
+{
+    // Les échéances sont des dates : le prochain franchissement est à minuit
+    const QDateTime maintenant = QDateTime::currentDateTime();
+    const QDateTime minuit(maintenant.date().addDays(1), QTime(0, 0));
+    minuteur.start(static_cast<int>(maintenant.msecsTo(minuit)) + 1000);
+}
+
+void MoniteurSLA::reconstruire()
+{
+    const QSet<int> precedents = enRetard;
+
+    {
+        // Reconstruction silencieuse, seules les différences sont notifiées
+        const QSignalBlocker bloqueur(this);
+        tas = decltype(tas)();
+        echeances.clear();
+        enRetard.clear();
+
+        IndexFiltres* index = IndexFiltres::getInstance();
+        if (index->estCharge()) {
+            for (const QString& statut : {QString("En cours"), QString("En retard")}) {
+                for (const Commande& commande : index->filtrerCommandes(statut, QString(), QDate(), QDate())) {
+                    suivre(commande);
+                }
+            }
+        }
+    }
+
+    for (int id : enRetard) {
+        if (!precedents.contains(id)) emit commandeEnRetard(id);
+    }
+    for (int id : precedents) {
+        if (!enRetard.contains(id)) emit retardResolu(id);
+    }
+}
+
+QList<int> MoniteurSLA::commandesEnRetard() const
+{
+    QList<int> ids(enRetard.constBegin(), enRetard.constEnd());
+    std::sort(ids.begin(), ids.end(), [this](int a, int b) {
+        const QDate da = echeances.value(a);
+        const QDate db = echeances.value(b);
+        return da != db ? da < db : a < b;
+    });
+    return ids;
+}
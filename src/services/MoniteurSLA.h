@@ -0,0 +1,83 @@
+#ifndef MONITEURSLA_H
+#define MONITEURSLA_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QList>
+#include <QString>
+#include <queue>
+#include <vector>
+#include "entities/Commande.h"
+
+// Suivi des délais de livraison (SLA) : les commandes en cours sont rangées
+// dans un tas par date d'échéance, le minuteur ne traite que celles dont
+// l'échéance est dépassée. L'ensemble des commandes en retard est maintenu
+// en continu à partir des notifications de l'index.
+class MoniteurSLA : public QObject
+{
+    Q_OBJECT
+
+private:
+    static MoniteurSLA* instance;
+
+    MoniteurSLA(QObject *parent = nullptr);
+
+public:
+    static MoniteurSLA* getInstance();
+
+    // Règles : délai par défaut, remplacé par un délai propre à la ville
+    int delaiJours(const QString& ville) const;
+    int getDelaiDefaut() const { return delaiDefaut; }
+    QMap<QString, int> delaisParVille() const { return delaisVille; }
+    void definirDelaiDefaut(int jours);
+    void definirDelaiVille(const QString& ville, int jours);
+    void supprimerDelaiVille(const QString& ville);
+
+    QDate echeance(const Commande& commande) const;
+
+    // Commandes en retard, de la plus ancienne échéance à la plus récente
+    QList<int> commandesEnRetard() const;
+    bool estEnRetard(int idCommande) const { return enRetard.contains(idCommande); }
+    int nombreEnRetard() const { return enRetard.size(); }
+
+signals:
+    void commandeEnRetard(int idCommande);
+    void retardResolu(int idCommande);
+
+public slots:
+    void verifier();
+    void reconstruire();
+
+private slots:
+    void commandeModifiee(int idCommande);
+    void commandeRetiree(int idCommande);
+
+private:
+    struct Echeance {
+        QDate date;
+        int idCommande;
+        bool operator>(const Echeance& autre) const { return date > autre.date; }
+    };
+
+    void suivre(const Commande& commande);
+    void oublier(int idCommande);
+    void marquerEnRetard(int idCommande);
+    void programmerProchaineVerification();
+
+    int delaiDefaut;
+    QMap<QString, int> delaisVille;
+
+    // Tas min à suppression paresseuse : une entrée n'est valide que si elle
+    // correspond encore à l'échéance courante de la commande
+    std::priority_queue<Echeance, std::vector<Echeance>, std::greater<Echeance>> tas;
+    QHash<int, QDate> echeances;
+    QSet<int> enRetard;
+
+    QTimer minuteur;
+};
+
+#endif // MONITEURSLA_H
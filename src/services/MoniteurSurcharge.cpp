@@ -0,0 +1,82 @@
+#include "MoniteurSurcharge.h"
+#include "IndexFiltres.h"
+#include "ModeleCapacite.h"
+#include <algorithm>
+
+MoniteurSurcharge* MoniteurSurcharge::instance = nullptr;
+
+MoniteurSurcharge::MoniteurSurcharge(QObject *parent)
+    : QObject(parent)
+{
+    IndexFiltres* index = IndexFiltres::getInstance();
+    connect(index, &IndexFiltres::chargeModifiee, this, &MoniteurSurcharge::evaluer);
+    connect(index, &IndexFiltres::livreurModifie, this, &MoniteurSurcharge::evaluer);
+    connect(index, &IndexFiltres::livreurRetire, this, &MoniteurSurcharge::retirer);
+    connect(index, &IndexFiltres::indexRecharge, this, &MoniteurSurcharge::reevaluerTout);
+
+    if (index->estCharge()) {
+        reevaluerTout();
+    }
+}
+
+MoniteurSurcharge* MoniteurSurcharge::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new MoniteurSurcharge();
+    }
+    return instance;
+}
+
+void MoniteurSurcharge::evaluer(int idLivreur)
+{
+    IndexFiltres* index = IndexFiltres::getInstance();
+    const int charge = index->chargeActive(idLivreur);
+    const int capacite = ModeleCapacite::getInstance()->capacite(index->obtenirLivreur(idLivreur));
+
+    // Signal émis uniquement au franchissement du seuil
+    if (charge > capacite) {
+        if (!surcharges.contains(idLivreur)) {
+            surcharges.insert(idLivreur);
+            emit surchargeDetectee(idLivreur, charge, capacite);
+        }
+    } else {
+        retirer(idLivreur);
+    }
+}
+
+void MoniteurSurcharge::retirer(int idLivreur)
+{
+    if (surcharges.remove(idLivreur)) {
+        emit surchargeResolue(idLivreur);
+    }
+}
+
+void MoniteurSurcharge::reevaluerTout()
+{
+    IndexFiltres* index = IndexFiltres::getInstance();
+    const QMap<int, int> charges = index->chargesActives();
+
+    // Livreurs disparus depuis le dernier chargement
+    const QSet<int> precedents = surcharges;
+    for (int id : precedents) {
+        if (!charges.contains(id)) {
+            retirer(id);
+        }
+    }
+
+    for (auto it = charges.constBegin(); it != charges.constEnd(); ++it) {
+        evaluer(it.key());
+    }
+}
+
+QList<int> MoniteurSurcharge::livreursSurcharges() const
+{
+    IndexFiltres* index = IndexFiltres::getInstance();
+    QList<int> ids(surcharges.constBegin(), surcharges.constEnd());
+    std::sort(ids.begin(), ids.end(), [index](int a, int b) {
+        const int chargeA = index->chargeActive(a);
+        const int chargeB = index->chargeActive(b);
+        return chargeA != chargeB ? chargeA > chargeB : a < b;
+    });
+    return ids;
+}
@@ -0,0 +1,42 @@
+#ifndef MONITEURSURCHARGE_H
+#define MONITEURSURCHARGE_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+
+// Surveillance des surcharges : un livreur est en surcharge lorsque ses
+// commandes actives dépassent sa capacité (ModeleCapacite). Seuls les livreurs
+// dont la charge change dans l'index sont réévalués.
+class MoniteurSurcharge : public QObject
+{
+    Q_OBJECT
+
+private:
+    static MoniteurSurcharge* instance;
+
+    MoniteurSurcharge(QObject *parent = nullptr);
+
+public:
+    static MoniteurSurcharge* getInstance();
+
+    bool estSurcharge(int idLivreur) const { return surcharges.contains(idLivreur); }
+    // Triés par charge décroissante
+    QList<int> livreursSurcharges() const;
+
+    // À appeler après une modification des capacités
+    void reevaluerTout();
+
+signals:
+    void surchargeDetectee(int idLivreur, int charge, int capacite);
+    void surchargeResolue(int idLivreur);
+
+private slots:
+    void evaluer(int idLivreur);
+    void retirer(int idLivreur);
+
+private:
+    QSet<int> surcharges;
+};
+
+#endif // MONITEURSURCHARGE_H
@@ -0,0 +1,86 @@
+#include "PlanificateurTournees.h"
+#include "CommandeService.h"
+#include "TableDistances.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <QStringList>
+
+QString Tournee::itineraire() const
+{
+    QStringList lieux;
+    lieux << depart;
+    for (const Commande& commande : etapes) {
+        // Plusieurs commandes dans la même ville : une seule étape affichée
+        if (lieux.last() != commande.getVilleLivraison()) {
+            lieux << commande.getVilleLivraison();
+        }
+    }
+    return lieux.join(" → ");
+}
+
+PlanificateurTournees::PlanificateurTournees()
+    : budgetMs(50)
+{
+}
+
+PlanificateurTournees::Probleme PlanificateurTournees::preparer(const Livreur& livreur)
+{
+    Probleme probleme;
+    probleme.livreur = livreur;
+
+    CommandeService commandeService;
+    probleme.commandes = commandeService.obtenirCommandesActivesLivreur(livreur.getIdLivreur());
+
+    // Point 0 = zone du livreur, points suivants = villes des commandes
+    QStringList lieux;
+    lieux << livreur.getZoneLivraison();
+    for (const Commande& commande : probleme.commandes) {
+        lieux << commande.getVilleLivraison();
+    }
+
+    TableDistances* table = TableDistances::getInstance();
+    const int n = lieux.size();
+    probleme.distances.assign(n, std::vector<double>(n, 0.0));
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            const double km = table->distance(lieux[i], lieux[j]);
+            probleme.distances[i][j] = km;
+            probleme.distances[j][i] = km;
+        }
+    }
+
+    return probleme;
+}
+
+Tournee PlanificateurTournees::resoudre(const Probleme& probleme, int budgetMs)
+{
+    Tournee tournee;
+    tournee.idLivreur = probleme.livreur.getIdLivreur();
+    tournee.depart = probleme.livreur.getZoneLivraison();
+
+    const std::vector<int> ordre = OptimiseurTournee::optimiser(probleme.distances, budgetMs);
+    for (size_t k = 1; k < ordre.size(); ++k) {
+        tournee.etapes.append(probleme.commandes[ordre[k] - 1]);
+    }
+    tournee.distanceKm = OptimiseurTournee::longueur(probleme.distances, ordre);
+
+    return tournee;
+}
+
+Tournee PlanificateurTournees::planifier(const Livreur& livreur)
+{
+    return resoudre(preparer(livreur), budgetMs);
+}
+
+QList<Tournee> PlanificateurTournees::planifier(const QList<Livreur>& livreurs)
+{
+    // Les accès aux données restent sur le thread appelant
+    QList<Probleme> problemes;
+    problemes.reserve(livreurs.size());
+    for (const Livreur& livreur : livreurs) {
+        problemes.append(preparer(livreur));
+    }
+
+    const int budget = budgetMs;
+    return QtConcurrent::blockingMapped<QList<Tournee>>(problemes,
+        [budget](const Probleme& probleme) { return resoudre(probleme, budget); });
+}
@@ -0,0 +1,49 @@
+#ifndef PLANIFICATEURTOURNEES_H
+#define PLANIFICATEURTOURNEES_H
+
+#include <QList>
+#include <QString>
+#include "entities/Commande.h"
+#include "entities/Livreur.h"
+#include "utils/OptimiseurTournee.h"
+
+// Tournée planifiée d'un livreur
+struct Tournee
+{
+    int idLivreur = 0;
+    QString depart;          // zone du livreur
+    QList<Commande> etapes;  // commandes actives dans l'ordre de visite
+    double distanceKm = 0.0;
+
+    QString itineraire() const;
+};
+
+// Planification de l'ordre de livraison des commandes actives de chaque
+// livreur, à partir de la table locale des distances entre villes
+class PlanificateurTournees
+{
+public:
+    PlanificateurTournees();
+
+    Tournee planifier(const Livreur& livreur);
+    // Plusieurs livreurs : optimisations exécutées en parallèle
+    QList<Tournee> planifier(const QList<Livreur>& livreurs);
+
+    int getBudgetMs() const { return budgetMs; }
+    void setBudgetMs(int budget) { budgetMs = budget; }
+
+private:
+    struct Probleme {
+        Livreur livreur;
+        QList<Commande> commandes;
+        OptimiseurTournee::Matrice distances;
+    };
+
+    // Lecture des données (thread principal), puis calcul pur (tout thread)
+    Probleme preparer(const Livreur& livreur);
+    static Tournee resoudre(const Probleme& probleme, int budgetMs);
+
+    int budgetMs;
+};
+
+#endif // PLANIFICATEURTOURNEES_H
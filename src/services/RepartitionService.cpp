@@ -0,0 +1,235 @@
+#include "RepartitionService.h"
+#include "CommandeService.h"
+#include "LivreurService.h"
+#include "IndexFiltres.h"
+#include "JournalEvenements.h"
+#include "db/DatabaseManager.h"
+#include "utils/AffectationCoutMin.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QStringList>
+#include <QSet>
+#include <QDebug>
+
+RepartitionService::RepartitionService()
+    : penaliteHorsZone(10)
+{
+}
+
+bool RepartitionService::zoneCorrespond(const QString& zone, const QString& ville)
+{
+    // "Tunis Centre" couvre "Tunis", "Sfax Nord" couvre "Sfax"
+    if (zone.isEmpty() || ville.isEmpty()) {
+        return false;
+    }
+    return zone.contains(ville, Qt::CaseInsensitive) || ville.contains(zone, Qt::CaseInsensitive);
+}
+
+RapportRepartition RepartitionService::repartirCommandesEnAttente()
+{
+    RapportRepartition rapport;
+    QElapsedTimer chronoTotal;
+    chronoTotal.start();
+
+    // Commandes en attente sans livreur
+    CommandeService commandeService;
+    QList<Commande> enAttente;
+    for (const Commande& commande : commandeService.rechercherCommandes("En attente")) {
+        if (commande.getIdLivreur() <= 0) {
+            enAttente.append(commande);
+        }
+    }
+
+    LivreurService livreurService;
+    QList<Livreur> disponibles = livreurService.obtenirLivreursDisponibles();
+    QMap<int, int> charges = livreurService.obtenirStatistiquesChargesDeTravail();
+
+    rapport.commandesEnAttente = enAttente.size();
+    rapport.livreursDisponibles = disponibles.size();
+
+    if (enAttente.isEmpty() || disponibles.isEmpty()) {
+        rapport.succes = true;
+        rapport.dureeTotaleMs = chronoTotal.elapsed();
+        return rapport;
+    }
+
+    QElapsedTimer chronoCalcul;
+    chronoCalcul.start();
+    QHash<int, int> affectations = calculerAffectations(enAttente, disponibles, charges);
+    rapport.dureeCalculMs = chronoCalcul.elapsed();
+
+    if (!appliquerAffectations(affectations)) {
+        rapport.erreur = DatabaseManager::getInstance()->getLastError();
+        rapport.dureeTotaleMs = chronoTotal.elapsed();
+        return rapport;
+    }
+
+    rapport.succes = true;
+    rapport.affectations = affectations.size();
+    rapport.dureeTotaleMs = chronoTotal.elapsed();
+    rapport.affectationsParSeconde = rapport.affectations * 1000.0 / qMax<qint64>(1, rapport.dureeTotaleMs);
+
+    qDebug() << "Répartition automatique:" << rapport.affectations << "affectations en"
+             << rapport.dureeTotaleMs << "ms (" << rapport.affectationsParSeconde << "affectations/s)";
+    return rapport;
+}
+
+QHash<int, int> RepartitionService::calculerAffectations(const QList<Commande>& commandes,
+                                                         const QList<Livreur>& livreurs,
+                                                         const QMap<int, int>& charges) const
+{
+    // Les commandes d'une même ville ont le même coût : on les regroupe,
+    // le graphe ne dépend plus que de (villes x livreurs)
+    QMap<QString, QList<int>> commandesParVille;
+    for (const Commande& commande : commandes) {
+        commandesParVille[commande.getVilleLivraison()].append(commande.getIdCommande());
+    }
+
+    AffectationCoutMin probleme;
+    for (const Livreur& livreur : livreurs) {
+        probleme.ajouterRessource(charges.value(livreur.getIdLivreur(), 0));
+    }
+
+    QStringList villes = commandesParVille.keys();
+    for (const QString& ville : villes) {
+        const int groupe = probleme.ajouterGroupe(commandesParVille.value(ville).size());
+        for (int r = 0; r < livreurs.size(); ++r) {
+            const bool memeZone = zoneCorrespond(livreurs[r].getZoneLivraison(), ville);
+            probleme.ajouterArc(groupe, r, memeZone ? 0 : penaliteHorsZone);
+        }
+    }
+
+    const auto solution = probleme.resoudre();
+
+    // Distribution des commandes de chaque ville selon les quantités calculées
+    QHash<int, int> affectations;
+    for (int g = 0; g < villes.size(); ++g) {
+        const QList<int>& ids = commandesParVille[villes[g]];
+        int prochaine = 0;
+        for (const auto& quantite : solution[g]) {
+            const int idLivreur = livreurs[quantite.ressource].getIdLivreur();
+            for (int k = 0; k < quantite.nombre && prochaine < ids.size(); ++k) {
+                affectations.insert(ids[prochaine++], idLivreur);
+            }
+        }
+    }
+
+    return affectations;
+}
+
+bool RepartitionService::appliquerAffectations(QHash<int, int>& affectations)
+{
+    if (affectations.isEmpty()) {
+        return true;
+    }
+
+    DatabaseManager* db = DatabaseManager::getInstance();
+    if (!db->beginTransaction()) {
+        return false;
+    }
+
+    // Commandes affectées depuis le chargement par un autre poste : écartées
+    // avant l'UPDATE, pour que journal et index ne reflètent que le lot appliqué
+    QList<EvenementCommande> evenements;
+    if (!retenirEnAttente(affectations, evenements)) {
+        db->rollbackTransaction();
+        return false;
+    }
+    if (affectations.isEmpty()) {
+        return db->commitTransaction();
+    }
+
+    // Horodatage du lot à l'heure du serveur
+    const QDateTime maintenant = db->currentServerTime();
+    if (!maintenant.isValid()) {
+        db->rollbackTransaction();
+        return false;
+    }
+
+    QVariantList idsLivreurs;
+    QVariantList datesAffectation;
+    QVariantList idsCommandes;
+    idsLivreurs.reserve(affectations.size());
+    datesAffectation.reserve(affectations.size());
+    idsCommandes.reserve(affectations.size());
+    for (auto it = affectations.constBegin(); it != affectations.constEnd(); ++it) {
+        idsCommandes << it.key();
+        idsLivreurs << it.value();
+        datesAffectation << maintenant;
+    }
+
+    // Un seul aller-retour grâce à la liaison par tableaux
+    QString query = "UPDATE COMMANDES SET id_livreur = ?, statut = 'En cours', assigned_at = ? "
+                   "WHERE id_commande = ? AND statut = 'En attente'";
+    QSqlQuery result = db->executeBatchQuery(query, {idsLivreurs, datesAffectation, idsCommandes});
+
+    // Événements du lot écrits dans la même transaction
+    JournalEvenements journal;
+    if (result.lastError().isValid() || !journal.ecrire(evenements) || !db->commitTransaction()) {
+        db->rollbackTransaction();
+        return false;
+    }
+
+    IndexFiltres* index = IndexFiltres::getInstance();
+    for (auto it = affectations.constBegin(); it != affectations.constEnd(); ++it) {
+        index->livreurAffecte(it.key(), it.value(), maintenant);
+    }
+
+    return true;
+}
+
+bool RepartitionService::retenirEnAttente(QHash<int, int>& affectations, QList<EvenementCommande>& evenements)
+{
+    DatabaseManager* db = DatabaseManager::getInstance();
+    const QList<int> ids = affectations.keys();
+    QSet<int> enAttente;
+
+    // Par tranches de 1000 (limite Oracle d'une liste IN) ; les lignes lues
+    // restent verrouillées jusqu'à la fin de la transaction (SQLite verrouille
+    // la base entière à l'écriture)
+    for (int debut = 0; debut < ids.size(); debut += 1000) {
+        const QList<int> tranche = ids.mid(debut, 1000);
+        QStringList marqueurs;
+        QVariantList values;
+        for (int id : tranche) {
+            marqueurs << "?";
+            values << id;
+        }
+
+        QString query = QString("SELECT id_commande, ville_livraison, date_commande, id_client "
+                                "FROM COMMANDES WHERE id_commande IN (%1) "
+                                "AND statut = 'En attente' AND id_livreur IS NULL").arg(marqueurs.join(", "));
+        if (!db->isSqlite()) {
+            query += " FOR UPDATE";
+        }
+        QSqlQuery result = db->executePreparedQuery(query, values);
+        if (result.lastError().isValid()) {
+            return false;
+        }
+        while (result.next()) {
+            // État après l'UPDATE, construit ici : rien à relire après coup
+            EvenementCommande evenement;
+            evenement.idCommande = result.value("id_commande").toInt();
+            evenement.type = "AFFECTATION";
+            evenement.statutPrecedent = "En attente";
+            evenement.statut = "En cours";
+            evenement.idLivreur = affectations.value(evenement.idCommande);
+            evenement.villeLivraison = result.value("ville_livraison").toString();
+            evenement.dateCommande = result.value("date_commande").toDate();
+            evenement.idClient = result.value("id_client").toInt();
+            evenements << evenement;
+            enAttente.insert(evenement.idCommande);
+        }
+    }
+
+    for (auto it = affectations.begin(); it != affectations.end();) {
+        if (enAttente.contains(it.key())) {
+            ++it;
+        } else {
+            it = affectations.erase(it);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef REPARTITIONSERVICE_H
+#define REPARTITIONSERVICE_H
+
+#include <QList>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include "entities/Commande.h"
+#include "entities/Livreur.h"
+#include "JournalEvenements.h"
+
+// Résultat d'une répartition automatique
+struct RapportRepartition
+{
+    bool succes = false;
+    QString erreur;
+    int commandesEnAttente = 0;
+    int livreursDisponibles = 0;
+    int affectations = 0;
+    qint64 dureeCalculMs = 0;
+    qint64 dureeTotaleMs = 0;
+    double affectationsParSeconde = 0.0;
+};
+
+// Répartition en lot des commandes en attente sur les livreurs disponibles :
+// affectation à coût minimal (correspondance de zone + charge actuelle),
+// appliquée en une seule transaction.
+class RepartitionService
+{
+public:
+    RepartitionService();
+
+    // Répartition complète : chargement, calcul, application
+    RapportRepartition repartirCommandesEnAttente();
+
+    // Calcul seul : id_commande -> id_livreur
+    QHash<int, int> calculerAffectations(const QList<Commande>& commandes,
+                                         const QList<Livreur>& livreurs,
+                                         const QMap<int, int>& charges) const;
+
+    // Application en une transaction (UPDATE par lot). Les commandes prises
+    // entre-temps par un autre poste sont retirées de affectations.
+    bool appliquerAffectations(QHash<int, int>& affectations);
+
+    // Coût d'une affectation hors de la zone du livreur, en nombre de commandes
+    int getPenaliteHorsZone() const { return penaliteHorsZone; }
+    void setPenaliteHorsZone(int penalite) { penaliteHorsZone = penalite; }
+
+    static bool zoneCorrespond(const QString& zone, const QString& ville);
+
+private:
+    // Verrouille les commandes encore en attente (transaction ouverte),
+    // retire les autres de affectations et prépare les événements AFFECTATION
+    bool retenirEnAttente(QHash<int, int>& affectations, QList<EvenementCommande>& evenements);
+
+    int penaliteHorsZone;
+};
+
+#endif // REPARTITIONSERVICE_H
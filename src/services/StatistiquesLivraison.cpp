@@ -0,0 +1,194 @@
+#include "StatistiquesLivraison.h"
+#include "IndexFiltres.h"
+
+StatistiquesLivraison* StatistiquesLivraison::instance = nullptr;
+
+StatistiquesLivraison::StatistiquesLivraison(QObject *parent)
+    : QObject(parent)
+{
+    IndexFiltres* index = IndexFiltres::getInstance();
+    connect(index, &IndexFiltres::commandeModifiee, this, &StatistiquesLivraison::commandeModifiee);
+    connect(index, &IndexFiltres::commandeRetiree, this, &StatistiquesLivraison::commandeRetiree);
+    connect(index, &IndexFiltres::indexRecharge, this, &StatistiquesLivraison::reconstruire);
+
+    if (index->estCharge()) {
+        reconstruire();
+    }
+}
+
+StatistiquesLivraison* StatistiquesLivraison::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new StatistiquesLivraison();
+    }
+    return instance;
+}
+
+void StatistiquesLivraison::reconstruire()
+{
+    livraisons.clear();
+    distributionGlobale.vider();
+    distributionsVille.clear();
+    distributionsLivreur.clear();
+    globalePerimee = false;
+    villesPerimees.clear();
+    livreursPerimes.clear();
+
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (!index->estCharge()) return;
+
+    for (const Commande& commande : index->filtrerCommandes("Livree", QString(), QDate(), QDate())) {
+        enregistrer(commande);
+    }
+}
+
+void StatistiquesLivraison::commandeModifiee(int idCommande)
+{
+    enregistrer(IndexFiltres::getInstance()->obtenirCommande(idCommande));
+}
+
+void StatistiquesLivraison::enregistrer(const Commande& commande)
+{
+    const int idCommande = commande.getIdCommande();
+
+    // Livraisons antérieures à l'horodatage : délai inconnu, ignorées
+    const double delai = commande.getStatut() == "Livree" ? commande.delaiLivraisonJours() : -1.0;
+    const Livraison livraison{commande.getVilleLivraison(), commande.getIdLivreur(), delai};
+
+    auto it = livraisons.find(idCommande);
+    if (it == livraisons.end()) {
+        if (delai >= 0.0) {
+            livraisons.insert(idCommande, livraison);
+            ajouter(livraison);
+        }
+        return;
+    }
+
+    if (delai >= 0.0 && it->ville == livraison.ville && it->idLivreur == livraison.idLivreur &&
+        it->delai == delai) {
+        return;
+    }
+
+    // Valeur déjà ajoutée aux distributions : à recalculer sans elle
+    perimer(it.value());
+    if (delai >= 0.0) {
+        it.value() = livraison;
+        perimer(livraison);
+    } else {
+        livraisons.erase(it);
+    }
+}
+
+void StatistiquesLivraison::commandeRetiree(int idCommande)
+{
+    auto it = livraisons.find(idCommande);
+    if (it != livraisons.end()) {
+        perimer(it.value());
+        livraisons.erase(it);
+    }
+}
+
+void StatistiquesLivraison::ajouter(const Livraison& livraison)
+{
+    distributionGlobale.ajouter(livraison.delai);
+    distributionsVille[livraison.ville].ajouter(livraison.delai);
+    if (livraison.idLivreur > 0) {
+        distributionsLivreur[livraison.idLivreur].ajouter(livraison.delai);
+    }
+}
+
+void StatistiquesLivraison::perimer(const Livraison& livraison)
+{
+    globalePerimee = true;
+    villesPerimees.insert(livraison.ville);
+    if (livraison.idLivreur > 0) {
+        livreursPerimes.insert(livraison.idLivreur);
+    }
+}
+
+void StatistiquesLivraison::recalculerPerimees() const
+{
+    if (!globalePerimee && villesPerimees.isEmpty() && livreursPerimes.isEmpty()) {
+        return;
+    }
+
+    // Une seule passe sur les livraisons pour toutes les distributions périmées
+    if (globalePerimee) {
+        distributionGlobale.vider();
+    }
+    for (const QString& ville : villesPerimees) {
+        distributionsVille.remove(ville);
+    }
+    for (int idLivreur : livreursPerimes) {
+        distributionsLivreur.remove(idLivreur);
+    }
+
+    for (const Livraison& livraison : livraisons) {
+        if (globalePerimee) {
+            distributionGlobale.ajouter(livraison.delai);
+        }
+        if (villesPerimees.contains(livraison.ville)) {
+            distributionsVille[livraison.ville].ajouter(livraison.delai);
+        }
+        if (livreursPerimes.contains(livraison.idLivreur)) {
+            distributionsLivreur[livraison.idLivreur].ajouter(livraison.delai);
+        }
+    }
+
+    globalePerimee = false;
+    villesPerimees.clear();
+    livreursPerimes.clear();
+}
+
+MesuresDelai StatistiquesLivraison::mesurer(const TDigest& distribution)
+{
+    MesuresDelai mesures;
+    if (distribution.estVide()) return mesures;
+
+    mesures.nombre = static_cast<int>(distribution.nombre());
+    mesures.moyenne = distribution.moyenne();
+    mesures.p50 = distribution.quantile(0.50);
+    mesures.p90 = distribution.quantile(0.90);
+    mesures.p99 = distribution.quantile(0.99);
+    return mesures;
+}
+
+MesuresDelai StatistiquesLivraison::global() const
+{
+    recalculerPerimees();
+    return mesurer(distributionGlobale);
+}
+
+MesuresDelai StatistiquesLivraison::parVille(const QString& ville) const
+{
+    recalculerPerimees();
+    auto it = distributionsVille.constFind(ville);
+    return it != distributionsVille.constEnd() ? mesurer(it.value()) : MesuresDelai();
+}
+
+MesuresDelai StatistiquesLivraison::parLivreur(int idLivreur) const
+{
+    recalculerPerimees();
+    auto it = distributionsLivreur.constFind(idLivreur);
+    return it != distributionsLivreur.constEnd() ? mesurer(it.value()) : MesuresDelai();
+}
+
+QMap<QString, MesuresDelai> StatistiquesLivraison::toutesVilles() const
+{
+    recalculerPerimees();
+    QMap<QString, MesuresDelai> resultat;
+    for (auto it = distributionsVille.constBegin(); it != distributionsVille.constEnd(); ++it) {
+        resultat.insert(it.key(), mesurer(it.value()));
+    }
+    return resultat;
+}
+
+QMap<int, MesuresDelai> StatistiquesLivraison::tousLivreurs() const
+{
+    recalculerPerimees();
+    QMap<int, MesuresDelai> resultat;
+    for (auto it = distributionsLivreur.constBegin(); it != distributionsLivreur.constEnd(); ++it) {
+        resultat.insert(it.key(), mesurer(it.value()));
+    }
+    return resultat;
+}
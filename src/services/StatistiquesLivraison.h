@@ -0,0 +1,78 @@
+#ifndef STATISTIQUESLIVRAISON_H
+#define STATISTIQUESLIVRAISON_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include "entities/Commande.h"
+#include "utils/TDigest.h"
+
+// Mesures d'un délai de livraison (en jours)
+struct MesuresDelai
+{
+    int nombre = 0;
+    double moyenne = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+};
+
+// Distribution des délais réels de livraison (date de commande -> DELIVERED_AT),
+// globale, par ville et par livreur. Mise à jour à chaque écriture signalée
+// par l'index, reconstruite à chaque rechargement complet. Un t-digest ne
+// sait pas retirer une valeur : une livraison modifiée ou supprimée rend
+// ses distributions périmées, recalculées à la lecture suivante.
+class StatistiquesLivraison : public QObject
+{
+    Q_OBJECT
+
+private:
+    static StatistiquesLivraison* instance;
+
+    StatistiquesLivraison(QObject *parent = nullptr);
+
+public:
+    static StatistiquesLivraison* getInstance();
+
+    MesuresDelai global() const;
+    MesuresDelai parVille(const QString& ville) const;
+    MesuresDelai parLivreur(int idLivreur) const;
+    QMap<QString, MesuresDelai> toutesVilles() const;
+    QMap<int, MesuresDelai> tousLivreurs() const;
+
+public slots:
+    void reconstruire();
+
+private slots:
+    void commandeModifiee(int idCommande);
+    void commandeRetiree(int idCommande);
+
+private:
+    // Délai pris en compte pour une commande livrée
+    struct Livraison
+    {
+        QString ville;
+        int idLivreur;
+        double delai;
+    };
+
+    void enregistrer(const Commande& commande);
+    void ajouter(const Livraison& livraison);
+    void perimer(const Livraison& livraison);
+    void recalculerPerimees() const;
+    static MesuresDelai mesurer(const TDigest& distribution);
+
+    QHash<int, Livraison> livraisons;
+
+    mutable TDigest distributionGlobale;
+    mutable QHash<QString, TDigest> distributionsVille;
+    mutable QHash<int, TDigest> distributionsLivreur;
+
+    mutable bool globalePerimee = false;
+    mutable QSet<QString> villesPerimees;
+    mutable QSet<int> livreursPerimes;
+};
+
+#endif // STATISTIQUESLIVRAISON_H
@@ -0,0 +1,111 @@
+#include "TableDistances.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+
+TableDistances* TableDistances::instance = nullptr;
+
+TableDistances::TableDistances()
+{
+    // Fichier local prioritaire, sinon la table embarquée en ressource
+    QString cheminLocal = QCoreApplication::applicationDirPath() + "/distances.csv";
+    if (!(QFile::exists(cheminLocal) && charger(cheminLocal))) {
+        charger(":/donnees/distances.csv");
+    }
+}
+
+TableDistances* TableDistances::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new TableDistances();
+    }
+    return instance;
+}
+
+bool TableDistances::charger(const QString& cheminFichier)
+{
+    QFile fichier(cheminFichier);
+    if (!fichier.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "Table des distances introuvable:" << cheminFichier;
+        return false;
+    }
+
+    distances.clear();
+    villes.clear();
+
+    QTextStream flux(&fichier);
+    while (!flux.atEnd()) {
+        const QString ligne = flux.readLine().trimmed();
+        if (ligne.isEmpty() || ligne.startsWith('#')) continue;
+
+        const QStringList champs = ligne.split(';');
+        if (champs.size() != 3) continue;
+
+        bool ok = false;
+        const double km = champs[2].trimmed().toDouble(&ok);
+        if (!ok) continue; // ligne d'en-tête
+
+        const QString a = normaliser(champs[0]);
+        const QString b = normaliser(champs[1]);
+        distances[a][b] = km;
+        distances[b][a] = km;
+    }
+
+    villes = distances.keys();
+    std::sort(villes.begin(), villes.end(), [](const QString& x, const QString& y) {
+        return x.size() > y.size();
+    });
+
+    qDebug() << "Table des distances chargée:" << villes.size() << "villes depuis" << cheminFichier;
+    return estChargee();
+}
+
+QString TableDistances::normaliser(const QString& texte)
+{
+    // Majuscules sans accents : "Gabès" et "Gabes" désignent la même ville
+    const QString decompose = texte.normalized(QString::NormalizationForm_D);
+    QString resultat;
+    resultat.reserve(decompose.size());
+    for (const QChar c : decompose) {
+        if (c.category() != QChar::Mark_NonSpacing) {
+            resultat.append(c);
+        }
+    }
+    return resultat.simplified().toUpper();
+}
+
+QString TableDistances::villeDeReference(const QString& lieu) const
+{
+    const QString normalise = normaliser(lieu);
+    if (distances.contains(normalise)) {
+        return normalise;
+    }
+
+    // Zone du type "Sfax Nord" : la ville connue la plus longue contenue
+    for (const QString& ville : villes) {
+        if (normalise.contains(ville)) {
+            return ville;
+        }
+    }
+    return normalise;
+}
+
+double TableDistances::distance(const QString& lieuA, const QString& lieuB) const
+{
+    const QString a = villeDeReference(lieuA);
+    const QString b = villeDeReference(lieuB);
+    if (a == b) {
+        return 0.0;
+    }
+
+    auto ligne = distances.constFind(a);
+    if (ligne != distances.constEnd()) {
+        auto cellule = ligne->constFind(b);
+        if (cellule != ligne->constEnd()) {
+            return cellule.value();
+        }
+    }
+    return DISTANCE_INCONNUE;
+}
@@ -0,0 +1,42 @@
+#ifndef TABLEDISTANCES_H
+#define TABLEDISTANCES_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+// Table locale des distances routières entre villes (data/distances.csv),
+// embarquée dans l'exécutable. Un fichier distances.csv placé à côté de
+// l'exécutable est prioritaire, ce qui permet de l'ajuster sans recompiler.
+class TableDistances
+{
+private:
+    static TableDistances* instance;
+
+    TableDistances();
+
+public:
+    static TableDistances* getInstance();
+
+    bool charger(const QString& cheminFichier);
+    bool estChargee() const { return !distances.isEmpty(); }
+
+    // Distance en km entre deux lieux (ville ou zone de livreur)
+    double distance(const QString& lieuA, const QString& lieuB) const;
+
+    // Ville connue correspondant à un lieu ("Tunis Centre" -> "TUNIS")
+    QString villeDeReference(const QString& lieu) const;
+
+    // Distance utilisée quand un couple de villes est absent de la table
+    static constexpr double DISTANCE_INCONNUE = 100.0;
+
+    // Majuscules sans accents ni espaces superflus ("Gabès" -> "GABES")
+    static QString normaliser(const QString& texte);
+
+private:
+
+    QHash<QString, QHash<QString, double>> distances;
+    QStringList villes; // noms normalisés, du plus long au plus court
+};
+
+#endif // TABLEDISTANCES_H
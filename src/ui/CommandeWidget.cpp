@@ -1,5 +1,8 @@
 #include "CommandeWidget.h"
+#include "utils/Trace.h"
+#include "db/DatabaseManager.h"
 #include "services/LivreurService.h"
+#include "services/RepartitionService.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QFileDialog>
@@ -11,6 +14,8 @@
 #include <QDialogButtonBox>
 #include <QInputDialog>
 #include <QApplication>
+#include <QSet>
+#include <QHash>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
 
@@ -157,6 +162,7 @@ CommandeWidget::CommandeWidget(QWidget *parent)
     : QWidget(parent)
     , commandeService(new CommandeService())
     , commandeSelectionnee(-1)
+    , vueComplete(false)
 {
     setupUI();
     connecterSignaux();
@@ -220,7 +226,8 @@ void CommandeWidget::setupTableau()
     
     // Configuration du tableau
     tableCommandes->setSelectionBehavior(QAbstractItemView::SelectRows);
-    tableCommandes->setSelectionMode(QAbstractItemView::SingleSelection);
+    // Sélection multiple pour les actions groupées (statut, affectation, suppression)
+    tableCommandes->setSelectionMode(QAbstractItemView::ExtendedSelection);
     tableCommandes->setAlternatingRowColors(true);
     tableCommandes->setSortingEnabled(true);
     tableCommandes->verticalHeader()->setVisible(false);
@@ -299,6 +306,7 @@ void CommandeWidget::setupPanneauActions()
     btnAffecterLivreur = new QPushButton("🚚 Affecter un livreur");
     btnChangerStatut = new QPushButton("📝 Changer le statut");
     btnCommandesEnRetard = new QPushButton("⚠️ Commandes en retard");
+    btnRepartitionAuto = new QPushButton("⚡ Répartition automatique");
     
     // Rapports
     btnGenererPDF = new QPushButton("📄 Générer PDF");
@@ -313,6 +321,7 @@ void CommandeWidget::setupPanneauActions()
     actionsLayout->addWidget(btnAffecterLivreur);
     actionsLayout->addWidget(btnChangerStatut);
     actionsLayout->addWidget(btnCommandesEnRetard);
+    actionsLayout->addWidget(btnRepartitionAuto);
     actionsLayout->addWidget(new QFrame()); // Séparateur
     actionsLayout->addWidget(btnGenererPDF);
     actionsLayout->addWidget(btnGenererRapport);
@@ -347,6 +356,7 @@ void CommandeWidget::connecterSignaux()
     connect(btnGenererPDF, &QPushButton::clicked, this, &CommandeWidget::genererPDF);
     connect(btnGenererRapport, &QPushButton::clicked, this, &CommandeWidget::genererRapport);
     connect(btnCommandesEnRetard, &QPushButton::clicked, this, &CommandeWidget::afficherCommandesEnRetard);
+    connect(btnRepartitionAuto, &QPushButton::clicked, this, &CommandeWidget::repartirAutomatiquement);
 }
 
 void CommandeWidget::appliquerStyle()
@@ -397,6 +407,7 @@ void CommandeWidget::appliquerStyle()
     btnActualiser->setStyleSheet(buttonStyle);
     btnAffecterLivreur->setStyleSheet(buttonStyle);
     btnChangerStatut->setStyleSheet(buttonStyle);
+    btnRepartitionAuto->setStyleSheet(buttonStyle);
     btnGenererPDF->setStyleSheet(buttonStyle);
     btnGenererRapport->setStyleSheet(buttonStyle);
     btnRechercher->setStyleSheet(buttonStyle);
@@ -465,76 +476,175 @@ void CommandeWidget::appliquerStyle()
 
 void CommandeWidget::chargerCommandes()
 {
-    QList<Commande> commandes = commandeService->obtenirToutesCommandes();
+    PorteeTrace portee("CommandeWidget::chargerCommandes", "ui");
+    
+    // Filigrane pris avant la lecture : les écritures concurrentes seront
+    // récupérées par la prochaine synchronisation. Sans connexion (vue tirée
+    // de l'instantané local), aucun : la prochaine synchronisation relit la
+    // vue et le prend alors
+    DatabaseManager* db = DatabaseManager::getInstance();
+    QDateTime filigraneLecture = db->isConnected() ? db->currentServerTime() : QDateTime();
+    
+    // Sans critère : servi par l'index en mémoire, tenu à jour par le journal
+    QList<Commande> commandes = commandeService->rechercherCommandes();
     chargerCommandes(commandes);
+    
+    filigrane = filigraneLecture;
+    vueComplete = true;
 }
 
 void CommandeWidget::chargerCommandes(const QList<Commande>& commandes)
 {
+    PorteeTrace portee("CommandeWidget::remplirTableau", "ui");
+    
+    // Résultat de recherche : la synchronisation différentielle ne s'applique pas
+    vueComplete = false;
+    
+    // Tri suspendu pendant le remplissage, sinon les lignes se déplacent
+    tableCommandes->setSortingEnabled(false);
     tableCommandes->setRowCount(commandes.size());
     
     for (int i = 0; i < commandes.size(); ++i) {
-        const Commande& cmd = commandes[i];
-        
-        // ID avec couleur explicite
-        QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(cmd.getIdCommande()));
-        idItem->setForeground(QColor("#000000")); // Noir
-        tableCommandes->setItem(i, 0, idItem);
-        
-        // Date avec couleur explicite
-        QTableWidgetItem* dateItem = new QTableWidgetItem(cmd.getDateCommande().toString("dd/MM/yyyy"));
-        dateItem->setForeground(QColor("#000000")); // Noir
-        tableCommandes->setItem(i, 1, dateItem);
-        
-        // Statut avec couleur
-        QTableWidgetItem* statutItem = new QTableWidgetItem(cmd.getStatut());
-        if (cmd.getStatut() == "En attente") {
-            statutItem->setBackground(QColor("#FFA726"));  // Orange vif
-            statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
-        } else if (cmd.getStatut() == "En cours") {
-            statutItem->setBackground(QColor("#42A5F5"));  // Bleu vif
-            statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
-        } else if (cmd.getStatut() == "Livree") {
-            statutItem->setBackground(QColor("#66BB6A"));  // Vert vif
-            statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
-        } else if (cmd.getStatut() == "Annulee") {
-            statutItem->setBackground(QColor("#EF5350"));  // Rouge vif
-            statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+        remplirLigne(i, commandes[i]);
+    }
+    
+    tableCommandes->setSortingEnabled(true);
+    tableCommandes->resizeColumnsToContents();
+}
+
+void CommandeWidget::remplirLigne(int ligne, const Commande& commande)
+{
+    // ID avec couleur explicite
+    QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(commande.getIdCommande()));
+    idItem->setForeground(QColor("#000000")); // Noir
+    tableCommandes->setItem(ligne, 0, idItem);
+    
+    // Date avec couleur explicite
+    QTableWidgetItem* dateItem = new QTableWidgetItem(commande.getDateCommande().toString("dd/MM/yyyy"));
+    dateItem->setForeground(QColor("#000000")); // Noir
+    tableCommandes->setItem(ligne, 1, dateItem);
+    
+    // Statut avec couleur
+    QTableWidgetItem* statutItem = new QTableWidgetItem(commande.getStatut());
+    if (commande.getStatut() == "En attente") {
+        statutItem->setBackground(QColor("#FFA726"));  // Orange vif
+        statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+    } else if (commande.getStatut() == "En cours") {
+        statutItem->setBackground(QColor("#42A5F5"));  // Bleu vif
+        statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+    } else if (commande.getStatut() == "Livree") {
+        statutItem->setBackground(QColor("#66BB6A"));  // Vert vif
+        statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+    } else if (commande.getStatut() == "Annulee") {
+        statutItem->setBackground(QColor("#EF5350"));  // Rouge vif
+        statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+    }
+    tableCommandes->setItem(ligne, 2, statutItem);
+    
+    // Ville avec couleur explicite
+    QTableWidgetItem* villeItem = new QTableWidgetItem(commande.getVilleLivraison());
+    villeItem->setForeground(QColor("#000000")); // Noir
+    tableCommandes->setItem(ligne, 3, villeItem);
+    
+    // Client avec couleur explicite
+    QTableWidgetItem* clientItem = new QTableWidgetItem(QString::number(commande.getIdClient()));
+    clientItem->setForeground(QColor("#000000")); // Noir
+    tableCommandes->setItem(ligne, 4, clientItem);
+    
+    // Livreur avec couleur explicite
+    QString livreur = commande.getIdLivreur() > 0 ? QString::number(commande.getIdLivreur()) : "Non assigné";
+    QTableWidgetItem* livreurItem = new QTableWidgetItem(livreur);
+    livreurItem->setForeground(QColor("#000000")); // Noir
+    tableCommandes->setItem(ligne, 5, livreurItem);
+}
+
+void CommandeWidget::synchroniser()
+{
+    PorteeTrace portee("CommandeWidget::synchroniser", "ui");
+    
+    if (!vueComplete || !filigrane.isValid()) {
+        actualiserListe();
+        return;
+    }
+    
+    ModificationsCommandes modifications = commandeService->obtenirModificationsDepuis(filigrane);
+    if (!modifications.filigrane.isValid()) {
+        actualiserListe();
+        return;
+    }
+    
+    fusionnerCommandes(modifications.modifiees, modifications.supprimees);
+    filigrane = modifications.filigrane;
+}
+
+void CommandeWidget::fusionnerCommandes(const QList<Commande>& modifiees, const QList<int>& supprimees)
+{
+    PorteeTrace portee("CommandeWidget::fusionnerCommandes", "ui");
+    
+    if (modifiees.isEmpty() && supprimees.isEmpty()) {
+        return;
+    }
+    
+    tableCommandes->setSortingEnabled(false);
+    
+    // Suppressions du bas vers le haut : les indices restants restent valides
+    QSet<int> idsSupprimes(supprimees.begin(), supprimees.end());
+    for (int ligne = tableCommandes->rowCount() - 1; ligne >= 0; --ligne) {
+        if (idsSupprimes.contains(tableCommandes->item(ligne, 0)->text().toInt())) {
+            tableCommandes->removeRow(ligne);
         }
-        tableCommandes->setItem(i, 2, statutItem);
-        
-        // Ville avec couleur explicite
-        QTableWidgetItem* villeItem = new QTableWidgetItem(cmd.getVilleLivraison());
-        villeItem->setForeground(QColor("#000000")); // Noir
-        tableCommandes->setItem(i, 3, villeItem);
-        
-        // Client avec couleur explicite
-        QTableWidgetItem* clientItem = new QTableWidgetItem(QString::number(cmd.getIdClient()));
-        clientItem->setForeground(QColor("#000000")); // Noir
-        tableCommandes->setItem(i, 4, clientItem);
+    }
+    
+    QHash<int, int> lignes;
+    for (int ligne = 0; ligne < tableCommandes->rowCount(); ++ligne) {
+        lignes.insert(tableCommandes->item(ligne, 0)->text().toInt(), ligne);
+    }
+    
+    // Mise à jour en place, ajout en fin de tableau (le tri les replace)
+    for (const Commande& commande : modifiees) {
+        if (idsSupprimes.contains(commande.getIdCommande())) continue;
         
-        // Livreur avec couleur explicite
-        QString livreur = cmd.getIdLivreur() > 0 ? QString::number(cmd.getIdLivreur()) : "Non assigné";
-        QTableWidgetItem* livreurItem = new QTableWidgetItem(livreur);
-        livreurItem->setForeground(QColor("#000000")); // Noir
-        tableCommandes->setItem(i, 5, livreurItem);
+        int ligne = lignes.value(commande.getIdCommande(), -1);
+        if (ligne < 0) {
+            ligne = tableCommandes->rowCount();
+            tableCommandes->insertRow(ligne);
+            lignes.insert(commande.getIdCommande(), ligne);
+        }
+        remplirLigne(ligne, commande);
     }
     
-    tableCommandes->resizeColumnsToContents();
+    tableCommandes->setSortingEnabled(true);
+    selectionChangee();
+}
+
+QList<int> CommandeWidget::commandesSelectionnees() const
+{
+    QList<int> ids;
+    const QModelIndexList lignes = tableCommandes->selectionModel()->selectedRows();
+    for (const QModelIndex& ligne : lignes) {
+        ids << tableCommandes->item(ligne.row(), 0)->text().toInt();
+    }
+    return ids;
 }
 
 void CommandeWidget::selectionChangee()
 {
     int row = tableCommandes->currentRow();
-    bool hasSelection = row >= 0;
+    int nombre = tableCommandes->selectionModel()->selectedRows().size();
+    bool hasSelection = row >= 0 && nombre > 0;
     
-    btnModifier->setEnabled(hasSelection);
+    // Modification et PDF : une seule commande ; le reste s'applique au lot
+    btnModifier->setEnabled(hasSelection && nombre == 1);
     btnSupprimer->setEnabled(hasSelection);
     btnAffecterLivreur->setEnabled(hasSelection);
     btnChangerStatut->setEnabled(hasSelection);
-    btnGenererPDF->setEnabled(hasSelection);
+    btnGenererPDF->setEnabled(hasSelection && nombre == 1);
     
-    if (hasSelection) {
+    if (hasSelection && nombre > 1) {
+        commandeSelectionnee = tableCommandes->item(row, 0)->text().toInt();
+        labelDetails->setText(QString("<h3>%1 commandes sélectionnées</h3>"
+            "<p>Statut, affectation et suppression s'appliquent à toute la sélection.</p>").arg(nombre));
+    } else if (hasSelection) {
         commandeSelectionnee = tableCommandes->item(row, 0)->text().toInt();
         mettreAJourDetails();
     } else {
@@ -573,9 +683,13 @@ void CommandeWidget::ajouterCommande()
     CommandeDialog dialog(this);
     if (dialog.exec() == QDialog::Accepted) {
         Commande nouvelleCommande = dialog.getCommande();
-        if (commandeService->ajouterCommande(nouvelleCommande)) {
+        Commande creee;
+        if (commandeService->ajouterCommande(nouvelleCommande, &creee)) {
+            // Ajout dans la liste complète ; un résultat de recherche reste inchangé
+            if (vueComplete) {
+                fusionnerCommandes({creee}, {});
+            }
             QMessageBox::information(this, "Succès", "Commande ajoutée avec succès!");
-            actualiserListe();
         } else {
             QMessageBox::warning(this, "Erreur", "Erreur lors de l'ajout de la commande.");
         }
@@ -591,9 +705,10 @@ void CommandeWidget::modifierCommande()
     
     if (dialog.exec() == QDialog::Accepted) {
         Commande commandeModifiee = dialog.getCommande();
-        if (commandeService->modifierCommande(commandeModifiee)) {
+        Commande enregistree;
+        if (commandeService->modifierCommande(commandeModifiee, &enregistree)) {
+            fusionnerCommandes({enregistree}, {});
             QMessageBox::information(this, "Succès", "Commande modifiée avec succès!");
-            actualiserListe();
         } else {
             QMessageBox::warning(this, "Erreur", "Erreur lors de la modification de la commande.");
         }
@@ -604,15 +719,34 @@ void CommandeWidget::supprimerCommande()
 {
     if (commandeSelectionnee <= 0) return;
     
+    QList<int> ids = commandesSelectionnees();
+    if (ids.size() > 1) {
+        int ret = QMessageBox::question(this, "Confirmation",
+            QString("Êtes-vous sûr de vouloir supprimer les %1 commandes sélectionnées ?").arg(ids.size()),
+            QMessageBox::Yes | QMessageBox::No);
+        
+        if (ret == QMessageBox::Yes) {
+            QList<int> supprimees;
+            if (commandeService->supprimerCommandes(ids, &supprimees)) {
+                fusionnerCommandes({}, supprimees);
+                QMessageBox::information(this, "Succès", QString("%1 commandes supprimées.").arg(supprimees.size()));
+            } else {
+                QMessageBox::warning(this, "Erreur", "Erreur lors de la suppression des commandes.");
+            }
+        }
+        return;
+    }
+    
     Commande cmd = commandeService->obtenirCommande(commandeSelectionnee);
     int ret = QMessageBox::question(this, "Confirmation", 
         QString("Êtes-vous sûr de vouloir supprimer la commande #%1 ?").arg(cmd.getIdCommande()),
         QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        if (commandeService->supprimerCommande(commandeSelectionnee)) {
+        int idSupprime = commandeSelectionnee;
+        if (commandeService->supprimerCommande(idSupprime)) {
+            fusionnerCommandes({}, {idSupprime});
             QMessageBox::information(this, "Succès", "Commande supprimée avec succès!");
-            actualiserListe();
         } else {
             QMessageBox::warning(this, "Erreur", "Erreur lors de la suppression de la commande.");
         }
@@ -685,9 +819,23 @@ void CommandeWidget::affecterLivreur()
         int index = livreurs.indexOf(selection);
         int idLivreur = ids[index];
         
-        if (commandeService->affecterLivreur(commandeSelectionnee, idLivreur)) {
+        QList<int> selectionnees = commandesSelectionnees();
+        if (selectionnees.size() > 1) {
+            QList<Commande> affectees;
+            if (commandeService->affecterLivreurCommandes(selectionnees, idLivreur, &affectees)) {
+                fusionnerCommandes(affectees, {});
+                QMessageBox::information(this, "Succès",
+                    QString("Livreur affecté à %1 commandes.").arg(affectees.size()));
+            } else {
+                QMessageBox::warning(this, "Erreur", "Erreur lors de l'affectation du livreur.");
+            }
+            return;
+        }
+        
+        Commande affectee;
+        if (commandeService->affecterLivreur(commandeSelectionnee, idLivreur, &affectee)) {
+            fusionnerCommandes({affectee}, {});
             QMessageBox::information(this, "Succès", "Livreur affecté avec succès!");
-            actualiserListe();
         } else {
             QMessageBox::warning(this, "Erreur", "Erreur lors de l'affectation du livreur.");
         }
@@ -704,12 +852,26 @@ void CommandeWidget::changerStatut()
         "Nouveau statut:", statuts, 0, false, &ok);
     
     if (ok && !nouveauStatut.isEmpty()) {
+        QList<int> ids = commandesSelectionnees();
+        if (ids.size() > 1) {
+            QList<Commande> modifiees;
+            if (commandeService->changerStatutCommandes(ids, nouveauStatut, &modifiees)) {
+                fusionnerCommandes(modifiees, {});
+                QMessageBox::information(this, "Succès",
+                    QString("Statut modifié pour %1 commandes.").arg(modifiees.size()));
+            } else {
+                QMessageBox::warning(this, "Erreur", "Erreur lors de la modification du statut.");
+            }
+            return;
+        }
+        
         Commande cmd = commandeService->obtenirCommande(commandeSelectionnee);
         cmd.setStatut(nouveauStatut);
         
-        if (commandeService->modifierCommande(cmd)) {
+        Commande enregistree;
+        if (commandeService->modifierCommande(cmd, &enregistree)) {
+            fusionnerCommandes({enregistree}, {});
             QMessageBox::information(this, "Succès", "Statut modifié avec succès!");
-            actualiserListe();
         } else {
             QMessageBox::warning(this, "Erreur", "Erreur lors de la modification du statut.");
         }
@@ -718,6 +880,8 @@ void CommandeWidget::changerStatut()
 
 void CommandeWidget::genererPDF()
 {
+    PorteeTrace portee("CommandeWidget::genererPDF", "rapport");
+    
     if (commandeSelectionnee <= 0) return;
     
     QString fileName = QFileDialog::getSaveFileName(this, "Enregistrer le PDF",
@@ -736,6 +900,8 @@ void CommandeWidget::genererPDF()
 
 void CommandeWidget::genererRapport()
 {
+    PorteeTrace portee("CommandeWidget::genererRapport", "rapport");
+    
     QString fileName = QFileDialog::getSaveFileName(this, "Enregistrer le rapport",
         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/rapport_commandes.pdf",
         "Fichiers PDF (*.pdf)");
@@ -757,3 +923,38 @@ void CommandeWidget::afficherCommandesEnRetard()
     QMessageBox::information(this, "Commandes en retard", 
         QString("Nombre de commandes en retard: %1").arg(commandesEnRetard.size()));
 }
+
+void CommandeWidget::repartirAutomatiquement()
+{
+    int ret = QMessageBox::question(this, "Répartition automatique",
+        "Affecter toutes les commandes en attente aux livreurs disponibles ?\n\n"
+        "La répartition privilégie la zone du livreur puis équilibre la charge.",
+        QMessageBox::Yes | QMessageBox::No);
+    
+    if (ret != QMessageBox::Yes) return;
+    
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    RepartitionService repartitionService;
+    RapportRepartition rapport = repartitionService.repartirCommandesEnAttente();
+    QApplication::restoreOverrideCursor();
+    
+    if (!rapport.succes) {
+        QMessageBox::warning(this, "Erreur", "Erreur lors de la répartition:\n" + rapport.erreur);
+        return;
+    }
+    
+    QMessageBox::information(this, "Répartition automatique",
+        QString("Commandes en attente: %1\n"
+                "Livreurs disponibles: %2\n"
+                "Commandes affectées: %3\n\n"
+                "Durée: %4 ms (calcul: %5 ms)\n"
+                "Débit: %6 affectations/s")
+        .arg(rapport.commandesEnAttente)
+        .arg(rapport.livreursDisponibles)
+        .arg(rapport.affectations)
+        .arg(rapport.dureeTotaleMs)
+        .arg(rapport.dureeCalculMs)
+        .arg(rapport.affectationsParSeconde, 0, 'f', 0));
+    
+    actualiserListe();
+}
@@ -33,8 +33,13 @@ class CommandeWidget : public QWidget
 public:
     explicit CommandeWidget(QWidget *parent = nullptr);
     
+    // Lignes affichées (panneau de diagnostic)
+    int nombreLignes() const { return tableCommandes->rowCount(); }
+    
 public slots:
     void actualiserListe();
+    // Fusion des lignes modifiées depuis le dernier chargement
+    void synchroniser();
 
 private slots:
     void ajouterCommande();
@@ -48,6 +53,7 @@ private slots:
     void genererPDF();
     void genererRapport();
     void afficherCommandesEnRetard();
+    void repartirAutomatiquement();
 
 private:
     void setupUI();
@@ -57,7 +63,10 @@ private:
     void connecterSignaux();
     void chargerCommandes();
     void chargerCommandes(const QList<Commande>& commandes);
+    void remplirLigne(int ligne, const Commande& commande);
+    void fusionnerCommandes(const QList<Commande>& modifiees, const QList<int>& supprimees);
     void mettreAJourDetails();
+    QList<int> commandesSelectionnees() const;
     void appliquerStyle();
     
     // Interface principale
@@ -90,6 +99,7 @@ private:
     QPushButton* btnGenererPDF;
     QPushButton* btnGenererRapport;
     QPushButton* btnCommandesEnRetard;
+    QPushButton* btnRepartitionAuto;
     
     // Panneau de détails
     QGroupBox* groupDetails;
@@ -98,6 +108,10 @@ private:
     // Services
     CommandeService* commandeService;
     int commandeSelectionnee;
+    
+    // Synchronisation différentielle (liste complète uniquement)
+    QDateTime filigrane;
+    bool vueComplete;
 };
 
 // Dialogue pour ajouter/modifier une commande
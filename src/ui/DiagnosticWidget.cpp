@@ -0,0 +1,263 @@
+#include "DiagnosticWidget.h"
+#include "db/InstrumentationRequetes.h"
+#include "services/IndexFiltres.h"
+#include "services/DetecteurChangements.h"
+#include "utils/MemoireProcessus.h"
+#include "utils/SurveillantBoucle.h"
+#include <QApplication>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QInputEvent>
+#include <algorithm>
+
+DiagnosticWidget::DiagnosticWidget(QWidget *parent)
+    : QWidget(parent)
+    , derniereSaisie(0)
+    , appelsDebutInteraction(0)
+    , dureeDebutInteractionNs(0)
+    , appelsInteractionPrecedente(0)
+    , dureeInteractionPrecedenteNs(0)
+    , retardCourantMs(0.0)
+    , retardMaxMs(0.0)
+{
+    setupUI();
+
+    minuteurRafraichissement.setInterval(INTERVALLE_RAFRAICHISSEMENT_MS);
+    connect(&minuteurRafraichissement, &QTimer::timeout, this, &DiagnosticWidget::rafraichir);
+
+    minuteurRetard.setTimerType(Qt::PreciseTimer);
+    minuteurRetard.setInterval(INTERVALLE_RETARD_MS);
+    connect(&minuteurRetard, &QTimer::timeout, this, &DiagnosticWidget::mesurerRetard);
+
+    connect(btnReinitialiser, &QPushButton::clicked, this, &DiagnosticWidget::reinitialiser);
+}
+
+void DiagnosticWidget::setupUI()
+{
+    mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(8);
+    mainLayout->setContentsMargins(8, 8, 8, 8);
+
+    QGroupBox* groupMesures = new QGroupBox("Mesures en direct");
+    formulaire = new QFormLayout(groupMesures);
+    labelInteraction = ajouterLigne("Depuis la dernière saisie :");
+    labelInteractionPrecedente = ajouterLigne("Interaction précédente :");
+    labelSession = ajouterLigne("Session :");
+    labelEnCours = ajouterLigne("Requêtes en cours :");
+    labelIndex = ajouterLigne("Index en mémoire :");
+    labelDetecteur = ajouterLigne("Détection des changements :");
+    labelRetard = ajouterLigne("Retard de la boucle :");
+    labelBlocages = ajouterLigne("Blocages de la boucle :");
+    labelMemoire = ajouterLigne("Mémoire :");
+    mainLayout->addWidget(groupMesures);
+
+    QGroupBox* groupCouteuses = new QGroupBox("Requêtes les plus coûteuses (durée totale)");
+    QVBoxLayout* couteusesLayout = new QVBoxLayout(groupCouteuses);
+    tableCouteuses = new QTableWidget(0, 7);
+    tableCouteuses->setHorizontalHeaderLabels({"Appels", "Total ms", "Moy. ms", "p95 ms", "Max ms", "Lignes", "SQL"});
+    couteusesLayout->addWidget(tableCouteuses);
+    mainLayout->addWidget(groupCouteuses);
+
+    QGroupBox* groupLentes = new QGroupBox("Dernières requêtes lentes");
+    QVBoxLayout* lentesLayout = new QVBoxLayout(groupLentes);
+    tableLentes = new QTableWidget(0, 4);
+    tableLentes->setHorizontalHeaderLabels({"Heure", "Durée ms", "SQL", "Paramètres"});
+    lentesLayout->addWidget(tableLentes);
+    mainLayout->addWidget(groupLentes);
+
+    for (QTableWidget* table : {tableCouteuses, tableLentes}) {
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->verticalHeader()->setVisible(false);
+        table->horizontalHeader()->setStretchLastSection(true);
+        table->setWordWrap(false);
+    }
+
+    btnReinitialiser = new QPushButton("Réinitialiser les mesures");
+    mainLayout->addWidget(btnReinitialiser);
+}
+
+QLabel* DiagnosticWidget::ajouterLigne(const QString& libelle)
+{
+    QLabel* valeur = new QLabel("-");
+    valeur->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    formulaire->addRow(libelle, valeur);
+    return valeur;
+}
+
+void DiagnosticWidget::ajouterCompteur(const QString& nom, const std::function<int()>& valeur)
+{
+    compteurs.append(qMakePair(ajouterLigne(nom + " :"), valeur));
+}
+
+void DiagnosticWidget::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+
+    // Interactions suivies seulement panneau visible
+    InstrumentationRequetes* instrumentation = InstrumentationRequetes::getInstance();
+    appelsDebutInteraction = instrumentation->totalAppels();
+    dureeDebutInteractionNs = instrumentation->totalDureeNs();
+    qApp->installEventFilter(this);
+
+    retardCourantMs = 0.0;
+    retardMaxMs = 0.0;
+    fenetreRetardMax.start();
+    horlogeRetard.start();
+    minuteurRetard.start();
+    minuteurRafraichissement.start();
+    rafraichir();
+}
+
+void DiagnosticWidget::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    qApp->removeEventFilter(this);
+    minuteurRetard.stop();
+    minuteurRafraichissement.stop();
+}
+
+bool DiagnosticWidget::eventFilter(QObject* objet, QEvent* event)
+{
+    // Une saisie ouvre une nouvelle interaction ; un événement propagé aux
+    // parents repasse ici avec le même horodatage
+    if (event->type() == QEvent::MouseButtonPress || event->type() == QEvent::KeyPress) {
+        const quint64 horodatage = static_cast<QInputEvent*>(event)->timestamp();
+        if (horodatage != derniereSaisie) {
+            derniereSaisie = horodatage;
+
+            InstrumentationRequetes* instrumentation = InstrumentationRequetes::getInstance();
+            const qint64 appels = instrumentation->totalAppels();
+            const qint64 dureeNs = instrumentation->totalDureeNs();
+            appelsInteractionPrecedente = appels - appelsDebutInteraction;
+            dureeInteractionPrecedenteNs = dureeNs - dureeDebutInteractionNs;
+            appelsDebutInteraction = appels;
+            dureeDebutInteractionNs = dureeNs;
+        }
+    }
+    return QWidget::eventFilter(objet, event);
+}
+
+void DiagnosticWidget::mesurerRetard()
+{
+    // Réveil attendu toutes les INTERVALLE_RETARD_MS : le surplus est du
+    // temps pendant lequel la boucle n'a pas pu traiter d'événement
+    const double ecartMs = horlogeRetard.nsecsElapsed() / 1e6;
+    horlogeRetard.restart();
+    retardCourantMs = std::max(0.0, ecartMs - INTERVALLE_RETARD_MS);
+
+    if (fenetreRetardMax.elapsed() > FENETRE_RETARD_MAX_MS) {
+        retardMaxMs = 0.0;
+        fenetreRetardMax.restart();
+    }
+    retardMaxMs = std::max(retardMaxMs, retardCourantMs);
+}
+
+QString DiagnosticWidget::ratio(qint64 succes, qint64 total)
+{
+    return total > 0 ? QString("%1 %").arg(100.0 * succes / total, 0, 'f', 1) : QString("-");
+}
+
+void DiagnosticWidget::rafraichir()
+{
+    InstrumentationRequetes* instrumentation = InstrumentationRequetes::getInstance();
+    const qint64 appels = instrumentation->totalAppels();
+    const qint64 dureeNs = instrumentation->totalDureeNs();
+
+    labelInteraction->setText(QString("%1 allers-retours, %2 ms en base")
+                              .arg(appels - appelsDebutInteraction)
+                              .arg((dureeNs - dureeDebutInteractionNs) / 1e6, 0, 'f', 1));
+    labelInteractionPrecedente->setText(QString("%1 allers-retours, %2 ms en base")
+                                        .arg(appelsInteractionPrecedente)
+                                        .arg(dureeInteractionPrecedenteNs / 1e6, 0, 'f', 1));
+    labelSession->setText(instrumentation->estActive()
+                          ? QString("%1 requêtes, %2 s en base").arg(appels).arg(dureeNs / 1e9, 0, 'f', 2)
+                          : QString("instrumentation désactivée"));
+    labelEnCours->setText(QString::number(instrumentation->requetesEnCours()));
+
+    IndexFiltres* index = IndexFiltres::getInstance();
+    const qint64 servies = index->lecturesServies();
+    const qint64 chargements = index->chargementsComplets();
+    labelIndex->setText(QString("%1 commandes, %2 livreurs ; %3 des lectures servies (%4 chargements)")
+                        .arg(index->nombreCommandes())
+                        .arg(index->nombreLivreurs())
+                        .arg(ratio(servies, servies + chargements))
+                        .arg(chargements));
+
+    DetecteurChangements* detecteur = DetecteurChangements::getInstance();
+    labelDetecteur->setText(QString("%1 vérifications ; %2 sans rechargement")
+                            .arg(detecteur->verifications())
+                            .arg(ratio(detecteur->verificationsSansChangement(), detecteur->verifications())));
+
+    labelRetard->setText(QString("%1 ms (max sur 10 s : %2 ms)")
+                         .arg(retardCourantMs, 0, 'f', 1).arg(retardMaxMs, 0, 'f', 1));
+
+    SurveillantBoucle* surveillant = SurveillantBoucle::getInstance();
+    const QList<BlocageBoucle> dernier = surveillant->derniersBlocages(1);
+    if (!surveillant->estActive()) {
+        labelBlocages->setText("surveillance désactivée");
+    } else if (dernier.isEmpty()) {
+        labelBlocages->setText(QString("%1 (seuil %2 ms)").arg(surveillant->blocagesDetectes()).arg(surveillant->seuilMs()));
+    } else {
+        labelBlocages->setText(QString("%1 ; dernier : %2 ms dans %3")
+                               .arg(surveillant->blocagesDetectes())
+                               .arg(dernier.first().dureeMs)
+                               .arg(dernier.first().portees.isEmpty() ? QString("?") : dernier.first().portees.last()));
+    }
+
+    const qint64 residente = MemoireProcessus::residenteKo();
+    const qint64 pic = MemoireProcessus::picKo();
+    labelMemoire->setText(residente > 0 || pic > 0
+                          ? QString("%1 Mio résidents (pic %2 Mio)")
+                                .arg(residente / 1024.0, 0, 'f', 1).arg(pic / 1024.0, 0, 'f', 1)
+                          : QString("indisponible"));
+
+    for (const auto& compteur : compteurs) {
+        const int valeur = compteur.second();
+        compteur.first->setText(valeur >= 0 ? QString::number(valeur) : QString("-"));
+    }
+
+    rafraichirRequetes();
+}
+
+void DiagnosticWidget::rafraichirRequetes()
+{
+    InstrumentationRequetes* instrumentation = InstrumentationRequetes::getInstance();
+
+    const QList<StatistiquesRequete> couteuses = instrumentation->plusCouteuses(REQUETES_AFFICHEES);
+    tableCouteuses->setRowCount(couteuses.size());
+    for (int i = 0; i < couteuses.size(); ++i) {
+        const StatistiquesRequete& stats = couteuses[i];
+        tableCouteuses->setItem(i, 0, new QTableWidgetItem(QString::number(stats.appels)));
+        tableCouteuses->setItem(i, 1, new QTableWidgetItem(QString::number(stats.dureeTotaleNs / 1e6, 'f', 1)));
+        tableCouteuses->setItem(i, 2, new QTableWidgetItem(QString::number(stats.dureeMoyenneMs(), 'f', 2)));
+        tableCouteuses->setItem(i, 3, new QTableWidgetItem(QString::number(stats.centileMs(0.95), 'f', 1)));
+        tableCouteuses->setItem(i, 4, new QTableWidgetItem(QString::number(stats.dureeMaxNs / 1e6, 'f', 1)));
+        tableCouteuses->setItem(i, 5, new QTableWidgetItem(QString::number(stats.lignes)));
+        QTableWidgetItem* sql = new QTableWidgetItem(stats.sql);
+        sql->setToolTip(stats.sql);
+        tableCouteuses->setItem(i, 6, sql);
+    }
+
+    // Plus récente en tête
+    QList<RequeteLente> lentes = instrumentation->dernieresLentes(REQUETES_AFFICHEES);
+    std::reverse(lentes.begin(), lentes.end());
+    tableLentes->setRowCount(lentes.size());
+    for (int i = 0; i < lentes.size(); ++i) {
+        const RequeteLente& lente = lentes[i];
+        tableLentes->setItem(i, 0, new QTableWidgetItem(lente.date.toString("HH:mm:ss")));
+        tableLentes->setItem(i, 1, new QTableWidgetItem(QString::number(lente.dureeMs, 'f', 1)));
+        QTableWidgetItem* sql = new QTableWidgetItem(lente.sql);
+        sql->setToolTip(lente.sql);
+        tableLentes->setItem(i, 2, sql);
+        tableLentes->setItem(i, 3, new QTableWidgetItem(lente.valeurs));
+    }
+}
+
+void DiagnosticWidget::reinitialiser()
+{
+    InstrumentationRequetes::getInstance()->reinitialiser();
+    retardMaxMs = 0.0;
+    fenetreRetardMax.restart();
+    rafraichir();
+}
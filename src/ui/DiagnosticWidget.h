@@ -0,0 +1,89 @@
+#ifndef DIAGNOSTICWIDGET_H
+#define DIAGNOSTICWIDGET_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QLabel>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <functional>
+
+// Panneau de diagnostic (dock de la fenêtre principale) : allers-retours
+// en base par interaction, efficacité de l'index et du détecteur de
+// changements, requêtes en cours, retard et blocages de la boucle
+// d'événements, lignes affichées, mémoire, requêtes les plus coûteuses et dernières requêtes
+// lentes. Rien ne tourne tant que le panneau est masqué : minuteurs et
+// filtre d'événements sont posés à l'affichage et retirés au masquage.
+class DiagnosticWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticWidget(QWidget *parent = nullptr);
+
+    // Compteur affiché tel quel (ex. lignes d'un onglet) ; -1 : indisponible
+    void ajouterCompteur(const QString& nom, const std::function<int()>& valeur);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    bool eventFilter(QObject* objet, QEvent* event) override;
+
+private slots:
+    void rafraichir();
+    void mesurerRetard();
+    void reinitialiser();
+
+private:
+    void setupUI();
+    void rafraichirRequetes();
+    QLabel* ajouterLigne(const QString& libelle);
+    static QString ratio(qint64 succes, qint64 total);
+
+    QVBoxLayout* mainLayout;
+    QFormLayout* formulaire;
+
+    QLabel* labelInteraction;
+    QLabel* labelInteractionPrecedente;
+    QLabel* labelSession;
+    QLabel* labelEnCours;
+    QLabel* labelIndex;
+    QLabel* labelDetecteur;
+    QLabel* labelRetard;
+    QLabel* labelBlocages;
+    QLabel* labelMemoire;
+    QList<QPair<QLabel*, std::function<int()>>> compteurs;
+
+    QTableWidget* tableCouteuses;
+    QTableWidget* tableLentes;
+    QPushButton* btnReinitialiser;
+
+    QTimer minuteurRafraichissement;
+    QTimer minuteurRetard;
+    QElapsedTimer horlogeRetard;
+
+    // Interaction : allers-retours et temps en base depuis la dernière
+    // saisie (clic, touche), et bilan de l'interaction précédente
+    quint64 derniereSaisie;
+    qint64 appelsDebutInteraction;
+    qint64 dureeDebutInteractionNs;
+    qint64 appelsInteractionPrecedente;
+    qint64 dureeInteractionPrecedenteNs;
+
+    // Retard de la boucle : écart au réveil attendu du minuteur
+    double retardCourantMs;
+    double retardMaxMs;
+    QElapsedTimer fenetreRetardMax;
+
+    static constexpr int INTERVALLE_RAFRAICHISSEMENT_MS = 1000;
+    static constexpr int INTERVALLE_RETARD_MS = 100;
+    static constexpr int FENETRE_RETARD_MAX_MS = 10000;
+    static constexpr int REQUETES_AFFICHEES = 10;
+};
+
+#endif // DIAGNOSTICWIDGET_H
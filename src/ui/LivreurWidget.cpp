@@ -1,5 +1,11 @@
 #include "LivreurWidget.h"
+#include "utils/Trace.h"
 #include "services/CommandeService.h"
+#include "services/PlanificateurTournees.h"
+#include "services/ModeleCapacite.h"
+#include "db/DatabaseManager.h"
+#include <QSet>
+#include <QHash>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QFileDialog>
@@ -179,6 +185,7 @@ Livreur LivreurDialog::getLivreur() const
 LivreurWidget::LivreurWidget(QWidget *parent)
     : QWidget(parent)
     , livreurSelectionne(-1)
+    , vueComplete(false)
 {
     livreurService = new LivreurService(this);
     setupUI();
@@ -470,8 +477,39 @@ void LivreurWidget::appliquerStyle()
 
 void LivreurWidget::actualiserListe()
 {
-    QList<Livreur> livreurs = livreurService->obtenirTousLivreurs();
+    PorteeTrace portee("LivreurWidget::actualiserListe", "ui");
+    
+    // Filigrane pris avant la lecture : les écritures concurrentes seront
+    // récupérées par la prochaine synchronisation. Sans connexion (vue tirée
+    // de l'instantané local), aucun : la prochaine synchronisation relit la
+    // vue et le prend alors
+    DatabaseManager* db = DatabaseManager::getInstance();
+    QDateTime filigraneLecture = db->isConnected() ? db->currentServerTime() : QDateTime();
+    
+    QList<Livreur> livreurs = livreurService->rechercherLivreurs("", "", false);
     chargerLivreurs(livreurs);
+    
+    filigrane = filigraneLecture;
+    vueComplete = true;
+}
+
+void LivreurWidget::synchroniser()
+{
+    PorteeTrace portee("LivreurWidget::synchroniser", "ui");
+    
+    if (!vueComplete || !filigrane.isValid()) {
+        actualiserListe();
+        return;
+    }
+    
+    ModificationsLivreurs modifications = livreurService->obtenirModificationsDepuis(filigrane);
+    if (!modifications.filigrane.isValid()) {
+        actualiserListe();
+        return;
+    }
+    
+    fusionnerLivreurs(modifications.modifies, modifications.supprimes);
+    filigrane = modifications.filigrane;
 }
 
 void LivreurWidget::ajouterLivreur()
@@ -481,9 +519,13 @@ void LivreurWidget::ajouterLivreur()
     if (dialog.exec() == QDialog::Accepted) {
         Livreur livreur = dialog.getLivreur();
         
-        if (livreurService->ajouterLivreur(livreur)) {
+        Livreur cree;
+        if (livreurService->ajouterLivreur(livreur, &cree)) {
+            // Ajout dans la liste complète ; un résultat de recherche reste inchangé
+            if (vueComplete) {
+                fusionnerLivreurs({cree}, {});
+            }
             QMessageBox::information(this, "Succès", "Livreur ajouté avec succès!");
-            actualiserListe();
         } else {
             QMessageBox::warning(this, "Erreur", "Impossible d'ajouter le livreur!");
         }
@@ -607,11 +649,22 @@ void LivreurWidget::mettreAJourDetails()
     // Compter les commandes actives (relation avec Commande)
     int commandesActives = livreurService->compterCommandesActives(livreurSelectionne);
     
+    int capacite = ModeleCapacite::getInstance()->capacite(livreur);
+    
     QString couleurStatut = livreur.getDisponibilite() ? "green" : "red";
-    QString alerteSurcharge = (commandesActives > 5) ? 
+    QString alerteSurcharge = (commandesActives > capacite) ? 
         "<span style='color: red;'>⚠️ SURCHARGE DÉTECTÉE</span>" : 
         "<span style='color: green;'>✅ Charge normale</span>";
     
+    // Ordre de livraison optimisé des commandes actives
+    QString itineraire = "Aucune commande active";
+    if (commandesActives > 0) {
+        PlanificateurTournees planificateur;
+        planificateur.setBudgetMs(20);
+        Tournee tournee = planificateur.planifier(livreur);
+        itineraire = QString("%1 (%2 km)").arg(tournee.itineraire()).arg(tournee.distanceKm, 0, 'f', 0);
+    }
+    
     QString details = QString(R"(
 <h3>Livreur #%1</h3>
 <p><b>👤 Nom:</b> %2</p>
@@ -619,8 +672,9 @@ void LivreurWidget::mettreAJourDetails()
 <p><b>📍 Zone:</b> %4</p>
 <p><b>🚗 Véhicule:</b> %5</p>
 <p><b>📊 Statut:</b> <span style="color: %6;">%7</span></p>
-<p><b>📦 Commandes actives:</b> %8</p>
+<p><b>📦 Commandes actives:</b> %8 / %11</p>
 <p><b>⚠️ Surcharge:</b> %9</p>
+<p><b>🗺️ Tournée:</b> %10</p>
     )").arg(livreur.getIdLivreur())
        .arg(livreur.getNom())
        .arg(livreur.getTelephone())
@@ -629,7 +683,9 @@ void LivreurWidget::mettreAJourDetails()
        .arg(couleurStatut)
        .arg(livreur.getDisponibiliteText())
        .arg(commandesActives)
-       .arg(alerteSurcharge);
+       .arg(alerteSurcharge)
+       .arg(itineraire)
+       .arg(capacite);
     
     labelDetails->setText(details);
 }
@@ -663,12 +719,14 @@ void LivreurWidget::afficherLivreursSurcharges()
         return;
     }
     
-    QString message = "Livreurs en surcharge (plus de 5 commandes actives):\n\n";
+    QString message = "Livreurs en surcharge (commandes actives au-delà de la capacité du véhicule):\n\n";
+    ModeleCapacite* capacites = ModeleCapacite::getInstance();
     for (const Livreur& livreur : livreursSurcharges) {
         int nbCommandes = livreurService->compterCommandesActives(livreur.getIdLivreur());
-        message += QString("• %1 - %2 commandes actives\n")
+        message += QString("• %1 - %2 commandes actives (capacité %3)\n")
                   .arg(livreur.getNom())
-                  .arg(nbCommandes);
+                  .arg(nbCommandes)
+                  .arg(capacites->capacite(livreur));
     }
     
     QMessageBox::warning(this, "Alertes Surcharge", message);
@@ -695,6 +753,8 @@ void LivreurWidget::afficherLivreursDisponibles()
 
 void LivreurWidget::genererRapportLivreurs()
 {
+    PorteeTrace portee("LivreurWidget::genererRapportLivreurs", "rapport");
+    
     QString fileName = QFileDialog::getSaveFileName(this, 
         "Enregistrer le rapport", 
         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/rapport_livreurs.pdf",
@@ -714,7 +774,7 @@ void LivreurWidget::genererListeLivreurs()
     QString fileName = QFileDialog::getSaveFileName(this, 
         "Enregistrer la liste", 
         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/liste_livreurs.xlsx",
-        "Fichiers Excel (*.xlsx)");
+        "Fichiers Excel (*.xlsx);;Fichiers CSV (*.csv)");
     
     if (!fileName.isEmpty()) {
         if (livreurService->genererListeLivreurs(fileName)) {
@@ -727,47 +787,98 @@ void LivreurWidget::genererListeLivreurs()
 
 void LivreurWidget::chargerLivreurs(const QList<Livreur>& livreurs)
 {
+    PorteeTrace portee("LivreurWidget::remplirTableau", "ui");
+    
+    // Résultat de recherche : la synchronisation différentielle ne s'applique pas
+    vueComplete = false;
+    
+    // Tri suspendu pendant le remplissage, sinon les lignes se déplacent
+    tableLivreurs->setSortingEnabled(false);
     tableLivreurs->setRowCount(livreurs.size());
     
     for (int i = 0; i < livreurs.size(); ++i) {
-        const Livreur& livreur = livreurs[i];
-        
-        // ID avec couleur explicite
-        QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(livreur.getIdLivreur()));
-        idItem->setForeground(QColor("#000000")); // Noir
-        tableLivreurs->setItem(i, 0, idItem);
-        
-        // Nom avec couleur explicite
-        QTableWidgetItem* nomItem = new QTableWidgetItem(livreur.getNom());
-        nomItem->setForeground(QColor("#000000")); // Noir
-        tableLivreurs->setItem(i, 1, nomItem);
-        
-        // Téléphone avec couleur explicite
-        QTableWidgetItem* telItem = new QTableWidgetItem(livreur.getTelephone());
-        telItem->setForeground(QColor("#000000")); // Noir
-        tableLivreurs->setItem(i, 2, telItem);
-        
-        // Zone avec couleur explicite
-        QTableWidgetItem* zoneItem = new QTableWidgetItem(livreur.getZoneLivraison());
-        zoneItem->setForeground(QColor("#000000")); // Noir
-        tableLivreurs->setItem(i, 3, zoneItem);
-        
-        // Véhicule avec couleur explicite
-        QTableWidgetItem* vehiculeItem = new QTableWidgetItem(livreur.getVehicule());
-        vehiculeItem->setForeground(QColor("#000000")); // Noir
-        tableLivreurs->setItem(i, 4, vehiculeItem);
+        remplirLigne(i, livreurs[i]);
+    }
+    
+    tableLivreurs->setSortingEnabled(true);
+    tableLivreurs->resizeColumnsToContents();
+}
+
+void LivreurWidget::remplirLigne(int ligne, const Livreur& livreur)
+{
+    // ID avec couleur explicite
+    QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(livreur.getIdLivreur()));
+    idItem->setForeground(QColor("#000000")); // Noir
+    tableLivreurs->setItem(ligne, 0, idItem);
+    
+    // Nom avec couleur explicite
+    QTableWidgetItem* nomItem = new QTableWidgetItem(livreur.getNom());
+    nomItem->setForeground(QColor("#000000")); // Noir
+    tableLivreurs->setItem(ligne, 1, nomItem);
+    
+    // Téléphone avec couleur explicite
+    QTableWidgetItem* telItem = new QTableWidgetItem(livreur.getTelephone());
+    telItem->setForeground(QColor("#000000")); // Noir
+    tableLivreurs->setItem(ligne, 2, telItem);
+    
+    // Zone avec couleur explicite
+    QTableWidgetItem* zoneItem = new QTableWidgetItem(livreur.getZoneLivraison());
+    zoneItem->setForeground(QColor("#000000")); // Noir
+    tableLivreurs->setItem(ligne, 3, zoneItem);
+    
+    // Véhicule avec couleur explicite
+    QTableWidgetItem* vehiculeItem = new QTableWidgetItem(livreur.getVehicule());
+    vehiculeItem->setForeground(QColor("#000000")); // Noir
+    tableLivreurs->setItem(ligne, 4, vehiculeItem);
+    
+    // Statut avec couleur
+    QTableWidgetItem* statutItem = new QTableWidgetItem(livreur.getDisponibiliteText());
+    if (livreur.getDisponibilite()) {
+        statutItem->setBackground(QColor("#66BB6A"));  // Vert vif
+        statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+    } else {
+        statutItem->setBackground(QColor("#EF5350"));  // Rouge vif
+        statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+    }
+    tableLivreurs->setItem(ligne, 5, statutItem);
+}
+
+void LivreurWidget::fusionnerLivreurs(const QList<Livreur>& modifies, const QList<int>& supprimes)
+{
+    PorteeTrace portee("LivreurWidget::fusionnerLivreurs", "ui");
+    
+    if (modifies.isEmpty() && supprimes.isEmpty()) {
+        return;
+    }
+    
+    tableLivreurs->setSortingEnabled(false);
+    
+    // Suppressions du bas vers le haut : les indices restants restent valides
+    QSet<int> idsSupprimes(supprimes.begin(), supprimes.end());
+    for (int ligne = tableLivreurs->rowCount() - 1; ligne >= 0; --ligne) {
+        if (idsSupprimes.contains(tableLivreurs->item(ligne, 0)->text().toInt())) {
+            tableLivreurs->removeRow(ligne);
+        }
+    }
+    
+    QHash<int, int> lignes;
+    for (int ligne = 0; ligne < tableLivreurs->rowCount(); ++ligne) {
+        lignes.insert(tableLivreurs->item(ligne, 0)->text().toInt(), ligne);
+    }
+    
+    // Mise à jour en place, ajout en fin de tableau (le tri les replace)
+    for (const Livreur& livreur : modifies) {
+        if (idsSupprimes.contains(livreur.getIdLivreur())) continue;
         
-        // Statut avec couleur
-        QTableWidgetItem* statutItem = new QTableWidgetItem(livreur.getDisponibiliteText());
-        if (livreur.getDisponibilite()) {
-            statutItem->setBackground(QColor("#66BB6A"));  // Vert vif
-            statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
-        } else {
-            statutItem->setBackground(QColor("#EF5350"));  // Rouge vif
-            statutItem->setForeground(QColor("#FFFFFF"));  // Blanc
+        int ligne = lignes.value(livreur.getIdLivreur(), -1);
+        if (ligne < 0) {
+            ligne = tableLivreurs->rowCount();
+            tableLivreurs->insertRow(ligne);
+            lignes.insert(livreur.getIdLivreur(), ligne);
         }
-        tableLivreurs->setItem(i, 5, statutItem);
+        remplirLigne(ligne, livreur);
     }
     
-    tableLivreurs->resizeColumnsToContents();
+    tableLivreurs->setSortingEnabled(true);
+    selectionChangee();
 }
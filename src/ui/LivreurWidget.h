@@ -32,8 +32,13 @@ class LivreurWidget : public QWidget
 public:
     explicit LivreurWidget(QWidget *parent = nullptr);
     
+    // Lignes affichées (panneau de diagnostic)
+    int nombreLignes() const { return tableLivreurs->rowCount(); }
+    
 public slots:
     void actualiserListe();
+    // Fusion des lignes modifiées depuis le dernier chargement
+    void synchroniser();
 
 private slots:
     void ajouterLivreur();
@@ -56,6 +61,8 @@ private:
     void connecterSignaux();
     void chargerLivreurs();
     void chargerLivreurs(const QList<Livreur>& livreurs);
+    void remplirLigne(int ligne, const Livreur& livreur);
+    void fusionnerLivreurs(const QList<Livreur>& modifies, const QList<int>& supprimes);
     void mettreAJourDetails();
     void appliquerStyle();
     
@@ -95,6 +102,10 @@ private:
     // Services
     LivreurService* livreurService;
     int livreurSelectionne;
+    
+    // Synchronisation différentielle (liste complète uniquement)
+    QDateTime filigrane;
+    bool vueComplete;
 };
 
 // Dialogue pour ajouter/modifier un livreur
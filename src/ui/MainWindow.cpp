@@ -2,11 +2,24 @@
 #include "CommandeWidget.h"
 #include "LivreurWidget.h"
 #include "StatistiquesWidget.h"
+#include "DiagnosticWidget.h"
+#include "SqueletteOnglet.h"
 #include "db/DatabaseManager.h"
+#include "services/IndexFiltres.h"
+#include "services/InstantaneDonnees.h"
+#include "services/MoniteurSurcharge.h"
+#include "services/MoniteurSLA.h"
+#include "services/DetecteurChangements.h"
+#include "utils/Trace.h"
 #include <QApplication>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QStandardPaths>
+#include <QScrollArea>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QPromise>
+#include <QTimer>
+#include <memory>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -14,13 +27,25 @@ MainWindow::MainWindow(QWidget *parent)
     , commandeWidget(nullptr)
     , livreurWidget(nullptr)
     , statistiquesWidget(nullptr)
+    , squeletteCommandes(nullptr)
+    , squeletteLivreurs(nullptr)
+    , squeletteStatistiques(nullptr)
+    , lectureInstantane(nullptr)
+    , chargementInitial(nullptr)
+    , donneesPretes(false)
+    , connexionTentee(false)
+    , dockDiagnostic(nullptr)
+    , diagnosticWidget(nullptr)
     , statusLabel(nullptr)
     , connectionLabel(nullptr)
+    , actualisationDemandee(false)
 {
     setupUI();
+    setupDiagnostic();
     setupMenus();
     setupStatusBar();
     connecterSignaux();
+    demarrerChargement();
     
     setWindowTitle("Système de Gestion Logistique - v1.0");
     setMinimumSize(1200, 800);
@@ -38,15 +63,16 @@ void MainWindow::setupUI()
     tabWidget = new QTabWidget(this);
     setCentralWidget(tabWidget);
     
-    // Création des widgets pour chaque module
-    commandeWidget = new CommandeWidget(this);
-    livreurWidget = new LivreurWidget(this);
-    statistiquesWidget = new StatistiquesWidget(this);
+    // Squelettes d'abord : chaque module lit ses données à la construction,
+    // il n'est construit qu'à la première activation de son onglet
+    squeletteCommandes = new SqueletteOnglet("Chargement des commandes...");
+    squeletteLivreurs = new SqueletteOnglet("Chargement des livreurs...");
+    squeletteStatistiques = new SqueletteOnglet("Chargement des statistiques...");
     
     // Ajout des onglets
-    tabWidget->addTab(commandeWidget, "📦 Gestion des Commandes");
-    tabWidget->addTab(livreurWidget, "🚚 Gestion des Livreurs");
-    tabWidget->addTab(statistiquesWidget, "📊 Statistiques");
+    tabWidget->addTab(squeletteCommandes, "📦 Gestion des Commandes");
+    tabWidget->addTab(squeletteLivreurs, "🚚 Gestion des Livreurs");
+    tabWidget->addTab(squeletteStatistiques, "📊 Statistiques");
     
     // Style des onglets
     tabWidget->setTabPosition(QTabWidget::North);
@@ -54,6 +80,27 @@ void MainWindow::setupUI()
     tabWidget->setDocumentMode(true);
 }
 
+void MainWindow::setupDiagnostic()
+{
+    diagnosticWidget = new DiagnosticWidget();
+    diagnosticWidget->ajouterCompteur("Lignes Commandes", [this]() {
+        return commandeWidget ? commandeWidget->nombreLignes() : -1;
+    });
+    diagnosticWidget->ajouterCompteur("Lignes Livreurs", [this]() {
+        return livreurWidget ? livreurWidget->nombreLignes() : -1;
+    });
+    
+    QScrollArea* defilement = new QScrollArea();
+    defilement->setWidget(diagnosticWidget);
+    defilement->setWidgetResizable(true);
+    
+    dockDiagnostic = new QDockWidget("Diagnostic", this);
+    dockDiagnostic->setObjectName("dockDiagnostic");
+    dockDiagnostic->setWidget(defilement);
+    addDockWidget(Qt::RightDockWidgetArea, dockDiagnostic);
+    dockDiagnostic->hide();
+}
+
 void MainWindow::setupMenus()
 {
     // Menu Fichier
@@ -90,6 +137,20 @@ void MainWindow::setupMenus()
     
     menuBaseDonnees->addAction(actionMettreAJourContraintes);
     
+    // Menu Affichage
+    QMenu* menuAffichage = mainMenuBar->addMenu("A&ffichage");
+    
+    QAction* actionDiagnostic = dockDiagnostic->toggleViewAction();
+    actionDiagnostic->setText("Panneau de &diagnostic");
+    actionDiagnostic->setShortcut(QKeySequence(Qt::Key_F12));
+    menuAffichage->addAction(actionDiagnostic);
+    
+    actionTrace = new QAction("Enregistrer une &trace d'exécution", this);
+    actionTrace->setToolTip("Enregistre les portées tracées jusqu'au prochain clic, puis les écrit au format chrome://tracing");
+    actionTrace->setCheckable(true);
+    actionTrace->setChecked(Trace::estActive());
+    menuAffichage->addAction(actionTrace);
+    
     // Menu Aide
     QMenu* menuAide = mainMenuBar->addMenu("&Aide");
     
@@ -109,9 +170,24 @@ void MainWindow::setupStatusBar()
     mainStatusBar->addWidget(statusLabel, 1);
     mainStatusBar->addPermanentWidget(connectionLabel);
     
-    // Vérifier l'état de la connexion
+    // Connexion ouverte une fois l'instantané local affiché
+    connectionLabel->setText("🟡 Connexion...");
+    connectionLabel->setStyleSheet("color: #b8860b;");
+}
+
+void MainWindow::ouvrirConnexion()
+{
+    // Une seule tentative : appelée aussi en fin de chargement, qui peut
+    // précéder l'appel différé ou suivre un échec déjà signalé
+    if (connexionTentee) {
+        return;
+    }
+    connexionTentee = true;
+    
+    // Poignée de main de la connexion principale, pendant que le fil de
+    // chargement établit la sienne et vérifie le schéma
     DatabaseManager* db = DatabaseManager::getInstance();
-    if (db->isConnected()) {
+    if (db->ouvrirConnexion()) {
         connectionLabel->setText("🟢 Connecté à Oracle");
         connectionLabel->setStyleSheet("color: green;");
     } else {
@@ -127,6 +203,17 @@ void MainWindow::connecterSignaux()
     connect(actionActualiser, &QAction::triggered, this, &MainWindow::actualiserDonnees);
     connect(actionExporter, &QAction::triggered, this, &MainWindow::exporterDonnees);
     connect(actionMettreAJourContraintes, &QAction::triggered, this, &MainWindow::mettreAJourContraintes);
+    connect(actionTrace, &QAction::toggled, this, &MainWindow::basculerTrace);
+    connect(MoniteurSurcharge::getInstance(), &MoniteurSurcharge::surchargeDetectee,
+            this, &MainWindow::signalerSurcharge);
+    connect(MoniteurSLA::getInstance(), &MoniteurSLA::commandeEnRetard,
+            this, &MainWindow::signalerRetard);
+    
+    // Versions de référence, puis relecture périodique des compteurs
+    DetecteurChangements* detecteur = DetecteurChangements::getInstance();
+    connect(detecteur, &DetecteurChangements::tableModifiee, this, &MainWindow::donneesModifiees);
+    connect(detecteur, &DetecteurChangements::verificationTerminee, this, &MainWindow::verificationTerminee);
+    connect(tabWidget, &QTabWidget::currentChanged, this, &MainWindow::ongletChange);
 }
 
 void MainWindow::afficherAPropos()
@@ -159,22 +246,242 @@ void MainWindow::quitterApplication()
 
 void MainWindow::actualiserDonnees()
 {
-    statusLabel->setText("Actualisation en cours...");
+    if (!donneesPretes) {
+        statusLabel->setText("Chargement des données en cours...");
+        return;
+    }
+    
+    statusLabel->setText("Vérification des modifications...");
+    actualisationDemandee = true;
+    DetecteurChangements::getInstance()->verifier();
+}
+
+void MainWindow::verificationTerminee(bool modifiee)
+{
+    if (!actualisationDemandee) {
+        return;
+    }
+    actualisationDemandee = false;
+    
+    // Seuls les onglets dont la source a changé sont rechargés
+    if (!modifiee && ongletsPerimes.isEmpty()) {
+        statusLabel->setText("Données déjà à jour");
+        return;
+    }
+    
+    actualiserOnglet(tabWidget->currentWidget());
+    statusLabel->setText("Données actualisées");
+}
+
+void MainWindow::donneesModifiees(const QString& table)
+{
+    // L'index suit les commandes par le journal, les livreurs par écarts
+    // UPDATED_AT / SUPPRESSIONS ; rechargement seulement s'ils manquent
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (table == "COMMANDES") {
+        index->synchroniser();
+        ongletsPerimes << commandeWidget << livreurWidget << statistiquesWidget;
+    } else if (table == "LIVREURS") {
+        if (!index->synchroniserLivreurs()) {
+            index->invalider();
+        }
+        ongletsPerimes << livreurWidget << statistiquesWidget;
+    }
+    // Modules pas encore construits : à jour dès leur construction
+    ongletsPerimes.remove(nullptr);
     
-    // Actualiser tous les widgets
+    // Onglet visible actualisé tout de suite, les autres à leur affichage
+    actualiserOnglet(tabWidget->currentWidget());
+}
+
+void MainWindow::ongletChange(int index)
+{
+    construireOnglet(index);
+    actualiserOnglet(tabWidget->widget(index));
+}
+
+void MainWindow::demarrerChargement()
+{
+    statusLabel->setText("Chargement des données...");
+    
+    // Instantané remis au fil de l'application dès qu'il est indexé, sans
+    // attendre la fin de la tâche
+    auto promesseInstantane = std::make_shared<QPromise<InstantaneIndexe>>();
+    promesseInstantane->start();
+    lectureInstantane = new QFutureWatcher<InstantaneIndexe>(this);
+    connect(lectureInstantane, &QFutureWatcher<InstantaneIndexe>::finished,
+            this, &MainWindow::instantaneLu);
+    lectureInstantane->setFuture(promesseInstantane->future());
+    
+    // Sur un fil du pool, pendant que la fenêtre s'affiche : instantané local
+    // d'une session précédente décodé et indexé, puis, avec la connexion
+    // propre au fil, schéma vérifié (migré s'il est en retard) et écarts
+    // depuis l'instantané, ou lecture complète des tables sans instantané
+    chargementInitial = new QFutureWatcher<ChargementDonnees>(this);
+    connect(chargementInitial, &QFutureWatcher<ChargementDonnees>::finished,
+            this, &MainWindow::chargementTermine);
+    chargementInitial->setFuture(QtConcurrent::run([promesseInstantane] {
+        InstantaneIndexe lu;
+        lu.sources = InstantaneDonnees::lire();
+        if (lu.sources.valide) {
+            lu.contenu = IndexFiltres::indexer(lu.sources);
+        }
+        const SourcesIndex instantane = lu.sources;
+        promesseInstantane->addResult(std::move(lu));
+        promesseInstantane->finish();
+        
+        return InstantaneDonnees::actualiser(instantane);
+    }));
+}
+
+void MainWindow::instantaneLu()
+{
+    InstantaneIndexe lu = lectureInstantane->future().takeResult();
+    lectureInstantane->deleteLater();
+    lectureInstantane = nullptr;
+    
+    // Index rempli depuis l'instantané : les modules se construisent sans
+    // connexion, les écarts suivront. Déjà chargé : la lecture de la base
+    // a fini la première, l'instantané est dépassé
+    IndexFiltres* index = IndexFiltres::getInstance();
+    if (lu.sources.valide && !index->estCharge()) {
+        index->charger(std::move(lu.contenu), lu.sources.positionJournal, lu.sources.filigrane);
+        statusLabel->setText(QString("Données locales du %1, synchronisation...")
+                             .arg(lu.sources.filigrane.toString("dd/MM/yyyy HH:mm")));
+        donneesPretes = true;
+        construireOnglet(tabWidget->currentIndex());
+    }
+    
+    // La poignée de main bloque le fil de l'application : ouverte une fois
+    // les onglets de l'instantané affichés
+    QTimer::singleShot(0, this, &MainWindow::ouvrirConnexion);
+}
+
+void MainWindow::chargementTermine()
+{
+    const ChargementDonnees resultat = chargementInitial->result();
+    chargementInitial->deleteLater();
+    chargementInitial = nullptr;
+    
+    // Fin possible avant l'ouverture différée de la connexion principale
+    // (sans effet si elle a déjà été tentée)
+    ouvrirConnexion();
+    donneesPretes = true;
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    
+    // Sans base, les modules se construisent vides, ou sur l'instantané local
+    if (!resultat.sources.valide || !DatabaseManager::getInstance()->isConnected()) {
+        statusLabel->setText(index->estCharge()
+                             ? "Base de données inaccessible, données locales affichées"
+                             : "Base de données inaccessible");
+        construireOnglet(tabWidget->currentIndex());
+        return;
+    }
+    
+    if (resultat.depuisInstantane && index->estCharge()) {
+        // Seules les lignes modifiées depuis l'instantané
+        index->reconcilier(resultat.commandes, resultat.livreurs,
+                           resultat.sources.positionJournal, resultat.sources.filigrane);
+    } else {
+        // Lecture complète : sans instantané, ou instantané affiché puis
+        // écarté (trop ancien pour ses écarts)
+        index->charger(resultat.sources);
+    }
+    // Écritures concurrentes de la lecture (journal ORDER_EVENTS)
+    index->synchroniser();
+    
+    // Modules déjà construits sur l'instantané : relus depuis l'index à jour
     if (commandeWidget) {
         commandeWidget->actualiserListe();
     }
-    
     if (livreurWidget) {
         livreurWidget->actualiserListe();
     }
-    
     if (statistiquesWidget) {
         statistiquesWidget->actualiserStatistiques();
     }
     
-    statusLabel->setText("Données actualisées");
+    // Versions de référence, puis relecture périodique des compteurs
+    DetecteurChangements* detecteur = DetecteurChangements::getInstance();
+    detecteur->verifier();
+    detecteur->demarrer();
+    
+    statusLabel->setText("Prêt");
+    construireOnglet(tabWidget->currentIndex());
+}
+
+void MainWindow::construireOnglet(int index)
+{
+    QWidget* page = tabWidget->widget(index);
+    if (!donneesPretes || page == nullptr) {
+        return;
+    }
+    
+    QWidget* onglet = nullptr;
+    if (page == squeletteCommandes) {
+        commandeWidget = new CommandeWidget(this);
+        onglet = commandeWidget;
+        squeletteCommandes = nullptr;
+    } else if (page == squeletteLivreurs) {
+        livreurWidget = new LivreurWidget(this);
+        onglet = livreurWidget;
+        squeletteLivreurs = nullptr;
+    } else if (page == squeletteStatistiques) {
+        statistiquesWidget = new StatistiquesWidget(this);
+        onglet = statistiquesWidget;
+        squeletteStatistiques = nullptr;
+    } else {
+        return;
+    }
+    
+    // Remplacement à la même position (onglets déplaçables), sans
+    // réémettre currentChanged
+    const QSignalBlocker blocage(tabWidget);
+    const QString titre = tabWidget->tabText(index);
+    tabWidget->removeTab(index);
+    tabWidget->insertTab(index, onglet, titre);
+    tabWidget->setCurrentIndex(index);
+    page->deleteLater();
+}
+
+void MainWindow::actualiserOnglet(QWidget* onglet)
+{
+    if (!ongletsPerimes.remove(onglet)) {
+        return;
+    }
+    
+    // Listes : fusion des seules lignes modifiées (UPDATED_AT)
+    if (onglet == commandeWidget) {
+        commandeWidget->synchroniser();
+    } else if (onglet == livreurWidget) {
+        livreurWidget->synchroniser();
+    } else if (onglet == statistiquesWidget) {
+        statistiquesWidget->actualiserStatistiques();
+    }
+}
+
+void MainWindow::basculerTrace(bool active)
+{
+    if (active) {
+        Trace::demarrer();
+        statusLabel->setText("Trace d'exécution en cours d'enregistrement");
+        return;
+    }
+    
+    QString fileName = QFileDialog::getSaveFileName(this,
+        "Enregistrer la trace d'exécution",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/trace_logistique.json",
+        "Traces Chrome (*.json)");
+    
+    // Annulation : la trace est abandonnée
+    if (!Trace::arreter(fileName)) {
+        QMessageBox::warning(this, "Trace", "Impossible d'écrire la trace dans " + fileName);
+    } else if (!fileName.isEmpty()) {
+        statusLabel->setText("Trace enregistrée : " + fileName);
+    } else {
+        statusLabel->setText("Trace abandonnée");
+    }
 }
 
 void MainWindow::exporterDonnees()
@@ -231,12 +538,16 @@ void MainWindow::mettreAJourContraintes()
         if (db->isConnected()) {
             statusLabel->setText("Mise à jour des contraintes en cours...");
             
-            db->forceUpdateConstraints();
-            
-            statusLabel->setText("Contraintes mises à jour avec succès");
-            QMessageBox::information(this, "Succès", 
-                "Les contraintes de la base de données ont été mises à jour.\n"
-                "La suppression en cascade est maintenant active.");
+            if (db->forceUpdateConstraints()) {
+                statusLabel->setText("Contraintes mises à jour avec succès");
+                QMessageBox::information(this, "Succès", 
+                    "Les contraintes de la base de données ont été mises à jour.\n"
+                    "La suppression en cascade est maintenant active.");
+            } else {
+                statusLabel->setText("Erreur lors de la mise à jour des contraintes");
+                QMessageBox::warning(this, "Erreur", 
+                    "La mise à jour des contraintes a échoué (détails dans le journal).");
+            }
         } else {
             QMessageBox::warning(this, "Erreur", 
                 "Impossible de mettre à jour les contraintes: base de données non connectée.");
@@ -244,3 +555,19 @@ void MainWindow::mettreAJourContraintes()
         }
     }
 }
+
+void MainWindow::signalerSurcharge(int idLivreur, int charge, int capacite)
+{
+    Livreur livreur = IndexFiltres::getInstance()->obtenirLivreur(idLivreur);
+    statusLabel->setText(QString("⚠️ Surcharge: %1 a %2 commandes actives (capacité %3)")
+                         .arg(livreur.getNom())
+                         .arg(charge)
+                         .arg(capacite));
+}
+
+void MainWindow::signalerRetard(int idCommande)
+{
+    statusLabel->setText(QString("⏰ Commande #%1 hors délai — %2 commande(s) en retard")
+                         .arg(idCommande)
+                         .arg(MoniteurSLA::getInstance()->nombreEnRetard()));
+}
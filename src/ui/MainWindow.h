@@ -9,10 +9,16 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QSet>
+#include <QDockWidget>
+#include <QFutureWatcher>
+#include "services/InstantaneDonnees.h"
 
 class CommandeWidget;
 class LivreurWidget;
 class StatistiquesWidget;
+class DiagnosticWidget;
+class SqueletteOnglet;
 
 class MainWindow : public QMainWindow
 {
@@ -28,12 +34,25 @@ private slots:
     void actualiserDonnees();
     void exporterDonnees();
     void mettreAJourContraintes(); // Nouvelle méthode
+    void signalerSurcharge(int idLivreur, int charge, int capacite);
+    void signalerRetard(int idCommande);
+    void donneesModifiees(const QString& table);
+    void verificationTerminee(bool modifiee);
+    void ongletChange(int index);
+    void basculerTrace(bool active);
+    void instantaneLu();
+    void chargementTermine();
+    void ouvrirConnexion();
     
 private:
     void setupUI();
     void setupMenus();
     void setupStatusBar();
+    void setupDiagnostic();
     void connecterSignaux();
+    void actualiserOnglet(QWidget* onglet);
+    void demarrerChargement();
+    void construireOnglet(int index);
     
     // Widgets principaux
     QTabWidget* tabWidget;
@@ -41,17 +60,37 @@ private:
     LivreurWidget* livreurWidget;
     StatistiquesWidget* statistiquesWidget;
     
+    // Onglets construits à leur première activation, données chargées :
+    // squelettes en attendant (nuls une fois remplacés)
+    SqueletteOnglet* squeletteCommandes;
+    SqueletteOnglet* squeletteLivreurs;
+    SqueletteOnglet* squeletteStatistiques;
+    QFutureWatcher<InstantaneIndexe>* lectureInstantane;
+    QFutureWatcher<ChargementDonnees>* chargementInitial;
+    bool donneesPretes;
+    bool connexionTentee;
+    
+    // Panneau de diagnostic (masqué par défaut)
+    QDockWidget* dockDiagnostic;
+    DiagnosticWidget* diagnosticWidget;
+    
     // Menus et actions
     QMenuBar* mainMenuBar;
     QStatusBar* mainStatusBar;
     QLabel* statusLabel;
     QLabel* connectionLabel;
     
+    // Onglets dont la source a changé depuis leur dernier affichage
+    QSet<QWidget*> ongletsPerimes;
+    // Actualisation (F5) en attente du résultat du détecteur
+    bool actualisationDemandee;
+    
     QAction* actionQuitter;
     QAction* actionAPropos;
     QAction* actionActualiser;
     QAction* actionExporter;
     QAction* actionMettreAJourContraintes; // Nouvelle action
+    QAction* actionTrace;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,42 @@
+#include "SqueletteOnglet.h"
+#include <QPainter>
+
+SqueletteOnglet::SqueletteOnglet(const QString& message, QWidget *parent)
+    : QWidget(parent)
+    , message(message)
+{
+}
+
+void SqueletteOnglet::definirMessage(const QString& texte)
+{
+    message = texte;
+    update();
+}
+
+void SqueletteOnglet::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+    
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), QColor("#f8f9fa"));
+    
+    // Message d'état au-dessus du tableau
+    painter.setPen(QColor("#6c757d"));
+    const QRect zoneMessage(MARGE, MARGE, width() - 2 * MARGE, HAUTEUR_LIGNE);
+    painter.drawText(zoneMessage, Qt::AlignLeft | Qt::AlignVCenter, message);
+    
+    // En-tête puis lignes de largeurs variées, comme un tableau en attente
+    const int largeur = width() - 2 * MARGE;
+    int y = MARGE + 2 * HAUTEUR_LIGNE;
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor("#dee2e6"));
+    painter.drawRoundedRect(MARGE, y, largeur, HAUTEUR_LIGNE - 8, 4, 4);
+    
+    painter.setBrush(QColor("#e9ecef"));
+    for (int i = 0; i < LIGNES && y + HAUTEUR_LIGNE < height() - MARGE; ++i) {
+        y += HAUTEUR_LIGNE;
+        const int longueur = largeur * (60 + (i * 37) % 40) / 100;
+        painter.drawRoundedRect(MARGE, y + 6, longueur, HAUTEUR_LIGNE - 14, 4, 4);
+    }
+}
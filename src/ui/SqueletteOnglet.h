@@ -0,0 +1,28 @@
+#ifndef SQUELETTEONGLET_H
+#define SQUELETTEONGLET_H
+
+#include <QWidget>
+#include <QString>
+
+// Page provisoire d'un onglet dont le widget n'est pas encore construit :
+// silhouette grisée d'un tableau sous un message d'état. Aucun accès aux
+// données, rien à charger.
+class SqueletteOnglet : public QWidget
+{
+public:
+    explicit SqueletteOnglet(const QString& message, QWidget *parent = nullptr);
+
+    void definirMessage(const QString& texte);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    QString message;
+
+    static constexpr int LIGNES = 12;
+    static constexpr int HAUTEUR_LIGNE = 28;
+    static constexpr int MARGE = 24;
+};
+
+#endif // SQUELETTEONGLET_H
@@ -1,4 +1,5 @@
 #include "StatistiquesWidget.h"
+#include "utils/Trace.h"
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QFileDialog>
@@ -15,10 +16,6 @@ StatistiquesWidget::StatistiquesWidget(QWidget *parent)
     , livreursDisponibles(0)
     , livreursOccupes(0)
 {
-    // Initialiser les services
-    commandeService = new CommandeService();
-    livreurService = new LivreurService();
-    
     setupUI();
     connecterSignaux();
     appliquerStyle();
@@ -54,6 +51,10 @@ void StatistiquesWidget::setupUI()
     setupGraphiques();
     contentLayout->addWidget(groupGraphiques);
     
+    // Délais réels de livraison
+    setupPanneauDelais();
+    contentLayout->addWidget(groupDelais);
+    
     // Boutons d'action
     QHBoxLayout* btnLayout = new QHBoxLayout();
     btnActualiser = new QPushButton("🔄 Actualiser les données");
@@ -128,6 +129,17 @@ void StatistiquesWidget::setupGraphiques()
     graphiquesLayout->addWidget(chartDisponibiliteLivreurs, 1, 0, 1, 2);
 }
 
+void StatistiquesWidget::setupPanneauDelais()
+{
+    groupDelais = new QGroupBox("⏱️ Délais de livraison");
+    QVBoxLayout* delaisLayout = new QVBoxLayout(groupDelais);
+    
+    labelDelais = new QLabel();
+    labelDelais->setTextFormat(Qt::RichText);
+    labelDelais->setWordWrap(true);
+    delaisLayout->addWidget(labelDelais);
+}
+
 void StatistiquesWidget::connecterSignaux()
 {
     connect(btnActualiser, &QPushButton::clicked, this, &StatistiquesWidget::actualiserStatistiques);
@@ -188,11 +200,14 @@ void StatistiquesWidget::appliquerStyle()
     
     groupResume->setStyleSheet(groupStyle);
     groupGraphiques->setStyleSheet(groupStyle);
+    groupDelais->setStyleSheet(groupStyle);
 }
 
 void StatistiquesWidget::actualiserStatistiques()
 {
-    // Charger les données réelles depuis la base de données
+    PorteeTrace portee("StatistiquesWidget::actualiserStatistiques", "ui");
+    
+    // Comptages lus sur l'index en mémoire, sans relire les tables
     chargerStatistiquesCommandes();
     chargerStatistiquesLivreurs();
     
@@ -201,68 +216,44 @@ void StatistiquesWidget::actualiserStatistiques()
     creerGraphiqueStatutsCommandes();
     creerGraphiqueZonesLivraison();
     creerGraphiqueDisponibiliteLivreurs();
+    mettreAJourDelais();
 }
 
 void StatistiquesWidget::chargerStatistiquesCommandes()
 {
-    // Obtenir toutes les commandes réelles
-    QList<Commande> commandes = commandeService->obtenirToutesCommandes();
-    
-    // Réinitialiser les compteurs
-    totalCommandes = commandes.size();
-    commandesEnAttente = 0;
-    commandesEnCours = 0;
-    commandesLivrees = 0;
-    commandesAnnulees = 0;
-    commandesParZone.clear();
-    
-    // Analyser chaque commande
-    for (const Commande& cmd : commandes) {
-        // Compter par statut
-        if (cmd.getStatut() == "En attente") {
-            commandesEnAttente++;
-        } else if (cmd.getStatut() == "En cours") {
-            commandesEnCours++;
-        } else if (cmd.getStatut() == "Livree") {
-            commandesLivrees++;
-        } else if (cmd.getStatut() == "Annulee") {
-            commandesAnnulees++;
-        }
-        
-        // Compter par zone/ville
-        QString ville = cmd.getVilleLivraison();
-        commandesParZone[ville]++;
-    }
+    PorteeTrace portee("StatistiquesWidget::chargerStatistiquesCommandes", "ui");
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    index->assurerChargement();
+    
+    // Cardinalités des bitmaps par statut et par ville
+    const QMap<QString, int> parStatut = index->compterCommandesParStatut();
+    totalCommandes = index->nombreCommandes();
+    commandesEnAttente = parStatut.value("En attente");
+    commandesEnCours = parStatut.value("En cours");
+    commandesLivrees = parStatut.value("Livree");
+    commandesAnnulees = parStatut.value("Annulee");
+    commandesParZone = index->compterCommandesParVille();
 }
 
 void StatistiquesWidget::chargerStatistiquesLivreurs()
 {
-    // Obtenir tous les livreurs réels
-    QList<Livreur> livreurs = livreurService->obtenirTousLivreurs();
-    
-    // Réinitialiser les compteurs
-    totalLivreurs = livreurs.size();
-    livreursDisponibles = 0;
-    livreursOccupes = 0;
-    livreursParZone.clear();
-    
-    // Analyser chaque livreur
-    for (const Livreur& livreur : livreurs) {
-        // Compter par disponibilité
-        if (livreur.getDisponibilite()) {
-            livreursDisponibles++;
-        } else {
-            livreursOccupes++;
-        }
-        
-        // Compter par zone
-        QString zone = livreur.getZoneLivraison();
-        livreursParZone[zone]++;
-    }
+    PorteeTrace portee("StatistiquesWidget::chargerStatistiquesLivreurs", "ui");
+    
+    IndexFiltres* index = IndexFiltres::getInstance();
+    index->assurerChargement();
+    
+    // Disponibilité et zones lues sur les bitmaps des livreurs
+    totalLivreurs = index->nombreLivreurs();
+    livreursDisponibles = index->nombreLivreursDisponibles();
+    livreursOccupes = totalLivreurs - livreursDisponibles;
+    livreursParZone = index->compterLivreursParZone();
 }
 
 void StatistiquesWidget::mettreAJourCartes()
 {
+    PorteeTrace portee("StatistiquesWidget::mettreAJourCartes", "rendu");
+    
     // Style pour les cartes
     QString carteStyle = R"(
         QLabel {
@@ -293,8 +284,51 @@ void StatistiquesWidget::mettreAJourCartes()
     carteEnCours->setStyleSheet(carteStyle.arg("#f39c12", "#d68910"));
 }
 
+void StatistiquesWidget::mettreAJourDelais()
+{
+    PorteeTrace portee("StatistiquesWidget::mettreAJourDelais", "rendu");
+    
+    // Les distributions sont alimentées par l'index en mémoire
+    IndexFiltres::getInstance()->assurerChargement();
+    StatistiquesLivraison* statistiques = StatistiquesLivraison::getInstance();
+    MesuresDelai global = statistiques->global();
+    
+    if (global.nombre == 0) {
+        labelDelais->setText("Aucune livraison horodatée pour le moment.");
+        return;
+    }
+    
+    // Délais en jours, de la date de commande à la livraison
+    QString ligne = "<tr><td>%1</td><td align='right'>%2</td><td align='right'>%3</td>"
+                    "<td align='right'>%4</td><td align='right'>%5</td><td align='right'>%6</td></tr>";
+    auto formater = [&ligne](const QString& libelle, const MesuresDelai& m) {
+        return ligne.arg(libelle)
+                    .arg(m.nombre)
+                    .arg(m.moyenne, 0, 'f', 1)
+                    .arg(m.p50, 0, 'f', 1)
+                    .arg(m.p90, 0, 'f', 1)
+                    .arg(m.p99, 0, 'f', 1);
+    };
+    
+    QString html = "<table cellspacing='0' cellpadding='4' width='100%'>"
+                   "<tr><th align='left'>Ville</th><th align='right'>Livraisons</th>"
+                   "<th align='right'>Moyenne (j)</th><th align='right'>p50</th>"
+                   "<th align='right'>p90</th><th align='right'>p99</th></tr>";
+    html += formater("<b>Toutes</b>", global);
+    
+    QMap<QString, MesuresDelai> villes = statistiques->toutesVilles();
+    for (auto it = villes.constBegin(); it != villes.constEnd(); ++it) {
+        html += formater(it.key(), it.value());
+    }
+    html += "</table>";
+    
+    labelDelais->setText(html);
+}
+
 void StatistiquesWidget::creerGraphiqueStatutsCommandes()
 {
+    PorteeTrace portee("StatistiquesWidget::creerGraphiqueStatutsCommandes", "rendu");
+    
     QPieSeries* series = new QPieSeries();
     
     if (commandesEnAttente > 0) {
@@ -336,6 +370,8 @@ void StatistiquesWidget::creerGraphiqueStatutsCommandes()
 
 void StatistiquesWidget::creerGraphiqueZonesLivraison()
 {
+    PorteeTrace portee("StatistiquesWidget::creerGraphiqueZonesLivraison", "rendu");
+    
     QBarSeries* series = new QBarSeries();
     QBarSet* set = new QBarSet("Commandes");
     
@@ -387,6 +423,8 @@ void StatistiquesWidget::creerGraphiqueZonesLivraison()
 
 void StatistiquesWidget::creerGraphiqueDisponibiliteLivreurs()
 {
+    PorteeTrace portee("StatistiquesWidget::creerGraphiqueDisponibiliteLivreurs", "rendu");
+    
     QPieSeries* series = new QPieSeries();
     
     if (livreursDisponibles > 0) {
@@ -423,6 +461,8 @@ void StatistiquesWidget::creerGraphiqueDisponibiliteLivreurs()
 
 void StatistiquesWidget::genererRapport()
 {
+    PorteeTrace portee("StatistiquesWidget::genererRapport", "rapport");
+    
     QString fileName = QFileDialog::getSaveFileName(this, "Enregistrer le rapport statistiques",
         QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/rapport_statistiques.pdf",
         "Fichiers PDF (*.pdf)");
@@ -19,8 +19,8 @@
 #include <QtCharts/QBarCategoryAxis>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QChart>
-#include "services/CommandeService.h"
-#include "services/LivreurService.h"
+#include "services/IndexFiltres.h"
+#include "services/StatistiquesLivraison.h"
 
 class StatistiquesWidget : public QWidget
 {
@@ -39,6 +39,7 @@ private:
     void setupUI();
     void setupPanneauResume();
     void setupGraphiques();
+    void setupPanneauDelais();
     void connecterSignaux();
     void appliquerStyle();
     void chargerStatistiquesCommandes();
@@ -47,6 +48,7 @@ private:
     void creerGraphiqueZonesLivraison();
     void creerGraphiqueDisponibiliteLivreurs();
     void mettreAJourCartes();
+    void mettreAJourDelais();
     
     // Interface principale
     QVBoxLayout* mainLayout;
@@ -68,15 +70,15 @@ private:
     QChartView* chartZonesLivraison;
     QChartView* chartDisponibiliteLivreurs;
     
+    // Délais de livraison (percentiles)
+    QGroupBox* groupDelais;
+    QLabel* labelDelais;
+    
     // Boutons et contrôles
     QPushButton* btnActualiser;
     QPushButton* btnGenererRapport;
     QPushButton* btnExporterExcel;
     
-    // Services
-    CommandeService* commandeService;
-    LivreurService* livreurService;
-    
     // Données statistiques
     int totalCommandes;
     int commandesEnAttente;
@@ -0,0 +1,163 @@
+#include "AffectationCoutMin.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+int AffectationCoutMin::ajouterGroupe(int nombreElements)
+{
+    offres.push_back(std::max(0, nombreElements));
+    arcs.emplace_back();
+    return static_cast<int>(offres.size()) - 1;
+}
+
+int AffectationCoutMin::ajouterRessource(int chargeInitiale)
+{
+    charges.push_back(std::max(0, chargeInitiale));
+    return static_cast<int>(charges.size()) - 1;
+}
+
+void AffectationCoutMin::ajouterArc(int groupe, int ressource, int64_t coutArc)
+{
+    arcs[groupe].push_back({ressource, std::max<int64_t>(0, coutArc)});
+}
+
+std::vector<std::vector<AffectationCoutMin::Quantite>> AffectationCoutMin::resoudre()
+{
+    const int G = static_cast<int>(offres.size());
+    const int M = static_cast<int>(charges.size());
+
+    // Numérotation des noeuds : source, groupes, ressources, puits
+    const int S = 0;
+    const int T = G + M + 1;
+    const int N = G + M + 2;
+    auto noeudGroupe = [](int g) { return 1 + g; };
+    auto noeudRessource = [G](int r) { return 1 + G + r; };
+
+    const int64_t INFINI = std::numeric_limits<int64_t>::max() / 4;
+
+    // Arcs inverses : pour chaque ressource, (groupe, indice de l'arc)
+    std::vector<std::vector<std::pair<int, int>>> arcsEntrants(M);
+    for (int g = 0; g < G; ++g) {
+        for (int a = 0; a < static_cast<int>(arcs[g].size()); ++a) {
+            arcsEntrants[arcs[g][a].ressource].push_back({g, a});
+        }
+    }
+
+    std::vector<int> restant(offres);
+    std::vector<std::vector<int>> flot(G);
+    for (int g = 0; g < G; ++g) {
+        flot[g].assign(arcs[g].size(), 0);
+    }
+    std::vector<int> ajoutes(M, 0); // éléments affectés par ressource
+
+    int aAffecter = 0;
+    for (int r : restant) {
+        aAffecter += r;
+    }
+
+    // Potentiels : tous les coûts initiaux sont positifs, on part de zéro
+    std::vector<int64_t> potentiel(N, 0);
+    std::vector<int64_t> distance(N);
+    std::vector<int> parent(N);
+    std::vector<int> parentArc(N);
+
+    using Entree = std::pair<int64_t, int>;
+
+    while (aAffecter > 0) {
+        std::fill(distance.begin(), distance.end(), INFINI);
+        std::fill(parent.begin(), parent.end(), -1);
+
+        std::priority_queue<Entree, std::vector<Entree>, std::greater<Entree>> file;
+        distance[S] = 0;
+        file.push({0, S});
+
+        auto relacher = [&](int u, int v, int64_t coutReel, int arc) {
+            const int64_t d = distance[u] + coutReel + potentiel[u] - potentiel[v];
+            if (d < distance[v]) {
+                distance[v] = d;
+                parent[v] = u;
+                parentArc[v] = arc;
+                file.push({d, v});
+            }
+        };
+
+        while (!file.empty()) {
+            const Entree courant = file.top();
+            file.pop();
+            const int u = courant.second;
+            if (courant.first > distance[u]) continue;
+            if (u == T) break;
+
+            if (u == S) {
+                for (int g = 0; g < G; ++g) {
+                    if (restant[g] > 0) relacher(S, noeudGroupe(g), 0, -1);
+                }
+            } else if (u <= G) {
+                const int g = u - 1;
+                for (int a = 0; a < static_cast<int>(arcs[g].size()); ++a) {
+                    relacher(u, noeudRessource(arcs[g][a].ressource), arcs[g][a].cout, a);
+                }
+            } else {
+                const int r = u - 1 - G;
+                // Coût marginal de l'élément suivant sur cette ressource
+                relacher(u, T, charges[r] + ajoutes[r], -1);
+                // Arcs inverses : retirer un élément déjà affecté
+                for (const auto& entrant : arcsEntrants[r]) {
+                    const int g = entrant.first;
+                    const int a = entrant.second;
+                    if (flot[g][a] > 0) {
+                        relacher(u, noeudGroupe(g), -arcs[g][a].cout, a);
+                    }
+                }
+            }
+        }
+
+        if (distance[T] >= INFINI) {
+            break; // plus aucun chemin : éléments sans ressource compatible
+        }
+
+        // Mise à jour des potentiels (bornée par la distance du puits)
+        for (int v = 0; v < N; ++v) {
+            potentiel[v] += std::min(distance[v], distance[T]);
+        }
+
+        // Augmentation d'une unité le long du chemin trouvé
+        int v = T;
+        while (v != S) {
+            const int u = parent[v];
+            if (v == T) {
+                ajoutes[u - 1 - G]++;
+            } else if (u == S) {
+                restant[v - 1]--;
+            } else if (u <= G) {
+                flot[u - 1][parentArc[v]]++;          // groupe -> ressource
+            } else {
+                flot[v - 1][parentArc[v]]--;          // ressource -> groupe (inverse)
+            }
+            v = u;
+        }
+        --aAffecter;
+    }
+
+    // Résultat et coût total
+    std::vector<std::vector<Quantite>> resultat(G);
+    cout = 0;
+    affectes = 0;
+    for (int g = 0; g < G; ++g) {
+        for (int a = 0; a < static_cast<int>(arcs[g].size()); ++a) {
+            if (flot[g][a] > 0) {
+                resultat[g].push_back({arcs[g][a].ressource, flot[g][a]});
+                cout += arcs[g][a].cout * flot[g][a];
+                affectes += flot[g][a];
+            }
+        }
+    }
+    for (int r = 0; r < M; ++r) {
+        const int64_t k = ajoutes[r];
+        cout += k * charges[r] + k * (k - 1) / 2;
+    }
+
+    return resultat;
+}
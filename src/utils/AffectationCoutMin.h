@@ -0,0 +1,47 @@
+#ifndef AFFECTATIONCOUTMIN_H
+#define AFFECTATIONCOUTMIN_H
+
+#include <cstdint>
+#include <vector>
+
+// Affectation à coût minimal de groupes d'éléments identiques vers des
+// ressources dont le coût marginal croît avec la charge (coût du k-ième
+// élément = chargeInitiale + k). Résolu par la méthode hongroise sous forme
+// de plus courts chemins successifs avec potentiels (Dijkstra) : le résultat
+// est optimal. Le graphe ne compte que groupes + ressources noeuds, mais
+// chaque élément coûte un Dijkstra (l'arc vers le puits change de coût à
+// chaque unité) : O(n · E log V) pour n éléments et E arcs groupe-ressource.
+class AffectationCoutMin
+{
+public:
+    struct Arc {
+        int ressource;
+        int64_t cout; // coût fixe de l'arc (ex: pénalité hors zone)
+    };
+
+    // Ajout du problème
+    int ajouterGroupe(int nombreElements);
+    int ajouterRessource(int chargeInitiale);
+    void ajouterArc(int groupe, int ressource, int64_t cout);
+
+    // Résolution : renvoie, pour chaque groupe, le nombre d'éléments
+    // affectés à chaque ressource (paires ressource/quantité)
+    struct Quantite {
+        int ressource;
+        int nombre;
+    };
+    std::vector<std::vector<Quantite>> resoudre();
+
+    int64_t coutTotal() const { return cout; }
+    int elementsAffectes() const { return affectes; }
+
+private:
+    std::vector<int> offres;
+    std::vector<int> charges;
+    std::vector<std::vector<Arc>> arcs;
+
+    int64_t cout = 0;
+    int affectes = 0;
+};
+
+#endif // AFFECTATIONCOUTMIN_H
@@ -0,0 +1,348 @@
+#include "BitmapCompresse.h"
+#include <algorithm>
+#include <iterator>
+
+BitmapCompresse::BitmapCompresse()
+{
+}
+
+// Méthodes du conteneur
+
+bool BitmapCompresse::Conteneur::contient(uint16_t bas) const
+{
+    if (estBitset()) {
+        return (bits[bas >> 6] >> (bas & 63)) & 1ULL;
+    }
+    return std::binary_search(tableau.begin(), tableau.end(), bas);
+}
+
+void BitmapCompresse::Conteneur::versBitset()
+{
+    bits.assign(MOTS_BITSET, 0);
+    for (uint16_t bas : tableau) {
+        bits[bas >> 6] |= 1ULL << (bas & 63);
+    }
+    tableau.clear();
+    tableau.shrink_to_fit();
+}
+
+void BitmapCompresse::Conteneur::versTableau()
+{
+    tableau.clear();
+    tableau.reserve(cardinalite);
+    for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+        uint64_t w = bits[mot];
+        while (w != 0) {
+            tableau.push_back(static_cast<uint16_t>(mot * 64 + premierBit(w)));
+            w &= w - 1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+void BitmapCompresse::Conteneur::normaliser()
+{
+    // Choisir la représentation la plus compacte selon la cardinalité
+    if (estBitset() && cardinalite <= SEUIL_TABLEAU) {
+        versTableau();
+    } else if (!estBitset() && cardinalite > SEUIL_TABLEAU) {
+        versBitset();
+    }
+}
+
+// Recherche d'un conteneur par clé (recherche dichotomique)
+
+std::vector<BitmapCompresse::Conteneur>::iterator BitmapCompresse::chercher(uint16_t cle)
+{
+    return std::lower_bound(conteneurs.begin(), conteneurs.end(), cle,
+                            [](const Conteneur& c, uint16_t k) { return c.cle < k; });
+}
+
+std::vector<BitmapCompresse::Conteneur>::const_iterator BitmapCompresse::chercher(uint16_t cle) const
+{
+    return std::lower_bound(conteneurs.begin(), conteneurs.end(), cle,
+                            [](const Conteneur& c, uint16_t k) { return c.cle < k; });
+}
+
+void BitmapCompresse::ajouter(uint32_t valeur)
+{
+    const uint16_t cle = static_cast<uint16_t>(valeur >> 16);
+    const uint16_t bas = static_cast<uint16_t>(valeur & 0xFFFF);
+
+    auto it = chercher(cle);
+    if (it == conteneurs.end() || it->cle != cle) {
+        Conteneur nouveau;
+        nouveau.cle = cle;
+        it = conteneurs.insert(it, nouveau);
+    }
+
+    if (it->estBitset()) {
+        uint64_t& mot = it->bits[bas >> 6];
+        const uint64_t masque = 1ULL << (bas & 63);
+        if ((mot & masque) == 0) {
+            mot |= masque;
+            it->cardinalite++;
+        }
+        return;
+    }
+
+    auto pos = std::lower_bound(it->tableau.begin(), it->tableau.end(), bas);
+    if (pos != it->tableau.end() && *pos == bas) {
+        return; // déjà présent
+    }
+    it->tableau.insert(pos, bas);
+    it->cardinalite++;
+    it->normaliser();
+}
+
+void BitmapCompresse::retirer(uint32_t valeur)
+{
+    const uint16_t cle = static_cast<uint16_t>(valeur >> 16);
+    const uint16_t bas = static_cast<uint16_t>(valeur & 0xFFFF);
+
+    auto it = chercher(cle);
+    if (it == conteneurs.end() || it->cle != cle) {
+        return;
+    }
+
+    if (it->estBitset()) {
+        uint64_t& mot = it->bits[bas >> 6];
+        const uint64_t masque = 1ULL << (bas & 63);
+        if ((mot & masque) == 0) {
+            return;
+        }
+        mot &= ~masque;
+        it->cardinalite--;
+    } else {
+        auto pos = std::lower_bound(it->tableau.begin(), it->tableau.end(), bas);
+        if (pos == it->tableau.end() || *pos != bas) {
+            return;
+        }
+        it->tableau.erase(pos);
+        it->cardinalite--;
+    }
+
+    if (it->cardinalite == 0) {
+        conteneurs.erase(it);
+    } else {
+        it->normaliser();
+    }
+}
+
+void BitmapCompresse::vider()
+{
+    conteneurs.clear();
+}
+
+bool BitmapCompresse::contient(uint32_t valeur) const
+{
+    const uint16_t cle = static_cast<uint16_t>(valeur >> 16);
+    auto it = chercher(cle);
+    if (it == conteneurs.end() || it->cle != cle) {
+        return false;
+    }
+    return it->contient(static_cast<uint16_t>(valeur & 0xFFFF));
+}
+
+uint64_t BitmapCompresse::cardinalite() const
+{
+    uint64_t total = 0;
+    for (const Conteneur& c : conteneurs) {
+        total += static_cast<uint64_t>(c.cardinalite);
+    }
+    return total;
+}
+
+std::vector<uint32_t> BitmapCompresse::versListe() const
+{
+    std::vector<uint32_t> valeurs;
+    valeurs.reserve(static_cast<size_t>(cardinalite()));
+    parcourir([&valeurs](uint32_t v) { valeurs.push_back(v); });
+    return valeurs;
+}
+
+// Opérations conteneur à conteneur
+
+BitmapCompresse::Conteneur BitmapCompresse::intersection(const Conteneur& a, const Conteneur& b)
+{
+    Conteneur resultat;
+    resultat.cle = a.cle;
+
+    if (a.estBitset() && b.estBitset()) {
+        resultat.bits.assign(MOTS_BITSET, 0);
+        for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+            resultat.bits[mot] = a.bits[mot] & b.bits[mot];
+            resultat.cardinalite += compterBits(resultat.bits[mot]);
+        }
+        resultat.normaliser();
+    } else if (a.estBitset() || b.estBitset()) {
+        // Filtrer le tableau par le bitset
+        const Conteneur& tab = a.estBitset() ? b : a;
+        const Conteneur& bitset = a.estBitset() ? a : b;
+        for (uint16_t bas : tab.tableau) {
+            if (bitset.contient(bas)) {
+                resultat.tableau.push_back(bas);
+            }
+        }
+        resultat.cardinalite = static_cast<int>(resultat.tableau.size());
+    } else {
+        std::set_intersection(a.tableau.begin(), a.tableau.end(),
+                              b.tableau.begin(), b.tableau.end(),
+                              std::back_inserter(resultat.tableau));
+        resultat.cardinalite = static_cast<int>(resultat.tableau.size());
+    }
+
+    return resultat;
+}
+
+BitmapCompresse::Conteneur BitmapCompresse::reunion(const Conteneur& a, const Conteneur& b)
+{
+    Conteneur resultat;
+    resultat.cle = a.cle;
+
+    if (!a.estBitset() && !b.estBitset()) {
+        std::set_union(a.tableau.begin(), a.tableau.end(),
+                       b.tableau.begin(), b.tableau.end(),
+                       std::back_inserter(resultat.tableau));
+        resultat.cardinalite = static_cast<int>(resultat.tableau.size());
+        resultat.normaliser();
+        return resultat;
+    }
+
+    // Au moins un bitset : travailler en représentation dense
+    resultat.bits.assign(MOTS_BITSET, 0);
+    for (const Conteneur* c : {&a, &b}) {
+        if (c->estBitset()) {
+            for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+                resultat.bits[mot] |= c->bits[mot];
+            }
+        } else {
+            for (uint16_t bas : c->tableau) {
+                resultat.bits[bas >> 6] |= 1ULL << (bas & 63);
+            }
+        }
+    }
+    for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+        resultat.cardinalite += compterBits(resultat.bits[mot]);
+    }
+    resultat.normaliser();
+    return resultat;
+}
+
+BitmapCompresse::Conteneur BitmapCompresse::difference(const Conteneur& a, const Conteneur& b)
+{
+    Conteneur resultat;
+    resultat.cle = a.cle;
+
+    if (a.estBitset()) {
+        resultat.bits = a.bits;
+        if (b.estBitset()) {
+            for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+                resultat.bits[mot] &= ~b.bits[mot];
+            }
+        } else {
+            for (uint16_t bas : b.tableau) {
+                resultat.bits[bas >> 6] &= ~(1ULL << (bas & 63));
+            }
+        }
+        for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+            resultat.cardinalite += compterBits(resultat.bits[mot]);
+        }
+        resultat.normaliser();
+    } else {
+        for (uint16_t bas : a.tableau) {
+            if (!b.contient(bas)) {
+                resultat.tableau.push_back(bas);
+            }
+        }
+        resultat.cardinalite = static_cast<int>(resultat.tableau.size());
+    }
+
+    return resultat;
+}
+
+// Opérations ensemblistes (fusion des listes de conteneurs triées)
+
+BitmapCompresse BitmapCompresse::et(const BitmapCompresse& autre) const
+{
+    BitmapCompresse resultat;
+    auto i = conteneurs.begin();
+    auto j = autre.conteneurs.begin();
+
+    while (i != conteneurs.end() && j != autre.conteneurs.end()) {
+        if (i->cle < j->cle) {
+            ++i;
+        } else if (j->cle < i->cle) {
+            ++j;
+        } else {
+            Conteneur c = intersection(*i, *j);
+            if (c.cardinalite > 0) {
+                resultat.conteneurs.push_back(std::move(c));
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    return resultat;
+}
+
+BitmapCompresse BitmapCompresse::ou(const BitmapCompresse& autre) const
+{
+    BitmapCompresse resultat;
+    auto i = conteneurs.begin();
+    auto j = autre.conteneurs.begin();
+
+    while (i != conteneurs.end() || j != autre.conteneurs.end()) {
+        if (j == autre.conteneurs.end() || (i != conteneurs.end() && i->cle < j->cle)) {
+            resultat.conteneurs.push_back(*i++);
+        } else if (i == conteneurs.end() || j->cle < i->cle) {
+            resultat.conteneurs.push_back(*j++);
+        } else {
+            resultat.conteneurs.push_back(reunion(*i, *j));
+            ++i;
+            ++j;
+        }
+    }
+
+    return resultat;
+}
+
+BitmapCompresse BitmapCompresse::etNon(const BitmapCompresse& autre) const
+{
+    BitmapCompresse resultat;
+    auto j = autre.conteneurs.begin();
+
+    for (auto i = conteneurs.begin(); i != conteneurs.end(); ++i) {
+        while (j != autre.conteneurs.end() && j->cle < i->cle) {
+            ++j;
+        }
+        if (j != autre.conteneurs.end() && j->cle == i->cle) {
+            Conteneur c = difference(*i, *j);
+            if (c.cardinalite > 0) {
+                resultat.conteneurs.push_back(std::move(c));
+            }
+        } else {
+            resultat.conteneurs.push_back(*i);
+        }
+    }
+
+    return resultat;
+}
+
+bool BitmapCompresse::operator==(const BitmapCompresse& autre) const
+{
+    if (conteneurs.size() != autre.conteneurs.size()) {
+        return false;
+    }
+    for (size_t k = 0; k < conteneurs.size(); ++k) {
+        const Conteneur& a = conteneurs[k];
+        const Conteneur& b = autre.conteneurs[k];
+        if (a.cle != b.cle || a.cardinalite != b.cardinalite ||
+            a.tableau != b.tableau || a.bits != b.bits) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+#ifndef BITMAPCOMPRESSE_H
+#define BITMAPCOMPRESSE_H
+
+#include <cstdint>
+#include <vector>
+
+// Bitmap compressé de type "Roaring" : les entiers 32 bits sont répartis en
+// conteneurs de 65536 valeurs (clé = 16 bits de poids fort). Un conteneur peu
+// rempli est un tableau trié de 16 bits, un conteneur dense un bitset de 8 Ko.
+class BitmapCompresse
+{
+public:
+    BitmapCompresse();
+
+    // Modification
+    void ajouter(uint32_t valeur);
+    void retirer(uint32_t valeur);
+    void vider();
+
+    // Consultation
+    bool contient(uint32_t valeur) const;
+    uint64_t cardinalite() const;
+    bool estVide() const { return conteneurs.empty(); }
+    std::vector<uint32_t> versListe() const;
+
+    // Parcours des valeurs dans l'ordre croissant
+    template<typename Fonction>
+    void parcourir(Fonction fonction) const;
+
+    // Opérations ensemblistes
+    BitmapCompresse et(const BitmapCompresse& autre) const;
+    BitmapCompresse ou(const BitmapCompresse& autre) const;
+    BitmapCompresse etNon(const BitmapCompresse& autre) const;
+
+    bool operator==(const BitmapCompresse& autre) const;
+
+private:
+    // Au-delà de ce seuil, un tableau occupe plus de place qu'un bitset
+    static constexpr int SEUIL_TABLEAU = 4096;
+    static constexpr int MOTS_BITSET = 1024; // 65536 bits / 64
+
+    struct Conteneur {
+        uint16_t cle = 0;
+        int cardinalite = 0;
+        std::vector<uint16_t> tableau; // utilisé si bits est vide
+        std::vector<uint64_t> bits;    // MOTS_BITSET mots si conteneur dense
+
+        bool estBitset() const { return !bits.empty(); }
+        bool contient(uint16_t bas) const;
+        void versBitset();
+        void versTableau();
+        void normaliser();
+    };
+
+    static int premierBit(uint64_t mot);
+    static int compterBits(uint64_t mot);
+
+    std::vector<Conteneur>::iterator chercher(uint16_t cle);
+    std::vector<Conteneur>::const_iterator chercher(uint16_t cle) const;
+
+    static Conteneur intersection(const Conteneur& a, const Conteneur& b);
+    static Conteneur reunion(const Conteneur& a, const Conteneur& b);
+    static Conteneur difference(const Conteneur& a, const Conteneur& b);
+
+    std::vector<Conteneur> conteneurs; // triés par clé croissante
+};
+
+inline int BitmapCompresse::premierBit(uint64_t mot)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mot);
+#else
+    int bit = 0;
+    while (((mot >> bit) & 1ULL) == 0) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+inline int BitmapCompresse::compterBits(uint64_t mot)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(mot);
+#else
+    mot = mot - ((mot >> 1) & 0x5555555555555555ULL);
+    mot = (mot & 0x3333333333333333ULL) + ((mot >> 2) & 0x3333333333333333ULL);
+    mot = (mot + (mot >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((mot * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+template<typename Fonction>
+void BitmapCompresse::parcourir(Fonction fonction) const
+{
+    for (const Conteneur& c : conteneurs) {
+        const uint32_t haut = static_cast<uint32_t>(c.cle) << 16;
+        if (c.estBitset()) {
+            for (int mot = 0; mot < MOTS_BITSET; ++mot) {
+                uint64_t w = c.bits[mot];
+                while (w != 0) {
+                    const int bit = premierBit(w);
+                    fonction(haut | static_cast<uint32_t>(mot * 64 + bit));
+                    w &= w - 1; // effacer le bit de poids faible
+                }
+            }
+        } else {
+            for (uint16_t bas : c.tableau) {
+                fonction(haut | bas);
+            }
+        }
+    }
+}
+
+#endif // BITMAPCOMPRESSE_H
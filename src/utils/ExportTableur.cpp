@@ -0,0 +1,305 @@
+#include "ExportTableur.h"
+#include <QDate>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QRegularExpression>
+#include <QDebug>
+#include <array>
+
+namespace {
+
+// Entiers petit-boutistes du format ZIP
+void ecrire16(QByteArray& tampon, quint16 valeur)
+{
+    tampon.append(char(valeur & 0xFF));
+    tampon.append(char((valeur >> 8) & 0xFF));
+}
+
+void ecrire32(QByteArray& tampon, quint32 valeur)
+{
+    ecrire16(tampon, quint16(valeur & 0xFFFF));
+    ecrire16(tampon, quint16(valeur >> 16));
+}
+
+QString echapperXml(const QString& texte)
+{
+    return texte.toHtmlEscaped();
+}
+
+}
+
+bool ExportTableur::enregistrer(const QString& cheminFichier, const QString& titre,
+                                const QStringList& entetes, const QList<QVariantList>& lignes)
+{
+    if (QFileInfo(cheminFichier).suffix().compare("csv", Qt::CaseInsensitive) == 0) {
+        return enregistrerCSV(cheminFichier, entetes, lignes);
+    }
+    return enregistrerXLSX(cheminFichier, titre, entetes, lignes);
+}
+
+bool ExportTableur::enregistrerCSV(const QString& cheminFichier, const QStringList& entetes,
+                                   const QList<QVariantList>& lignes)
+{
+    auto champ = [](QString valeur) {
+        if (valeur.contains(';') || valeur.contains('"') || valeur.contains('\n') ||
+            valeur.contains('\r')) {
+            valeur.replace("\"", "\"\"");
+            return "\"" + valeur + "\"";
+        }
+        return valeur;
+    };
+
+    QByteArray contenu("\xEF\xBB\xBF"); // BOM : accents corrects sous Excel
+    QStringList champs;
+    for (const QString& entete : entetes) {
+        champs << champ(entete);
+    }
+    contenu += champs.join(';').toUtf8() + "\r\n";
+
+    for (const QVariantList& ligne : lignes) {
+        champs.clear();
+        for (const QVariant& valeur : ligne) {
+            champs << champ(texte(valeur));
+        }
+        contenu += champs.join(';').toUtf8() + "\r\n";
+    }
+
+    QSaveFile fichier(cheminFichier);
+    if (!fichier.open(QIODevice::WriteOnly)) {
+        qWarning() << "Impossible d'écrire" << cheminFichier << ":" << fichier.errorString();
+        return false;
+    }
+    fichier.write(contenu);
+    return fichier.commit();
+}
+
+bool ExportTableur::enregistrerXLSX(const QString& cheminFichier, const QString& titre,
+                                    const QStringList& entetes, const QList<QVariantList>& lignes)
+{
+    const QByteArray entete("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n");
+
+    const QByteArray types = entete +
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" "
+        "ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet1.xml\" "
+        "ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "</Types>";
+
+    const QByteArray relations = entete +
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" "
+        "Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" "
+        "Target=\"xl/workbook.xml\"/>"
+        "</Relationships>";
+
+    // Nom de feuille : 31 caractères au plus, sans caractères réservés
+    QString nomFeuille = titre;
+    nomFeuille.remove(QRegularExpression("[\\[\\]:*?/\\\\]"));
+    nomFeuille = nomFeuille.left(31);
+    if (nomFeuille.isEmpty()) {
+        nomFeuille = "Feuille1";
+    }
+
+    const QByteArray classeur = entete +
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheets><sheet name=\"" + echapperXml(nomFeuille).toUtf8() + "\" sheetId=\"1\" r:id=\"rId1\"/></sheets>"
+        "</workbook>";
+
+    const QByteArray relationsClasseur = entete +
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" "
+        "Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" "
+        "Target=\"worksheets/sheet1.xml\"/>"
+        "</Relationships>";
+
+    const QByteArray archive = archiveZip({
+        {"[Content_Types].xml", types},
+        {"_rels/.rels", relations},
+        {"xl/workbook.xml", classeur},
+        {"xl/_rels/workbook.xml.rels", relationsClasseur},
+        {"xl/worksheets/sheet1.xml", entete + feuille(entetes, lignes)}
+    });
+
+    QSaveFile fichier(cheminFichier);
+    if (!fichier.open(QIODevice::WriteOnly)) {
+        qWarning() << "Impossible d'écrire" << cheminFichier << ":" << fichier.errorString();
+        return false;
+    }
+    fichier.write(archive);
+    return fichier.commit();
+}
+
+QString ExportTableur::texte(const QVariant& valeur)
+{
+    if (valeur.isNull()) {
+        return QString();
+    }
+    switch (valeur.typeId()) {
+    case QMetaType::QDate:
+        return valeur.toDate().toString("dd/MM/yyyy");
+    case QMetaType::QDateTime:
+        return valeur.toDateTime().toString("dd/MM/yyyy HH:mm");
+    case QMetaType::Bool:
+        return valeur.toBool() ? "Oui" : "Non";
+    case QMetaType::Double:
+        return QString::number(valeur.toDouble(), 'f', 2);
+    default:
+        return valeur.toString();
+    }
+}
+
+bool ExportTableur::estNombre(const QVariant& valeur)
+{
+    switch (valeur.typeId()) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+        return !valeur.isNull();
+    default:
+        return false;
+    }
+}
+
+QString ExportTableur::colonne(int index)
+{
+    QString lettres;
+    for (int n = index + 1; n > 0; n = (n - 1) / 26) {
+        lettres.prepend(QChar('A' + (n - 1) % 26));
+    }
+    return lettres;
+}
+
+QByteArray ExportTableur::feuille(const QStringList& entetes, const QList<QVariantList>& lignes)
+{
+    QByteArray xml("<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>");
+
+    auto ecrireLigne = [&xml](int numero, const QVariantList& valeurs) {
+        xml += "<row r=\"" + QByteArray::number(numero) + "\">";
+        for (int i = 0; i < valeurs.size(); ++i) {
+            const QByteArray reference = (colonne(i) + QString::number(numero)).toLatin1();
+            const QVariant& valeur = valeurs[i];
+            if (valeur.isNull()) {
+                continue;
+            }
+            if (estNombre(valeur)) {
+                xml += "<c r=\"" + reference + "\"><v>" + valeur.toString().toLatin1() + "</v></c>";
+            } else {
+                // Chaînes en ligne : pas de table de chaînes partagées à maintenir
+                xml += "<c r=\"" + reference + "\" t=\"inlineStr\"><is><t xml:space=\"preserve\">"
+                     + echapperXml(texte(valeur)).toUtf8() + "</t></is></c>";
+            }
+        }
+        xml += "</row>";
+    };
+
+    QVariantList premiere;
+    for (const QString& entete : entetes) {
+        premiere << entete;
+    }
+    ecrireLigne(1, premiere);
+    for (int i = 0; i < lignes.size(); ++i) {
+        ecrireLigne(i + 2, lignes[i]);
+    }
+
+    xml += "</sheetData></worksheet>";
+    return xml;
+}
+
+QByteArray ExportTableur::archiveZip(const QList<QPair<QString, QByteArray>>& fichiers)
+{
+    // Entrées stockées sans compression (méthode 0), suffisant pour un classeur
+    const QDateTime maintenant = QDateTime::currentDateTime();
+    const QDate date = maintenant.date();
+    const QTime heure = maintenant.time();
+    const quint16 dateDos = quint16(((date.year() - 1980) << 9) | (date.month() << 5) | date.day());
+    const quint16 heureDos = quint16((heure.hour() << 11) | (heure.minute() << 5) | (heure.second() / 2));
+
+    QByteArray archive;
+    QByteArray repertoire;
+
+    for (const auto& fichier : fichiers) {
+        const QByteArray nom = fichier.first.toUtf8();
+        const QByteArray& donnees = fichier.second;
+        const quint32 crc = crc32(donnees);
+        const quint32 position = quint32(archive.size());
+
+        // En-tête local
+        ecrire32(archive, 0x04034b50);
+        ecrire16(archive, 20);          // version requise
+        ecrire16(archive, 0x0800);      // noms en UTF-8
+        ecrire16(archive, 0);           // stockage
+        ecrire16(archive, heureDos);
+        ecrire16(archive, dateDos);
+        ecrire32(archive, crc);
+        ecrire32(archive, quint32(donnees.size()));
+        ecrire32(archive, quint32(donnees.size()));
+        ecrire16(archive, quint16(nom.size()));
+        ecrire16(archive, 0);
+        archive += nom;
+        archive += donnees;
+
+        // Entrée du répertoire central
+        ecrire32(repertoire, 0x02014b50);
+        ecrire16(repertoire, 20);       // version créatrice
+        ecrire16(repertoire, 20);
+        ecrire16(repertoire, 0x0800);
+        ecrire16(repertoire, 0);
+        ecrire16(repertoire, heureDos);
+        ecrire16(repertoire, dateDos);
+        ecrire32(repertoire, crc);
+        ecrire32(repertoire, quint32(donnees.size()));
+        ecrire32(repertoire, quint32(donnees.size()));
+        ecrire16(repertoire, quint16(nom.size()));
+        ecrire16(repertoire, 0);        // extra
+        ecrire16(repertoire, 0);        // commentaire
+        ecrire16(repertoire, 0);        // disque
+        ecrire16(repertoire, 0);        // attributs internes
+        ecrire32(repertoire, 0);        // attributs externes
+        ecrire32(repertoire, position);
+        repertoire += nom;
+    }
+
+    const quint32 debutRepertoire = quint32(archive.size());
+    archive += repertoire;
+
+    // Fin du répertoire central
+    ecrire32(archive, 0x06054b50);
+    ecrire16(archive, 0);
+    ecrire16(archive, 0);
+    ecrire16(archive, quint16(fichiers.size()));
+    ecrire16(archive, quint16(fichiers.size()));
+    ecrire32(archive, quint32(repertoire.size()));
+    ecrire32(archive, debutRepertoire);
+    ecrire16(archive, 0);
+
+    return archive;
+}
+
+quint32 ExportTableur::crc32(const QByteArray& donnees)
+{
+    // Polynôme réfléchi 0xEDB88320 (CRC-32 IEEE du format ZIP)
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (const char octet : donnees) {
+        crc = table[(crc ^ quint8(octet)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,35 @@
+#ifndef EXPORTTABLEUR_H
+#define EXPORTTABLEUR_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+// Export d'un tableau (en-têtes + lignes) selon l'extension du fichier :
+// .csv (séparateur ';', UTF-8 avec BOM, ouvert tel quel par Excel) ou
+// classeur .xlsx minimal (une feuille, archive ZIP sans compression).
+// Nombres écrits comme valeurs numériques, dates au format jj/mm/aaaa.
+class ExportTableur
+{
+public:
+    static bool enregistrer(const QString& cheminFichier, const QString& titre,
+                            const QStringList& entetes, const QList<QVariantList>& lignes);
+
+private:
+    static bool enregistrerCSV(const QString& cheminFichier, const QStringList& entetes,
+                               const QList<QVariantList>& lignes);
+    static bool enregistrerXLSX(const QString& cheminFichier, const QString& titre,
+                                const QStringList& entetes, const QList<QVariantList>& lignes);
+
+    static QString texte(const QVariant& valeur);
+    static bool estNombre(const QVariant& valeur);
+    static QString colonne(int index); // 0 -> A, 26 -> AA
+    static QByteArray feuille(const QStringList& entetes, const QList<QVariantList>& lignes);
+    static QByteArray archiveZip(const QList<QPair<QString, QByteArray>>& fichiers);
+    static quint32 crc32(const QByteArray& donnees);
+};
+
+#endif // EXPORTTABLEUR_H
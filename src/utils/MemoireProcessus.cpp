@@ -0,0 +1,70 @@
+#include "MemoireProcessus.h"
+#include <QFile>
+#include <QByteArray>
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+#if defined(Q_OS_LINUX)
+// Champ « VmRSS: 12345 kB » de /proc/self/status
+qint64 champStatut(const QByteArray& nom)
+{
+    QFile statut("/proc/self/status");
+    if (!statut.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return 0;
+    }
+    for (const QByteArray& ligne : statut.readAll().split('\n')) {
+        if (ligne.startsWith(nom)) {
+            return ligne.mid(nom.size()).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+    return 0;
+}
+#endif
+
+}
+
+qint64 MemoireProcessus::residenteKo()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS compteurs;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &compteurs, sizeof(compteurs))) {
+        return qint64(compteurs.WorkingSetSize / 1024);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    return champStatut("VmRSS:");
+#else
+    return 0;
+#endif
+}
+
+qint64 MemoireProcessus::picKo()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS compteurs;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &compteurs, sizeof(compteurs))) {
+        return qint64(compteurs.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    return champStatut("VmHWM:");
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return qint64(usage.ru_maxrss / 1024);   // octets sous macOS
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,16 @@
+#ifndef MEMOIREPROCESSUS_H
+#define MEMOIREPROCESSUS_H
+
+#include <QtGlobal>
+
+// Mémoire résidente du processus courant, en kio (0 si la plateforme ne la
+// fournit pas) : /proc sous Linux, getrusage (pic seulement) sur les autres
+// Unix, GetProcessMemoryInfo sous Windows.
+class MemoireProcessus
+{
+public:
+    static qint64 residenteKo();
+    static qint64 picKo();
+};
+
+#endif // MEMOIREPROCESSUS_H
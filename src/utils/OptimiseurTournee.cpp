@@ -0,0 +1,160 @@
+#include "OptimiseurTournee.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+// Tolérance pour ignorer les gains dus aux arrondis
+const double EPSILON = 1e-9;
+}
+
+double OptimiseurTournee::longueur(const Matrice& distances, const std::vector<int>& ordre)
+{
+    double total = 0.0;
+    for (size_t k = 1; k < ordre.size(); ++k) {
+        total += distances[ordre[k - 1]][ordre[k]];
+    }
+    return total;
+}
+
+std::vector<int> OptimiseurTournee::optimiser(const Matrice& distances, int budgetMs)
+{
+    if (distances.size() <= 2) {
+        std::vector<int> ordre;
+        for (int k = 0; k < static_cast<int>(distances.size()); ++k) {
+            ordre.push_back(k);
+        }
+        return ordre;
+    }
+
+    const auto echeance = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+
+    std::vector<int> ordre = plusProcheVoisin(distances);
+
+    // Alterner les deux voisinages tant qu'ils améliorent la tournée
+    bool ameliore = true;
+    while (ameliore && std::chrono::steady_clock::now() < echeance) {
+        ameliore = ameliorer2Opt(distances, ordre);
+        ameliore = ameliorerOrOpt(distances, ordre) || ameliore;
+    }
+
+    return ordre;
+}
+
+std::vector<int> OptimiseurTournee::plusProcheVoisin(const Matrice& distances)
+{
+    const int n = static_cast<int>(distances.size());
+    std::vector<bool> visite(n, false);
+    std::vector<int> ordre;
+    ordre.reserve(n);
+
+    int courant = 0;
+    visite[0] = true;
+    ordre.push_back(0);
+
+    for (int etape = 1; etape < n; ++etape) {
+        int suivant = -1;
+        double meilleure = std::numeric_limits<double>::max();
+        for (int v = 0; v < n; ++v) {
+            if (!visite[v] && distances[courant][v] < meilleure) {
+                meilleure = distances[courant][v];
+                suivant = v;
+            }
+        }
+        visite[suivant] = true;
+        ordre.push_back(suivant);
+        courant = suivant;
+    }
+
+    return ordre;
+}
+
+bool OptimiseurTournee::ameliorer2Opt(const Matrice& d, std::vector<int>& ordre)
+{
+    // Inversion du segment [i, j] ; le départ (position 0) reste fixe et
+    // la tournée étant ouverte, le dernier point n'a pas de successeur
+    const int n = static_cast<int>(ordre.size());
+    bool ameliore = false;
+
+    for (int i = 1; i < n - 1; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            const int a = ordre[i - 1];
+            const int b = ordre[i];
+            const int c = ordre[j];
+            double gain = d[a][b] - d[a][c];
+            if (j + 1 < n) {
+                const int e = ordre[j + 1];
+                gain += d[c][e] - d[b][e];
+            }
+            if (gain > EPSILON) {
+                std::reverse(ordre.begin() + i, ordre.begin() + j + 1);
+                ameliore = true;
+            }
+        }
+    }
+
+    return ameliore;
+}
+
+bool OptimiseurTournee::ameliorerOrOpt(const Matrice& d, std::vector<int>& ordre)
+{
+    // Déplacement d'un segment de 1 à 3 points (éventuellement inversé)
+    const int n = static_cast<int>(ordre.size());
+    bool ameliore = false;
+
+    for (int taille = 1; taille <= 3; ++taille) {
+        for (int i = 1; i + taille <= n; ++i) {
+            const int fin = i + taille - 1;
+            const int avant = ordre[i - 1];
+            const int premier = ordre[i];
+            const int dernier = ordre[fin];
+
+            // Gain du retrait du segment
+            double retrait = d[avant][premier];
+            if (fin + 1 < n) {
+                const int apres = ordre[fin + 1];
+                retrait += d[dernier][apres] - d[avant][apres];
+            }
+
+            // Meilleure position d'insertion : entre ordre[p] et ordre[p + 1]
+            double meilleurGain = EPSILON;
+            int meilleurePosition = -1;
+            bool inverser = false;
+            for (int p = 0; p < n; ++p) {
+                if (p >= i - 1 && p <= fin) continue; // position inchangée ou interne
+                const int x = ordre[p];
+                const bool dernierePosition = (p + 1 >= n);
+                const int y = dernierePosition ? -1 : ordre[p + 1];
+
+                for (int sens = 0; sens < 2; ++sens) {
+                    const int entree = sens == 0 ? premier : dernier;
+                    const int sortie = sens == 0 ? dernier : premier;
+                    double insertion = d[x][entree];
+                    if (!dernierePosition) {
+                        insertion += d[sortie][y] - d[x][y];
+                    }
+                    const double gain = retrait - insertion;
+                    if (gain > meilleurGain) {
+                        meilleurGain = gain;
+                        meilleurePosition = p;
+                        inverser = (sens == 1);
+                    }
+                }
+            }
+
+            if (meilleurePosition < 0) continue;
+
+            std::vector<int> segment(ordre.begin() + i, ordre.begin() + fin + 1);
+            if (inverser) {
+                std::reverse(segment.begin(), segment.end());
+            }
+            ordre.erase(ordre.begin() + i, ordre.begin() + fin + 1);
+            const int cible = meilleurePosition < i ? meilleurePosition + 1
+                                                    : meilleurePosition + 1 - taille;
+            ordre.insert(ordre.begin() + cible, segment.begin(), segment.end());
+            ameliore = true;
+        }
+    }
+
+    return ameliore;
+}
@@ -0,0 +1,26 @@
+#ifndef OPTIMISEURTOURNEE_H
+#define OPTIMISEURTOURNEE_H
+
+#include <vector>
+
+// Ordre de visite quasi optimal d'une tournée ouverte (sans retour) partant
+// du point 0 : plus proche voisin, puis recherche locale 2-opt et Or-opt
+// jusqu'à stabilisation ou épuisement du budget de temps.
+class OptimiseurTournee
+{
+public:
+    using Matrice = std::vector<std::vector<double>>;
+
+    // distances : matrice carrée symétrique, indice 0 = point de départ
+    // Renvoie l'ordre de visite, commençant toujours par 0
+    static std::vector<int> optimiser(const Matrice& distances, int budgetMs = 50);
+
+    static double longueur(const Matrice& distances, const std::vector<int>& ordre);
+
+private:
+    static std::vector<int> plusProcheVoisin(const Matrice& distances);
+    static bool ameliorer2Opt(const Matrice& distances, std::vector<int>& ordre);
+    static bool ameliorerOrOpt(const Matrice& distances, std::vector<int>& ordre);
+};
+
+#endif // OPTIMISEURTOURNEE_H
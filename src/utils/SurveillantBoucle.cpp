@@ -0,0 +1,254 @@
+#include "SurveillantBoucle.h"
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+
+#if defined(Q_OS_UNIX) && __has_include(<execinfo.h>)
+#define PILE_APPELS_DISPONIBLE
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <cerrno>
+#include <cstdlib>
+#endif
+
+SurveillantBoucle* SurveillantBoucle::instance = nullptr;
+
+#ifdef PILE_APPELS_DISPONIBLE
+namespace {
+
+constexpr int ADRESSES_MAX = 64;
+void* adresses[ADRESSES_MAX];
+std::atomic<int> nombreAdresses(0);
+pthread_t filPrincipal;
+
+// Exécuté sur le fil principal, interrompu au milieu de son blocage
+void capturerAdresses(int)
+{
+    const int erreur = errno;
+    nombreAdresses.store(backtrace(adresses, ADRESSES_MAX), std::memory_order_release);
+    errno = erreur;
+}
+
+}
+#endif
+
+SurveillantBoucle::SurveillantBoucle()
+    : dernierBattementNs(0)
+    , pilePrincipale(nullptr)
+    , arret(false)
+    , blocageEnCours(false)
+    , battementAvantBlocageNs(0)
+    , detectes(0)
+{
+    QSettings settings;
+    settings.beginGroup("SurveillanceBoucle");
+    active = settings.value("active", true).toBool();
+    seuil = std::max(INTERVALLE_BATTEMENT_MS, settings.value("seuilMs", 500).toInt());
+    pileAppels = settings.value("pileAppels", true).toBool();
+    settings.endGroup();
+
+    const QString repertoire = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (!repertoire.isEmpty() && QDir().mkpath(repertoire)) {
+        journal = repertoire + "/blocages.log";
+    }
+
+    minuteurBattement.setTimerType(Qt::PreciseTimer);
+    minuteurBattement.setInterval(INTERVALLE_BATTEMENT_MS);
+    QObject::connect(&minuteurBattement, &QTimer::timeout, [this] {
+        dernierBattementNs.store(horloge.nsecsElapsed(), std::memory_order_release);
+    });
+}
+
+SurveillantBoucle* SurveillantBoucle::getInstance()
+{
+    if (instance == nullptr) {
+        instance = new SurveillantBoucle();
+    }
+    return instance;
+}
+
+void SurveillantBoucle::demarrer()
+{
+    if (!active || isRunning()) {
+        return;
+    }
+
+    // Portées du fil principal lisibles depuis le fil de surveillance
+    Trace::suivrePiles(true);
+    pilePrincipale = Trace::pileFilCourant();
+
+#ifdef PILE_APPELS_DISPONIBLE
+    if (pileAppels) {
+        filPrincipal = pthread_self();
+
+        struct sigaction action = {};
+        action.sa_handler = capturerAdresses;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGUSR2, &action, nullptr);
+
+        // Premier appel hors signal : backtrace charge sa bibliothèque d'unwinding
+        void* amorce[1];
+        backtrace(amorce, 1);
+    }
+#endif
+
+    horloge.start();
+    dernierBattementNs.store(0, std::memory_order_release);
+    minuteurBattement.start();
+
+    arret = false;
+    blocageEnCours = false;
+    start(QThread::LowPriority);
+}
+
+void SurveillantBoucle::arreter()
+{
+    if (!isRunning()) {
+        return;
+    }
+    {
+        QMutexLocker verrouillage(&verrou);
+        arret = true;
+        reveil.wakeAll();
+    }
+    wait();
+    minuteurBattement.stop();
+    Trace::suivrePiles(false);
+}
+
+QList<BlocageBoucle> SurveillantBoucle::derniersBlocages(int n) const
+{
+    QMutexLocker verrouillage(&verrou);
+    return blocages.mid(std::max(0, int(blocages.size()) - n));
+}
+
+void SurveillantBoucle::run()
+{
+    QMutexLocker verrouillage(&verrou);
+    while (!arret) {
+        reveil.wait(&verrou, INTERVALLE_VERIFICATION_MS);
+        if (arret) {
+            break;
+        }
+        verrouillage.unlock();
+        verifier();
+        verrouillage.relock();
+    }
+}
+
+void SurveillantBoucle::verifier()
+{
+    const qint64 battementNs = dernierBattementNs.load(std::memory_order_acquire);
+    // Temps sans battement au-delà de l'intervalle normal du minuteur
+    const qint64 ecartMs = (horloge.nsecsElapsed() - battementNs) / 1000000 - INTERVALLE_BATTEMENT_MS;
+
+    if (!blocageEnCours) {
+        if (ecartMs < seuil) {
+            return;
+        }
+
+        // Relevé pendant le blocage, écrit tout de suite : un gel définitif
+        // laisse ainsi une trace
+        blocageEnCours = true;
+        battementAvantBlocageNs = battementNs;
+        blocageCourant = BlocageBoucle();
+        blocageCourant.debut = QDateTime::currentDateTime().addMSecs(-ecartMs);
+        blocageCourant.portees = Trace::lirePile(pilePrincipale);
+        blocageCourant.pileAppels = capturerPileAppels();
+        detectes.fetch_add(1, std::memory_order_relaxed);
+
+        QString texte = QString("[%1] Boucle d'événements bloquée depuis %2 ms\n")
+                        .arg(blocageCourant.debut.toString(Qt::ISODateWithMs)).arg(ecartMs);
+        texte += "  portées : " + (blocageCourant.portees.isEmpty()
+                                   ? QString("(aucune portée tracée ouverte)")
+                                   : blocageCourant.portees.join(" > ")) + "\n";
+        for (const QString& cadre : blocageCourant.pileAppels) {
+            texte += "    " + cadre + "\n";
+        }
+        ecrireJournal(texte);
+        qWarning() << "Boucle d'événements bloquée depuis" << ecartMs << "ms dans"
+                   << blocageCourant.portees.join(" > ");
+        return;
+    }
+
+    if (battementNs == battementAvantBlocageNs) {
+        return;
+    }
+
+    // Reprise : durée entre les deux battements qui encadrent le blocage
+    blocageEnCours = false;
+    blocageCourant.dureeMs = std::max<qint64>(
+        seuil, (battementNs - battementAvantBlocageNs) / 1000000 - INTERVALLE_BATTEMENT_MS);
+    ecrireJournal(QString("[%1] Fin du blocage : %2 ms\n")
+                  .arg(QDateTime::currentDateTime().toString(Qt::ISODateWithMs))
+                  .arg(blocageCourant.dureeMs));
+
+    QMutexLocker verrouillage(&verrou);
+    blocages.append(blocageCourant);
+    if (blocages.size() > BLOCAGES_CONSERVES) {
+        blocages.removeFirst();
+    }
+}
+
+QStringList SurveillantBoucle::capturerPileAppels()
+{
+    QStringList cadres;
+#ifdef PILE_APPELS_DISPONIBLE
+    if (!pileAppels) {
+        return cadres;
+    }
+
+    nombreAdresses.store(-1, std::memory_order_release);
+    if (pthread_kill(filPrincipal, SIGUSR2) != 0) {
+        return cadres;
+    }
+
+    QElapsedTimer attente;
+    attente.start();
+    int nombre = -1;
+    while ((nombre = nombreAdresses.load(std::memory_order_acquire)) < 0) {
+        if (attente.elapsed() > ATTENTE_PILE_MS) {
+            cadres << "(pile d'appels non capturée)";
+            return cadres;
+        }
+        QThread::msleep(1);
+    }
+
+    // Symboles résolus ici, hors du gestionnaire de signal ; les deux
+    // premiers cadres sont le gestionnaire et le trampoline du noyau
+    char** symboles = backtrace_symbols(adresses, nombre);
+    if (symboles != nullptr) {
+        for (int i = 2; i < nombre; ++i) {
+            cadres << QString::fromLocal8Bit(symboles[i]);
+        }
+        std::free(symboles);
+    }
+#endif
+    return cadres;
+}
+
+void SurveillantBoucle::ecrireJournal(const QString& texte)
+{
+    if (journal.isEmpty()) {
+        return;
+    }
+
+    // Une seule archive : blocages.log -> blocages.log.1
+    if (QFile(journal).size() >= TAILLE_MAX_JOURNAL) {
+        QFile::remove(journal + ".1");
+        QFile::rename(journal, journal + ".1");
+    }
+
+    QFile fichier(journal);
+    if (fichier.open(QIODevice::Append | QIODevice::Text)) {
+        QTextStream(&fichier) << texte;
+    }
+}
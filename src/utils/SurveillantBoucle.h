@@ -0,0 +1,89 @@
+#ifndef SURVEILLANTBOUCLE_H
+#define SURVEILLANTBOUCLE_H
+
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QDateTime>
+#include <QStringList>
+#include <QList>
+#include <atomic>
+
+struct PileTrace;
+
+// Blocage de la boucle d'événements du fil principal
+struct BlocageBoucle
+{
+    QDateTime debut;
+    qint64 dureeMs = 0;          // durée totale, connue à la reprise (0 : en cours)
+    QStringList portees;         // portées tracées ouvertes lors de la capture
+    QStringList pileAppels;      // pile d'appels du fil principal (Unix seulement)
+};
+
+// Chien de garde de la boucle d'événements : un minuteur du fil principal
+// bat à intervalle fixe, un fil de surveillance vérifie les battements.
+// Au-delà du seuil sans battement, il relève les portées tracées ouvertes
+// sur le fil principal (Trace) et, sous Unix, sa pile d'appels (signal
+// SIGUSR2 puis backtrace), et les écrit dans blocages.log avec la durée du
+// blocage une fois la boucle repartie. Réglages dans les paramètres de
+// l'application (groupe « SurveillanceBoucle »).
+class SurveillantBoucle : public QThread
+{
+private:
+    static SurveillantBoucle* instance;
+
+    SurveillantBoucle();
+
+public:
+    static SurveillantBoucle* getInstance();
+
+    // Depuis le fil principal ; sans effet si la surveillance est désactivée
+    void demarrer();
+    void arreter();
+
+    bool estActive() const { return active; }
+    int seuilMs() const { return seuil; }
+    qint64 blocagesDetectes() const { return detectes.load(std::memory_order_relaxed); }
+    // Derniers blocages terminés, du plus ancien au plus récent
+    QList<BlocageBoucle> derniersBlocages(int n) const;
+    QString cheminJournal() const { return journal; }
+
+protected:
+    void run() override;
+
+private:
+    void verifier();
+    QStringList capturerPileAppels();
+    void ecrireJournal(const QString& texte);
+
+    bool active;
+    int seuil;
+    bool pileAppels;
+    QString journal;
+
+    // Battements : horodatage (ns depuis horloge) du dernier réveil du minuteur
+    QTimer minuteurBattement;
+    QElapsedTimer horloge;
+    std::atomic<qint64> dernierBattementNs;
+    const PileTrace* pilePrincipale;
+
+    // Fil de surveillance
+    mutable QMutex verrou;
+    QWaitCondition reveil;
+    bool arret;
+    bool blocageEnCours;
+    qint64 battementAvantBlocageNs;
+    BlocageBoucle blocageCourant;
+    QList<BlocageBoucle> blocages;
+    std::atomic<qint64> detectes;
+
+    static constexpr int INTERVALLE_BATTEMENT_MS = 100;
+    static constexpr int INTERVALLE_VERIFICATION_MS = 50;
+    static constexpr int ATTENTE_PILE_MS = 200;
+    static constexpr int BLOCAGES_CONSERVES = 20;
+    static constexpr qint64 TAILLE_MAX_JOURNAL = 1024 * 1024;
+};
+
+#endif // SURVEILLANTBOUCLE_H
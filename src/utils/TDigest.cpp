@@ -0,0 +1,144 @@
+#include "TDigest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const double PI = 3.14159265358979323846;
+}
+
+TDigest::TDigest(double compression)
+    : compression(std::max(10.0, compression))
+    , somme(0.0)
+    , poidsTotal(0.0)
+    , min(std::numeric_limits<double>::infinity())
+    , max(-std::numeric_limits<double>::infinity())
+{
+}
+
+void TDigest::ajouter(double valeur, double poids)
+{
+    if (poids <= 0.0 || std::isnan(valeur)) return;
+
+    tampon.push_back({valeur, poids});
+    somme += valeur * poids;
+    poidsTotal += poids;
+    min = std::min(min, valeur);
+    max = std::max(max, valeur);
+
+    if (tampon.size() >= static_cast<size_t>(compression) * 5) {
+        compresser();
+    }
+}
+
+void TDigest::fusionner(const TDigest& autre)
+{
+    autre.compresser();
+    for (const Centroide& c : autre.centroides) {
+        tampon.push_back(c);
+    }
+    somme += autre.somme;
+    poidsTotal += autre.poidsTotal;
+    min = std::min(min, autre.min);
+    max = std::max(max, autre.max);
+    compresser();
+}
+
+void TDigest::vider()
+{
+    centroides.clear();
+    tampon.clear();
+    somme = 0.0;
+    poidsTotal = 0.0;
+    min = std::numeric_limits<double>::infinity();
+    max = -std::numeric_limits<double>::infinity();
+}
+
+double TDigest::limiteQuantile(double q) const
+{
+    // Fonction d'échelle k1 : k(q) = δ/2π · asin(2q − 1). Un centroïde couvre
+    // au plus une unité de k, d'où des centroïdes petits près de 0 et de 1.
+    const double k = compression / (2.0 * PI) * std::asin(2.0 * q - 1.0) + 1.0;
+    if (k >= compression / 4.0) {
+        return 1.0;
+    }
+    return (std::sin(k * 2.0 * PI / compression) + 1.0) / 2.0;
+}
+
+void TDigest::compresser() const
+{
+    if (tampon.empty()) return;
+
+    std::vector<Centroide> tous;
+    tous.reserve(centroides.size() + tampon.size());
+    tous.insert(tous.end(), centroides.begin(), centroides.end());
+    tous.insert(tous.end(), tampon.begin(), tampon.end());
+    tampon.clear();
+
+    std::sort(tous.begin(), tous.end(), [](const Centroide& a, const Centroide& b) {
+        return a.moyenne < b.moyenne;
+    });
+
+    double total = 0.0;
+    for (const Centroide& c : tous) total += c.poids;
+
+    centroides.clear();
+    Centroide courant = tous.front();
+    double poidsAvant = 0.0;
+    double limite = limiteQuantile(0.0);
+
+    for (size_t i = 1; i < tous.size(); ++i) {
+        const Centroide& suivant = tous[i];
+        const double q = (poidsAvant + courant.poids + suivant.poids) / total;
+        if (q <= limite) {
+            courant.poids += suivant.poids;
+            courant.moyenne += (suivant.moyenne - courant.moyenne) * suivant.poids / courant.poids;
+        } else {
+            centroides.push_back(courant);
+            poidsAvant += courant.poids;
+            limite = limiteQuantile(poidsAvant / total);
+            courant = suivant;
+        }
+    }
+    centroides.push_back(courant);
+}
+
+double TDigest::moyenne() const
+{
+    return poidsTotal > 0.0 ? somme / poidsTotal : 0.0;
+}
+
+double TDigest::quantile(double q) const
+{
+    if (estVide()) return 0.0;
+    compresser();
+
+    q = std::clamp(q, 0.0, 1.0);
+    if (centroides.size() == 1) {
+        return centroides.front().moyenne;
+    }
+
+    // Interpolation linéaire entre les centres des centroïdes ; les bornes
+    // exactes min et max encadrent le premier et le dernier demi-centroïde
+    const double cible = q * poidsTotal;
+    const Centroide& premier = centroides.front();
+    if (cible < premier.poids / 2.0) {
+        return min + (premier.moyenne - min) * cible / (premier.poids / 2.0);
+    }
+
+    double cumul = premier.poids / 2.0;
+    for (size_t i = 0; i + 1 < centroides.size(); ++i) {
+        const Centroide& a = centroides[i];
+        const Centroide& b = centroides[i + 1];
+        const double pas = (a.poids + b.poids) / 2.0;
+        if (cible < cumul + pas) {
+            return a.moyenne + (b.moyenne - a.moyenne) * (cible - cumul) / pas;
+        }
+        cumul += pas;
+    }
+
+    const Centroide& dernier = centroides.back();
+    const double reste = poidsTotal - cumul;
+    if (reste <= 0.0) return max;
+    return dernier.moyenne + (max - dernier.moyenne) * std::min(1.0, (cible - cumul) / reste);
+}
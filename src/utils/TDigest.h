@@ -0,0 +1,46 @@
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <vector>
+
+// Résumé compact d'une distribution (t-digest à fusion) : moyenne exacte et
+// quantiles approchés, très précis aux extrémités (p90, p99). La mémoire
+// reste bornée par la compression, quel que soit le nombre de valeurs.
+class TDigest
+{
+public:
+    explicit TDigest(double compression = 100.0);
+
+    void ajouter(double valeur, double poids = 1.0);
+    void fusionner(const TDigest& autre);
+    void vider();
+
+    // q dans [0, 1]
+    double quantile(double q) const;
+    double moyenne() const;
+    double nombre() const { return poidsTotal; }
+    double minimum() const { return min; }
+    double maximum() const { return max; }
+    bool estVide() const { return poidsTotal <= 0.0; }
+
+private:
+    struct Centroide {
+        double moyenne;
+        double poids;
+    };
+
+    // Fusion du tampon dans les centroïdes, bornée par la fonction d'échelle
+    void compresser() const;
+    double limiteQuantile(double q) const;
+
+    double compression;
+    mutable std::vector<Centroide> centroides;
+    mutable std::vector<Centroide> tampon;
+
+    double somme;
+    double poidsTotal;
+    double min;
+    double max;
+};
+
+#endif // TDIGEST_H
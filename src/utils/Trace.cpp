@@ -0,0 +1,233 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+#include <vector>
+
+std::atomic<int> Trace::modes(0);
+
+// Portées ouvertes d'un fil : écrite par ce fil seul, lue par les autres.
+// Au-delà de PROFONDEUR_MAX, la taille reste juste mais les noms sont perdus.
+struct PileTrace
+{
+    static constexpr int PROFONDEUR_MAX = 32;
+    std::atomic<int> taille{0};
+    std::atomic<const char*> noms[PROFONDEUR_MAX] = {};
+};
+
+namespace {
+
+struct EvenementTrace
+{
+    const char* nom;
+    const char* categorie;
+    qint64 debutNs;
+    qint64 dureeNs;
+    int fil;
+    int profondeur;
+    QString detail;
+};
+
+// Au-delà, les événements sont comptés mais plus conservés
+constexpr size_t EVENEMENTS_MAX = 2000000;
+
+QElapsedTimer horloge;
+QMutex verrou;
+std::vector<EvenementTrace> evenements;
+QHash<int, QString> nomsFils;
+qint64 evenementsPerdus = 0;
+
+std::atomic<int> prochainFil(1);
+thread_local int filCourant = 0;
+thread_local int profondeurCourante = 0;
+thread_local PileTrace pileCourante;
+
+// Identifiant court et stable du fil courant (les identifiants système
+// sont illisibles dans la visionneuse)
+int identifiantFil()
+{
+    if (filCourant == 0) {
+        filCourant = prochainFil.fetch_add(1);
+        const bool principal = QCoreApplication::instance() &&
+                               QThread::currentThread() == QCoreApplication::instance()->thread();
+        QMutexLocker verrouillage(&verrou);
+        nomsFils.insert(filCourant, principal ? QString("principal") : QString("fil %1").arg(filCourant));
+    }
+    return filCourant;
+}
+
+QString echapper(const QString& texte)
+{
+    QString resultat;
+    resultat.reserve(texte.size() + 8);
+    for (const QChar c : texte) {
+        switch (c.unicode()) {
+        case '"': resultat += "\\\""; break;
+        case '\\': resultat += "\\\\"; break;
+        case '\n': resultat += "\\n"; break;
+        case '\r': resultat += "\\r"; break;
+        case '\t': resultat += "\\t"; break;
+        default:
+            if (c.unicode() < 0x20) {
+                resultat += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+            } else {
+                resultat += c;
+            }
+        }
+    }
+    return resultat;
+}
+
+}
+
+void PorteeTrace::ouvrir()
+{
+    if (modes & Trace::SuiviPiles) {
+        const int taille = pileCourante.taille.load(std::memory_order_relaxed);
+        if (taille < PileTrace::PROFONDEUR_MAX) {
+            pileCourante.noms[taille].store(nom, std::memory_order_relaxed);
+        }
+        pileCourante.taille.store(taille + 1, std::memory_order_release);
+    }
+    if (modes & Trace::Enregistrement) {
+        ++profondeurCourante;
+        debutNs = Trace::maintenantNs();
+    }
+}
+
+void PorteeTrace::fermer()
+{
+    if (modes & Trace::Enregistrement) {
+        --profondeurCourante;
+        Trace::enregistrer(nom, categorie, debutNs, Trace::maintenantNs(), profondeurCourante, detail);
+    }
+    if (modes & Trace::SuiviPiles) {
+        pileCourante.taille.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+qint64 Trace::maintenantNs()
+{
+    return horloge.nsecsElapsed();
+}
+
+void Trace::demarrer()
+{
+    {
+        QMutexLocker verrouillage(&verrou);
+        evenements.clear();
+        evenementsPerdus = 0;
+        horloge.start();
+    }
+    modes.fetch_or(Enregistrement, std::memory_order_relaxed);
+}
+
+void Trace::nommerFil(const QString& nom)
+{
+    const int fil = identifiantFil();
+    QMutexLocker verrouillage(&verrou);
+    nomsFils.insert(fil, nom);
+}
+
+void Trace::suivrePiles(bool actif)
+{
+    if (actif) {
+        modes.fetch_or(SuiviPiles, std::memory_order_relaxed);
+    } else {
+        modes.fetch_and(~SuiviPiles, std::memory_order_relaxed);
+    }
+}
+
+const PileTrace* Trace::pileFilCourant()
+{
+    return &pileCourante;
+}
+
+QStringList Trace::lirePile(const PileTrace* pile)
+{
+    // Lecture sans verrou pendant que le fil continue : un instantané
+    // cohérent à une portée près, suffisant pour localiser un blocage
+    QStringList noms;
+    if (pile == nullptr) {
+        return noms;
+    }
+    const int taille = std::min(pile->taille.load(std::memory_order_acquire), PileTrace::PROFONDEUR_MAX);
+    for (int i = 0; i < taille; ++i) {
+        const char* nom = pile->noms[i].load(std::memory_order_relaxed);
+        noms << (nom ? QString::fromUtf8(nom) : QString("?"));
+    }
+    return noms;
+}
+
+void Trace::enregistrer(const char* nom, const char* categorie, qint64 debutNs,
+                        qint64 finNs, int profondeur, const QString& detail)
+{
+    if (!estActive()) {
+        return;
+    }
+    const int fil = identifiantFil();
+
+    QMutexLocker verrouillage(&verrou);
+    if (evenements.size() >= EVENEMENTS_MAX) {
+        ++evenementsPerdus;
+        return;
+    }
+    evenements.push_back({nom, categorie, debutNs, finNs - debutNs, fil, profondeur, detail});
+}
+
+bool Trace::arreter(const QString& cheminFichier)
+{
+    modes.fetch_and(~Enregistrement, std::memory_order_relaxed);
+
+    QMutexLocker verrouillage(&verrou);
+    if (cheminFichier.isEmpty()) {
+        evenements.clear();
+        return true;
+    }
+
+    QFile fichier(cheminFichier);
+    if (!fichier.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Impossible d'écrire la trace:" << cheminFichier;
+        return false;
+    }
+
+    const qint64 processus = QCoreApplication::applicationPid();
+    QTextStream flux(&fichier);
+    flux << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    // Noms des fils (métadonnées), puis un événement complet par portée
+    bool premier = true;
+    for (auto it = nomsFils.constBegin(); it != nomsFils.constEnd(); ++it) {
+        flux << (premier ? "" : ",\n")
+             << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << processus
+             << ",\"tid\":" << it.key() << ",\"args\":{\"name\":\"" << echapper(it.value()) << "\"}}";
+        premier = false;
+    }
+
+    for (const EvenementTrace& evenement : evenements) {
+        flux << (premier ? "" : ",\n")
+             << "{\"ph\":\"X\",\"name\":\"" << echapper(QString::fromUtf8(evenement.nom))
+             << "\",\"cat\":\"" << evenement.categorie
+             << "\",\"pid\":" << processus << ",\"tid\":" << evenement.fil
+             << ",\"ts\":" << QString::number(evenement.debutNs / 1000.0, 'f', 3)
+             << ",\"dur\":" << QString::number(evenement.dureeNs / 1000.0, 'f', 3)
+             << ",\"args\":{\"profondeur\":" << evenement.profondeur;
+        if (!evenement.detail.isEmpty()) {
+            flux << ",\"detail\":\"" << echapper(evenement.detail) << "\"";
+        }
+        flux << "}}";
+        premier = false;
+    }
+    flux << "\n]}\n";
+
+    qDebug() << "Trace écrite:" << cheminFichier << evenements.size() << "événements,"
+             << evenementsPerdus << "perdus";
+    evenements.clear();
+    return true;
+}
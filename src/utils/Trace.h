@@ -0,0 +1,101 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QStringList>
+#include <atomic>
+
+struct PileTrace;
+
+// Enregistrement de traces d'exécution au format Chrome (« trace event »),
+// lisible dans chrome://tracing ou ui.perfetto.dev : chaque portée est un
+// événement complet (début, durée, fil). Les portées d'un même fil
+// s'emboîtent d'après leurs dates.
+//
+// Indépendamment de l'enregistrement, le suivi des piles tient à jour les
+// noms des portées ouvertes de chaque fil, lisibles depuis un autre fil
+// (surveillance des blocages de la boucle d'événements).
+//
+// Enregistrement et suivi désactivés, une portée coûte la lecture d'un
+// entier atomique : ni horloge, ni allocation, ni verrou.
+class Trace
+{
+public:
+    static bool estActive() { return modes.load(std::memory_order_relaxed) & Enregistrement; }
+
+    // Vide les événements précédents et démarre l'enregistrement
+    static void demarrer();
+    // Arrête l'enregistrement et écrit le fichier JSON (rien si chemin vide)
+    static bool arreter(const QString& cheminFichier);
+
+    // Nom du fil courant dans la trace (« principal » pour le fil de l'application)
+    static void nommerFil(const QString& nom);
+
+    // Suivi des portées ouvertes (pris en compte par les portées ouvertes ensuite)
+    static void suivrePiles(bool actif);
+    // Pile du fil appelant, à lire ensuite depuis n'importe quel fil
+    static const PileTrace* pileFilCourant();
+    // Noms des portées ouvertes, de la plus externe à la plus interne
+    static QStringList lirePile(const PileTrace* pile);
+
+private:
+    friend class PorteeTrace;
+
+    enum Mode { Enregistrement = 1, SuiviPiles = 2 };
+
+    static qint64 maintenantNs();
+    static void enregistrer(const char* nom, const char* categorie, qint64 debutNs,
+                            qint64 finNs, int profondeur, const QString& detail);
+
+    static std::atomic<int> modes;
+};
+
+// Portée tracée : du constructeur au destructeur. nom et categorie sont des
+// littéraux (conservés tels quels) ; detail (texte SQL, chemin...) n'est
+// copié que si la trace est active.
+class PorteeTrace
+{
+public:
+    explicit PorteeTrace(const char* nom, const char* categorie = "app")
+        : nom(nom), categorie(categorie), modes(Trace::modes.load(std::memory_order_relaxed)), debutNs(-1)
+    {
+        if (modes) {
+            ouvrir();
+        }
+    }
+
+    PorteeTrace(const char* nom, const char* categorie, const QString& texte)
+        : nom(nom), categorie(categorie), modes(Trace::modes.load(std::memory_order_relaxed)), debutNs(-1)
+    {
+        if (modes) {
+            ouvrir();
+            if (debutNs >= 0) {
+                detail = texte;
+            }
+        }
+    }
+
+    // Fermée selon les modes lus à l'ouverture : pile équilibrée même si
+    // l'enregistrement ou le suivi change entre-temps
+    ~PorteeTrace()
+    {
+        if (modes) {
+            fermer();
+        }
+    }
+
+    PorteeTrace(const PorteeTrace&) = delete;
+    PorteeTrace& operator=(const PorteeTrace&) = delete;
+
+private:
+    void ouvrir();
+    void fermer();
+
+    const char* nom;
+    const char* categorie;
+    int modes;
+    qint64 debutNs;
+    QString detail;
+};
+
+#endif // TRACE_H